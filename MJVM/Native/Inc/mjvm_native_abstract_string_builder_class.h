@@ -0,0 +1,9 @@
+
+#ifndef __MJVM_NATIVE_ABSTRACT_STRING_BUILDER_CLASS_H
+#define __MJVM_NATIVE_ABSTRACT_STRING_BUILDER_CLASS_H
+
+#include "mjvm_native_class.h"
+
+extern const NativeClass ABSTRACT_STRING_BUILDER_CLASS;
+
+#endif /* __MJVM_NATIVE_ABSTRACT_STRING_BUILDER_CLASS_H */
@@ -0,0 +1,9 @@
+
+#ifndef __MJVM_NATIVE_ATOMIC_REFERENCE_CLASS_H
+#define __MJVM_NATIVE_ATOMIC_REFERENCE_CLASS_H
+
+#include "mjvm_native_class.h"
+
+extern const NativeClass ATOMIC_REFERENCE_CLASS;
+
+#endif /* __MJVM_NATIVE_ATOMIC_REFERENCE_CLASS_H */
@@ -6,4 +6,7 @@
 
 extern const NativeClass CHARACTER_CLASS;
 
+uint16_t Character_ToLower(uint16_t c);
+uint16_t Character_ToUpper(uint16_t c);
+
 #endif /* __MJVM_NATIVE_CHARACTER_CLASS_H */
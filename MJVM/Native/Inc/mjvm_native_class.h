@@ -40,4 +40,32 @@ private:
 extern const NativeClass *NATIVE_CLASS_LIST[];
 extern const uint32_t NATIVE_CLASS_COUNT;
 
+typedef struct {
+    uint32_t hash;
+    const NativeClass *nativeClass;
+    const NativeMethod *method;
+} NativeMethodEntry;
+
+/*
+ * Native methods are looked up by (class, name, descriptor) in an open addressing table.
+ * The table is built from NATIVE_CLASS_LIST on the first lookup, the classes registered
+ * at runtime are added to it and take the place of a built in method with the same key.
+ */
+class NativeMethodTable {
+private:
+    static NativeMethodEntry *entries;
+    static uint32_t capacity;
+    static uint32_t count;
+
+    NativeMethodTable(void) = delete;
+
+    static uint32_t calcHash(const MjvmConstUtf8 &className, const MjvmConstUtf8 &name, const MjvmConstUtf8 &descriptor);
+    static void init(void);
+    static void grow(uint32_t minCount);
+    static void add(const NativeClass &nativeClass);
+public:
+    static void registerClass(const NativeClass &nativeClass);
+    static MjvmNativeMethodPtr findMethod(const MjvmConstUtf8 &className, const MjvmConstUtf8 &name, const MjvmConstUtf8 &descriptor);
+};
+
 #endif /* __MJVM_NATIVE_METHOD_H */
@@ -0,0 +1,9 @@
+
+#ifndef __MJVM_NATIVE_FORK_JOIN_POOL_CLASS_H
+#define __MJVM_NATIVE_FORK_JOIN_POOL_CLASS_H
+
+#include "mjvm_native_class.h"
+
+extern const NativeClass FORK_JOIN_POOL_CLASS;
+
+#endif /* __MJVM_NATIVE_FORK_JOIN_POOL_CLASS_H */
@@ -0,0 +1,25 @@
+
+#ifndef __MJVM_NATIVE_NUMBER_FORMAT_H
+#define __MJVM_NATIVE_NUMBER_FORMAT_H
+
+#include "mjvm_std_types.h"
+
+#define NUMBER_FORMAT_BUFF_SIZE         32
+#define NUMBER_FORMAT_RADIX_BUFF_SIZE   66
+
+/*
+ * Format numbers the way Integer.toString, Long.toString, Float.toString and Double.toString do.
+ * The text is written to buff (at least NUMBER_FORMAT_BUFF_SIZE bytes) and its length is returned.
+ */
+uint32_t NumberFormat_Int32(int32_t value, char *buff);
+uint32_t NumberFormat_Int64(int64_t value, char *buff);
+uint32_t NumberFormat_Float(float value, char *buff);
+uint32_t NumberFormat_Double(double value, char *buff);
+
+/*
+ * Format value in a radix from 2 to 36 with the lower case letters, like Long.toString(long, int) does.
+ * buff has at least NUMBER_FORMAT_RADIX_BUFF_SIZE bytes.
+ */
+uint32_t NumberFormat_Int64Radix(int64_t value, uint32_t radix, char *buff);
+
+#endif /* __MJVM_NATIVE_NUMBER_FORMAT_H */
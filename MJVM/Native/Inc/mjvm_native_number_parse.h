@@ -0,0 +1,14 @@
+
+#ifndef __MJVM_NATIVE_NUMBER_PARSE_H
+#define __MJVM_NATIVE_NUMBER_PARSE_H
+
+#include "mjvm.h"
+
+/*
+ * Parse str the way Integer.parseInt(String, int) and Long.parseLong(String, int) do.
+ * On error a NumberFormatException is pushed onto the stack of execution and false is returned.
+ */
+bool NumberParse_Int32(MjvmExecution &execution, MjvmString *str, int32_t radix, int32_t &value);
+bool NumberParse_Int64(MjvmExecution &execution, MjvmString *str, int32_t radix, int64_t &value);
+
+#endif /* __MJVM_NATIVE_NUMBER_PARSE_H */
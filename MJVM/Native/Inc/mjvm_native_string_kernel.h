@@ -0,0 +1,30 @@
+
+#ifndef __MJVM_NATIVE_STRING_KERNEL_H
+#define __MJVM_NATIVE_STRING_KERNEL_H
+
+#include "mjvm_std_types.h"
+
+/*
+ * Loops over the value array of the strings, shared by StringLatin1 and StringUTF16.
+ * They use SSE2 or AVX2 when the VM is built for such a target and plain loops otherwise.
+ * UTF16 values are read as native 16 bit words, the VM only runs on little endian targets.
+ */
+int32_t StringKernel_IndexOf8(const uint8_t *data, uint32_t length, uint8_t c);
+int32_t StringKernel_IndexOf16(const uint16_t *data, uint32_t length, uint16_t c);
+int32_t StringKernel_LastIndexOf8(const uint8_t *data, uint32_t length, uint8_t c);
+int32_t StringKernel_LastIndexOf16(const uint16_t *data, uint32_t length, uint16_t c);
+uint32_t StringKernel_Mismatch(const uint8_t *data1, const uint8_t *data2, uint32_t length);
+int32_t StringKernel_HashCode8(const uint8_t *data, uint32_t length);
+int32_t StringKernel_HashCode16(const uint16_t *data, uint32_t length);
+
+bool StringKernel_IsLatin1(const uint16_t *data, uint32_t length);
+void StringKernel_Inflate(const uint8_t *src, uint16_t *dst, uint32_t length);
+void StringKernel_Compress(const uint16_t *src, uint8_t *dst, uint32_t length);
+void StringKernel_Replace8(const uint8_t *src, uint8_t *dst, uint32_t length, uint8_t oldChar, uint8_t newChar);
+void StringKernel_Replace16(const uint16_t *src, uint16_t *dst, uint32_t length, uint16_t oldChar, uint16_t newChar);
+
+int32_t StringKernel_FindCase8(const uint8_t *data, uint32_t length, bool isToUpper);
+void StringKernel_ConvertCase8(const uint8_t *src, uint8_t *dst, uint32_t length, bool isToUpper);
+bool StringKernel_EqualsIgnoreCase8(const uint8_t *data1, const uint8_t *data2, uint32_t length);
+
+#endif /* __MJVM_NATIVE_STRING_KERNEL_H */
@@ -0,0 +1,192 @@
+
+#include <string.h>
+#include "mjvm.h"
+#include "mjvm_object.h"
+#include "mjvm_const_name.h"
+#include "mjvm_fields_data.h"
+#include "mjvm_native_number_format.h"
+#include "mjvm_native_string_kernel.h"
+#include "mjvm_native_abstract_string_builder_class.h"
+
+static const uint32_t valueFieldName[] = {
+    (uint32_t)"\x05\x00\x1D\x02""value",                /* field name */
+    (uint32_t)"\x02\x00\x9D\x00""[B"                    /* field type */
+};
+
+static const uint32_t coderFieldName[] = {
+    (uint32_t)"\x05\x00\x0D\x02""coder",                /* field name */
+    (uint32_t)"\x01\x00\x42\x00""B"                     /* field type */
+};
+
+static const uint32_t countFieldName[] = {
+    (uint32_t)"\x05\x00\x29\x02""count",                /* field name */
+    (uint32_t)"\x01\x00\x49\x00""I"                     /* field type */
+};
+
+/*
+ * Make room for minCapacity characters and switch the value to utf16 when isUtf16 is set.
+ * The capacity grows geometrically so that a long run of appends only copies the value a few times.
+ */
+static uint8_t *ensureCapacity(MjvmExecution &execution, MjvmFieldsData &fields, uint32_t minCapacity, bool isUtf16) {
+    MjvmFieldObject &value = fields.getFieldObject(*(MjvmConstNameAndType *)valueFieldName);
+    MjvmFieldData32 &coder = fields.getFieldData32(*(MjvmConstNameAndType *)coderFieldName);
+    uint32_t count = fields.getFieldData32(*(MjvmConstNameAndType *)countFieldName).value;
+    uint32_t oldCapacity = value.object->size >> coder.value;
+    bool isInflate = isUtf16 && (coder.value == 0);
+    if((minCapacity <= oldCapacity) && !isInflate)
+        return value.object->data;
+
+    uint32_t newCapacity = oldCapacity;
+    if(minCapacity > oldCapacity) {
+        newCapacity = (oldCapacity << 1) + 2;
+        if(newCapacity < minCapacity)
+            newCapacity = minCapacity;
+    }
+    uint8_t newCoder = isUtf16 ? 1 : coder.value;
+    MjvmObject *buff = execution.mjvm.newObject(newCapacity << newCoder, *(MjvmConstUtf8 *)primTypeConstUtf8List[4], 1);
+    if(isInflate)
+        StringKernel_Inflate(value.object->data, (uint16_t *)buff->data, count);
+    else
+        memcpy(buff->data, value.object->data, count << newCoder);
+    memset(&buff->data[count << newCoder], 0, (newCapacity - count) << newCoder);
+    value.object = buff;
+    coder.value = newCoder;
+    return buff->data;
+}
+
+static void appendLatin1(MjvmExecution &execution, MjvmFieldsData &fields, const uint8_t *src, uint32_t length) {
+    MjvmFieldData32 &count = fields.getFieldData32(*(MjvmConstNameAndType *)countFieldName);
+    uint8_t *data = ensureCapacity(execution, fields, count.value + length, false);
+    if(fields.getFieldData32(*(MjvmConstNameAndType *)coderFieldName).value == 0)
+        memcpy(&data[count.value], src, length);
+    else
+        StringKernel_Inflate(src, &((uint16_t *)data)[count.value], length);
+    count.value += length;
+}
+
+static void appendUtf16(MjvmExecution &execution, MjvmFieldsData &fields, const uint16_t *src, uint32_t length) {
+    MjvmFieldData32 &count = fields.getFieldData32(*(MjvmConstNameAndType *)countFieldName);
+    bool isLatin1 = fields.getFieldData32(*(MjvmConstNameAndType *)coderFieldName).value == 0;
+    if(isLatin1 && StringKernel_IsLatin1(src, length)) {
+        /* the text fits in the latin1 value, there is no need to inflate the builder */
+        uint8_t *data = ensureCapacity(execution, fields, count.value + length, false);
+        StringKernel_Compress(src, &data[count.value], length);
+    }
+    else {
+        uint8_t *data = ensureCapacity(execution, fields, count.value + length, true);
+        memcpy(&((uint16_t *)data)[count.value], src, length << 1);
+    }
+    count.value += length;
+}
+
+static bool nativeAppendString(MjvmExecution &execution) {
+    MjvmString *str = (MjvmString *)execution.stackPopObject();
+    MjvmObject *obj = execution.stackPopObject();
+    MjvmFieldsData &fields = *(MjvmFieldsData *)obj->data;
+    if(str == 0)
+        appendLatin1(execution, fields, (const uint8_t *)"null", 4);
+    else if(str->getCoder() == 0)
+        appendLatin1(execution, fields, (const uint8_t *)str->getText(), str->getLength());
+    else
+        appendUtf16(execution, fields, (const uint16_t *)str->getText(), str->getLength());
+    execution.stackPushObject(obj);
+    return true;
+}
+
+static bool nativeAppendChar(MjvmExecution &execution) {
+    uint16_t c = execution.stackPopInt32();
+    MjvmObject *obj = execution.stackPopObject();
+    MjvmFieldsData &fields = *(MjvmFieldsData *)obj->data;
+    if(c <= 0xFF) {
+        uint8_t latin1 = c;
+        appendLatin1(execution, fields, &latin1, 1);
+    }
+    else
+        appendUtf16(execution, fields, &c, 1);
+    execution.stackPushObject(obj);
+    return true;
+}
+
+static bool nativeAppendInt(MjvmExecution &execution) {
+    char buff[NUMBER_FORMAT_BUFF_SIZE];
+    int32_t value = execution.stackPopInt32();
+    MjvmObject *obj = execution.stackPopObject();
+    uint32_t length = NumberFormat_Int32(value, buff);
+    appendLatin1(execution, *(MjvmFieldsData *)obj->data, (const uint8_t *)buff, length);
+    execution.stackPushObject(obj);
+    return true;
+}
+
+static bool nativeAppendLong(MjvmExecution &execution) {
+    char buff[NUMBER_FORMAT_BUFF_SIZE];
+    int64_t value = execution.stackPopInt64();
+    MjvmObject *obj = execution.stackPopObject();
+    uint32_t length = NumberFormat_Int64(value, buff);
+    appendLatin1(execution, *(MjvmFieldsData *)obj->data, (const uint8_t *)buff, length);
+    execution.stackPushObject(obj);
+    return true;
+}
+
+static bool nativeAppendFloat(MjvmExecution &execution) {
+    char buff[NUMBER_FORMAT_BUFF_SIZE];
+    float value = execution.stackPopFloat();
+    MjvmObject *obj = execution.stackPopObject();
+    uint32_t length = NumberFormat_Float(value, buff);
+    appendLatin1(execution, *(MjvmFieldsData *)obj->data, (const uint8_t *)buff, length);
+    execution.stackPushObject(obj);
+    return true;
+}
+
+static bool nativeAppendDouble(MjvmExecution &execution) {
+    char buff[NUMBER_FORMAT_BUFF_SIZE];
+    double value = execution.stackPopDouble();
+    MjvmObject *obj = execution.stackPopObject();
+    uint32_t length = NumberFormat_Double(value, buff);
+    appendLatin1(execution, *(MjvmFieldsData *)obj->data, (const uint8_t *)buff, length);
+    execution.stackPushObject(obj);
+    return true;
+}
+
+static bool nativeInflate(MjvmExecution &execution) {
+    MjvmObject *obj = execution.stackPopObject();
+    MjvmFieldsData &fields = *(MjvmFieldsData *)obj->data;
+    uint32_t count = fields.getFieldData32(*(MjvmConstNameAndType *)countFieldName).value;
+    ensureCapacity(execution, fields, count, true);
+    return true;
+}
+
+static bool nativeToString(MjvmExecution &execution) {
+    MjvmObject *obj = execution.stackPopObject();
+    MjvmFieldsData &fields = *(MjvmFieldsData *)obj->data;
+    const uint8_t *value = fields.getFieldObject(*(MjvmConstNameAndType *)valueFieldName).object->data;
+    uint32_t coder = fields.getFieldData32(*(MjvmConstNameAndType *)coderFieldName).value;
+    uint32_t count = fields.getFieldData32(*(MjvmConstNameAndType *)countFieldName).value;
+    MjvmString *strObj;
+    if(coder == 0) {
+        strObj = execution.mjvm.newString(count, 0);
+        memcpy((uint8_t *)strObj->getText(), value, count);
+    }
+    else if(StringKernel_IsLatin1((const uint16_t *)value, count)) {
+        strObj = execution.mjvm.newString(count, 0);
+        StringKernel_Compress((const uint16_t *)value, (uint8_t *)strObj->getText(), count);
+    }
+    else {
+        strObj = execution.mjvm.newString(count, 1);
+        memcpy((uint8_t *)strObj->getText(), value, count << 1);
+    }
+    execution.stackPushObject(strObj);
+    return true;
+}
+
+static const NativeMethod methods[] = {
+    NATIVE_METHOD("\x06\x00\x78\x02""append",   "\x35\x00\x8C\x13""(Ljava/lang/String;)Ljava/lang/AbstractStringBuilder;", nativeAppendString),
+    NATIVE_METHOD("\x06\x00\x78\x02""append",   "\x24\x00\x2F\x0D""(C)Ljava/lang/AbstractStringBuilder;",                  nativeAppendChar),
+    NATIVE_METHOD("\x06\x00\x78\x02""append",   "\x24\x00\x35\x0D""(I)Ljava/lang/AbstractStringBuilder;",                  nativeAppendInt),
+    NATIVE_METHOD("\x06\x00\x78\x02""append",   "\x24\x00\x36\x0D""(J)Ljava/lang/AbstractStringBuilder;",                  nativeAppendLong),
+    NATIVE_METHOD("\x06\x00\x78\x02""append",   "\x24\x00\x32\x0D""(F)Ljava/lang/AbstractStringBuilder;",                  nativeAppendFloat),
+    NATIVE_METHOD("\x06\x00\x78\x02""append",   "\x24\x00\x30\x0D""(D)Ljava/lang/AbstractStringBuilder;",                  nativeAppendDouble),
+    NATIVE_METHOD("\x07\x00\xE3\x02""inflate",  "\x03\x00\xA7\x00""()V",                                                   nativeInflate),
+    NATIVE_METHOD("\x08\x00\x5A\x03""toString", "\x14\x00\xF1\x06""()Ljava/lang/String;",                                  nativeToString),
+};
+
+const NativeClass ABSTRACT_STRING_BUILDER_CLASS = NATIVE_CLASS(abstractStringBuilderClassName, methods);
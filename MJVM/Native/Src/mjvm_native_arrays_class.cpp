@@ -0,0 +1,525 @@
+
+#include <string.h>
+#include "mjvm.h"
+#include "mjvm_object.h"
+#include "mjvm_const_name.h"
+#include "mjvm_native_string_kernel.h"
+#include "mjvm_native_arrays_class.h"
+
+#define INSERTION_SORT_THRESHOLD        16
+#define COUNTING_SORT_THRESHOLD         64
+#define RADIX_SORT_THRESHOLD            1024
+
+static uint8_t getArrayType(const MjvmObject *array) {
+    return (array->dimensions == 1) ? MjvmObject::isPrimType(array->type) : 0;
+}
+
+/*
+ * float and double are sorted and searched as integer keys that have the order of Float.compare and Double.compare.
+ * NaN becomes the canonical NaN, which is greater than the positive infinity, and -0.0 comes before 0.0.
+ */
+static inline int32_t floatToKey(int32_t bits) {
+    if((bits & 0x7FFFFFFF) > 0x7F800000)
+        bits = 0x7FC00000;
+    return bits ^ ((bits >> 31) & 0x7FFFFFFF);
+}
+
+static inline int32_t keyToFloat(int32_t key) {
+    return key ^ ((key >> 31) & 0x7FFFFFFF);
+}
+
+static inline int64_t doubleToKey(int64_t bits) {
+    if((bits & 0x7FFFFFFFFFFFFFFF) > 0x7FF0000000000000)
+        bits = 0x7FF8000000000000;
+    return bits ^ ((bits >> 63) & 0x7FFFFFFFFFFFFFFF);
+}
+
+static inline int64_t keyToDouble(int64_t key) {
+    return key ^ ((key >> 63) & 0x7FFFFFFFFFFFFFFF);
+}
+
+template <class T>
+static void insertionSort(T *a, int32_t low, int32_t high) {
+    for(int32_t i = low + 1; i < high; i++) {
+        T value = a[i];
+        int32_t j = i - 1;
+        for(; j >= low && value < a[j]; j--)
+            a[j + 1] = a[j];
+        a[j + 1] = value;
+    }
+}
+
+template <class T>
+static void siftDown(T *a, int32_t root, int32_t count) {
+    T value = a[root];
+    while(1) {
+        int32_t child = (root << 1) + 1;
+        if(child >= count)
+            break;
+        if((child + 1) < count && a[child] < a[child + 1])
+            child++;
+        if(!(value < a[child]))
+            break;
+        a[root] = a[child];
+        root = child;
+    }
+    a[root] = value;
+}
+
+template <class T>
+static void heapSort(T *a, int32_t count) {
+    for(int32_t i = (count >> 1) - 1; i >= 0; i--)
+        siftDown(a, i, count);
+    for(int32_t i = count - 1; i > 0; i--) {
+        T value = a[0];
+        a[0] = a[i];
+        a[i] = value;
+        siftDown(a, 0, i);
+    }
+}
+
+template <class T>
+static inline void swap(T *a, int32_t i, int32_t j) {
+    T value = a[i];
+    a[i] = a[j];
+    a[j] = value;
+}
+
+/*
+ * Quicksort with the median of three as the pivot, it switches to heapsort when the partitions go too deep
+ * and finishes the short ranges with insertion sort. Only the smaller partition is sorted recursively.
+ */
+template <class T>
+static void introSort(T *a, int32_t low, int32_t high, uint32_t depth) {
+    while((high - low) > INSERTION_SORT_THRESHOLD) {
+        if(depth == 0) {
+            heapSort(&a[low], high - low);
+            return;
+        }
+        depth--;
+        int32_t mid = low + ((high - low) >> 1);
+        if(a[mid] < a[low])
+            swap(a, mid, low);
+        if(a[high - 1] < a[mid]) {
+            swap(a, high - 1, mid);
+            if(a[mid] < a[low])
+                swap(a, mid, low);
+        }
+        /* the pivot is moved to the first element so that the right partition is never empty */
+        swap(a, low, mid);
+        T pivot = a[low];
+        int32_t i = low - 1;
+        int32_t j = high;
+        while(1) {
+            do {
+                i++;
+            } while(a[i] < pivot);
+            do {
+                j--;
+            } while(pivot < a[j]);
+            if(i >= j)
+                break;
+            swap(a, i, j);
+        }
+        j++;
+        if((j - low) < (high - j)) {
+            introSort(a, low, j, depth);
+            low = j;
+        }
+        else {
+            introSort(a, j, high, depth);
+            high = j;
+        }
+    }
+    insertionSort(a, low, high);
+}
+
+template <class T>
+static void sort(T *a, int32_t low, int32_t high) {
+    uint32_t depth = 0;
+    for(uint32_t count = high - low; count > 1; count >>= 1)
+        depth += 2;
+    introSort(a, low, high, depth);
+}
+
+static void countingSort8(int8_t *a, int32_t low, int32_t high) {
+    uint32_t counts[256];
+    memset(counts, 0, sizeof(counts));
+    for(int32_t i = low; i < high; i++)
+        counts[(uint8_t)a[i] ^ 0x80]++;
+    int32_t index = low;
+    for(uint32_t value = 0; value < 256; value++) {
+        for(uint32_t n = counts[value]; n > 0; n--)
+            a[index++] = (int8_t)(value ^ 0x80);
+    }
+}
+
+/* least significant byte first, signMask flips the sign bit of short so that the negative values come first */
+static void radixSort16(uint16_t *a, int32_t count, uint16_t signMask) {
+    uint32_t lowCounts[256];
+    uint32_t highCounts[256];
+    memset(lowCounts, 0, sizeof(lowCounts));
+    memset(highCounts, 0, sizeof(highCounts));
+    for(int32_t i = 0; i < count; i++) {
+        lowCounts[a[i] & 0xFF]++;
+        highCounts[(a[i] ^ signMask) >> 8]++;
+    }
+    uint32_t lowIndex = 0;
+    uint32_t highIndex = 0;
+    for(uint32_t i = 0; i < 256; i++) {
+        uint32_t n = lowCounts[i];
+        lowCounts[i] = lowIndex;
+        lowIndex += n;
+        n = highCounts[i];
+        highCounts[i] = highIndex;
+        highIndex += n;
+    }
+    uint16_t *buff = (uint16_t *)Mjvm::malloc(count * sizeof(uint16_t));
+    for(int32_t i = 0; i < count; i++)
+        buff[lowCounts[a[i] & 0xFF]++] = a[i];
+    for(int32_t i = 0; i < count; i++)
+        a[highCounts[(buff[i] ^ signMask) >> 8]++] = buff[i];
+    Mjvm::free(buff);
+}
+
+static bool nativeSort(MjvmExecution &execution) {
+    int32_t toIndex = execution.stackPopInt32();
+    int32_t fromIndex = execution.stackPopInt32();
+    MjvmObject *a = execution.stackPopObject();
+    int32_t count = toIndex - fromIndex;
+    switch(getArrayType(a)) {
+        case 5:
+            if(count >= RADIX_SORT_THRESHOLD)
+                radixSort16(&((uint16_t *)a->data)[fromIndex], count, 0);
+            else
+                sort((uint16_t *)a->data, fromIndex, toIndex);
+            break;
+        case 6: {
+            int32_t *data = (int32_t *)a->data;
+            for(int32_t i = fromIndex; i < toIndex; i++)
+                data[i] = floatToKey(data[i]);
+            sort(data, fromIndex, toIndex);
+            for(int32_t i = fromIndex; i < toIndex; i++)
+                data[i] = keyToFloat(data[i]);
+            break;
+        }
+        case 7: {
+            int64_t *data = (int64_t *)a->data;
+            for(int32_t i = fromIndex; i < toIndex; i++)
+                data[i] = doubleToKey(data[i]);
+            sort(data, fromIndex, toIndex);
+            for(int32_t i = fromIndex; i < toIndex; i++)
+                data[i] = keyToDouble(data[i]);
+            break;
+        }
+        case 8:
+            if(count >= COUNTING_SORT_THRESHOLD)
+                countingSort8((int8_t *)a->data, fromIndex, toIndex);
+            else
+                sort((int8_t *)a->data, fromIndex, toIndex);
+            break;
+        case 9:
+            if(count >= RADIX_SORT_THRESHOLD)
+                radixSort16(&((uint16_t *)a->data)[fromIndex], count, 0x8000);
+            else
+                sort((int16_t *)a->data, fromIndex, toIndex);
+            break;
+        case 10:
+            sort((int32_t *)a->data, fromIndex, toIndex);
+            break;
+        case 11:
+            sort((int64_t *)a->data, fromIndex, toIndex);
+            break;
+    }
+    return true;
+}
+
+template <class T>
+static int32_t binarySearch(const T *a, int32_t low, int32_t high, T key) {
+    high--;
+    while(low <= high) {
+        int32_t mid = (uint32_t)(low + high) >> 1;
+        if(a[mid] < key)
+            low = mid + 1;
+        else if(key < a[mid])
+            high = mid - 1;
+        else
+            return mid;
+    }
+    return -(low + 1);
+}
+
+static int32_t binarySearchFloat(const int32_t *a, int32_t low, int32_t high, int32_t key) {
+    high--;
+    key = floatToKey(key);
+    while(low <= high) {
+        int32_t mid = (uint32_t)(low + high) >> 1;
+        int32_t midKey = floatToKey(a[mid]);
+        if(midKey < key)
+            low = mid + 1;
+        else if(key < midKey)
+            high = mid - 1;
+        else
+            return mid;
+    }
+    return -(low + 1);
+}
+
+static int32_t binarySearchDouble(const int64_t *a, int32_t low, int32_t high, int64_t key) {
+    high--;
+    key = doubleToKey(key);
+    while(low <= high) {
+        int32_t mid = (uint32_t)(low + high) >> 1;
+        int64_t midKey = doubleToKey(a[mid]);
+        if(midKey < key)
+            low = mid + 1;
+        else if(key < midKey)
+            high = mid - 1;
+        else
+            return mid;
+    }
+    return -(low + 1);
+}
+
+static bool nativeBinarySearch32(MjvmExecution &execution) {
+    int32_t key = execution.stackPopInt32();
+    int32_t toIndex = execution.stackPopInt32();
+    int32_t fromIndex = execution.stackPopInt32();
+    MjvmObject *a = execution.stackPopObject();
+    int32_t index;
+    switch(getArrayType(a)) {
+        case 5:
+            index = binarySearch((const uint16_t *)a->data, fromIndex, toIndex, (uint16_t)key);
+            break;
+        case 6:
+            index = binarySearchFloat((const int32_t *)a->data, fromIndex, toIndex, key);
+            break;
+        case 8:
+            index = binarySearch((const int8_t *)a->data, fromIndex, toIndex, (int8_t)key);
+            break;
+        case 9:
+            index = binarySearch((const int16_t *)a->data, fromIndex, toIndex, (int16_t)key);
+            break;
+        default:
+            index = binarySearch((const int32_t *)a->data, fromIndex, toIndex, key);
+            break;
+    }
+    execution.stackPushInt32(index);
+    return true;
+}
+
+static bool nativeBinarySearch64(MjvmExecution &execution) {
+    int64_t key = execution.stackPopInt64();
+    int32_t toIndex = execution.stackPopInt32();
+    int32_t fromIndex = execution.stackPopInt32();
+    MjvmObject *a = execution.stackPopObject();
+    int32_t index;
+    if(getArrayType(a) == 7)
+        index = binarySearchDouble((const int64_t *)a->data, fromIndex, toIndex, key);
+    else
+        index = binarySearch((const int64_t *)a->data, fromIndex, toIndex, key);
+    execution.stackPushInt32(index);
+    return true;
+}
+
+static bool nativeEquals(MjvmExecution &execution) {
+    MjvmObject *a2 = execution.stackPopObject();
+    MjvmObject *a = execution.stackPopObject();
+    bool isEquals;
+    if(a == a2)
+        isEquals = true;
+    else if(a == 0 || a2 == 0 || a->size != a2->size)
+        isEquals = false;
+    else {
+        isEquals = (memcmp(a->data, a2->data, a->size) == 0);
+        /* the floating point values are compared by their bits, except that all the NaN values are the same */
+        uint8_t atype = getArrayType(a);
+        if(!isEquals && atype == 6) {
+            const int32_t *data1 = (const int32_t *)a->data;
+            const int32_t *data2 = (const int32_t *)a2->data;
+            uint32_t length = a->size / sizeof(int32_t);
+            isEquals = true;
+            for(uint32_t i = 0; isEquals && i < length; i++)
+                isEquals = (floatToKey(data1[i]) == floatToKey(data2[i]));
+        }
+        else if(!isEquals && atype == 7) {
+            const int64_t *data1 = (const int64_t *)a->data;
+            const int64_t *data2 = (const int64_t *)a2->data;
+            uint32_t length = a->size / sizeof(int64_t);
+            isEquals = true;
+            for(uint32_t i = 0; isEquals && i < length; i++)
+                isEquals = (doubleToKey(data1[i]) == doubleToKey(data2[i]));
+        }
+    }
+    execution.stackPushInt32(isEquals);
+    return true;
+}
+
+static int32_t hashCode64(const int64_t *data, uint32_t length, bool isDouble) {
+    uint32_t hash = 1;
+    for(uint32_t i = 0; i < length; i++) {
+        int64_t value = data[i];
+        if(isDouble && (value & 0x7FFFFFFFFFFFFFFF) > 0x7FF0000000000000)
+            value = 0x7FF8000000000000;
+        hash = hash * 31 + (uint32_t)(value ^ ((uint64_t)value >> 32));
+    }
+    return hash;
+}
+
+static bool nativeHashCode(MjvmExecution &execution) {
+    MjvmObject *a = execution.stackPopObject();
+    if(a == 0) {
+        execution.stackPushInt32(0);
+        return true;
+    }
+    uint8_t atype = getArrayType(a);
+    uint32_t length = a->size / MjvmObject::getPrimitiveTypeSize(atype);
+    uint32_t hash = 1;
+    switch(atype) {
+        case 4:
+            for(uint32_t i = 0; i < length; i++)
+                hash = hash * 31 + (a->data[i] ? 1231 : 1237);
+            break;
+        case 5: {
+            /* the same as the hash of a string with 1 in front of it, so the string kernel does the work */
+            uint32_t power = 31;
+            for(uint32_t n = length; n > 0; n >>= 1) {
+                if(n & 0x01)
+                    hash *= power;
+                power *= power;
+            }
+            hash += StringKernel_HashCode16((const uint16_t *)a->data, length);
+            break;
+        }
+        case 6: {
+            const int32_t *data = (const int32_t *)a->data;
+            for(uint32_t i = 0; i < length; i++)
+                hash = hash * 31 + (((data[i] & 0x7FFFFFFF) > 0x7F800000) ? 0x7FC00000 : data[i]);
+            break;
+        }
+        case 7:
+            hash = hashCode64((const int64_t *)a->data, length, true);
+            break;
+        case 8:
+            for(uint32_t i = 0; i < length; i++)
+                hash = hash * 31 + ((const int8_t *)a->data)[i];
+            break;
+        case 9:
+            for(uint32_t i = 0; i < length; i++)
+                hash = hash * 31 + ((const int16_t *)a->data)[i];
+            break;
+        case 10:
+            for(uint32_t i = 0; i < length; i++)
+                hash = hash * 31 + ((const int32_t *)a->data)[i];
+            break;
+        case 11:
+            hash = hashCode64((const int64_t *)a->data, length, false);
+            break;
+    }
+    execution.stackPushInt32(hash);
+    return true;
+}
+
+static bool nativeFill32(MjvmExecution &execution) {
+    int32_t value = execution.stackPopInt32();
+    int32_t toIndex = execution.stackPopInt32();
+    int32_t fromIndex = execution.stackPopInt32();
+    MjvmObject *a = execution.stackPopObject();
+    switch(MjvmObject::getPrimitiveTypeSize(getArrayType(a))) {
+        case 1:
+            memset(&a->data[fromIndex], value, toIndex - fromIndex);
+            break;
+        case 2: {
+            uint16_t *data = (uint16_t *)a->data;
+            for(int32_t i = fromIndex; i < toIndex; i++)
+                data[i] = value;
+            break;
+        }
+        default: {
+            int32_t *data = (int32_t *)a->data;
+            for(int32_t i = fromIndex; i < toIndex; i++)
+                data[i] = value;
+            break;
+        }
+    }
+    return true;
+}
+
+static bool nativeFill64(MjvmExecution &execution) {
+    int64_t value = execution.stackPopInt64();
+    int32_t toIndex = execution.stackPopInt32();
+    int32_t fromIndex = execution.stackPopInt32();
+    int64_t *data = (int64_t *)execution.stackPopObject()->data;
+    for(int32_t i = fromIndex; i < toIndex; i++)
+        data[i] = value;
+    return true;
+}
+
+static bool nativeCopyRange(MjvmExecution &execution) {
+    int32_t to = execution.stackPopInt32();
+    int32_t from = execution.stackPopInt32();
+    MjvmObject *original = execution.stackPopObject();
+    uint8_t atype = getArrayType(original);
+    uint32_t elementSize = atype ? MjvmObject::getPrimitiveTypeSize(atype) : sizeof(MjvmObject *);
+    uint32_t length = to - from;
+    uint32_t count = original->size / elementSize - from;
+    if(count > length)
+        count = length;
+    MjvmObject *copy = execution.mjvm.newObject(length * elementSize, original->type, original->dimensions);
+    memcpy(copy->data, &original->data[from * elementSize], count * elementSize);
+    memset(&copy->data[count * elementSize], 0, (length - count) * elementSize);
+    execution.stackPushObject(copy);
+    return true;
+}
+
+static const NativeMethod methods[] = {
+    NATIVE_METHOD("\x09\x00\xB5\x03""sortRange",         "\x07\x00\xDE\x01""([JII)V",                                    nativeSort),
+    NATIVE_METHOD("\x09\x00\xB5\x03""sortRange",         "\x07\x00\xDD\x01""([III)V",                                    nativeSort),
+    NATIVE_METHOD("\x09\x00\xB5\x03""sortRange",         "\x07\x00\xE7\x01""([SII)V",                                    nativeSort),
+    NATIVE_METHOD("\x09\x00\xB5\x03""sortRange",         "\x07\x00\xD7\x01""([CII)V",                                    nativeSort),
+    NATIVE_METHOD("\x09\x00\xB5\x03""sortRange",         "\x07\x00\xD6\x01""([BII)V",                                    nativeSort),
+    NATIVE_METHOD("\x09\x00\xB5\x03""sortRange",         "\x07\x00\xDA\x01""([FII)V",                                    nativeSort),
+    NATIVE_METHOD("\x09\x00\xB5\x03""sortRange",         "\x07\x00\xD8\x01""([DII)V",                                    nativeSort),
+    NATIVE_METHOD("\x11\x00\xC8\x06""binarySearchRange", "\x08\x00\x1B\x02""([JIIJ)I",                                   nativeBinarySearch64),
+    NATIVE_METHOD("\x11\x00\xC8\x06""binarySearchRange", "\x08\x00\x19\x02""([IIII)I",                                   nativeBinarySearch32),
+    NATIVE_METHOD("\x11\x00\xC8\x06""binarySearchRange", "\x08\x00\x2D\x02""([SIIS)I",                                   nativeBinarySearch32),
+    NATIVE_METHOD("\x11\x00\xC8\x06""binarySearchRange", "\x08\x00\x0D\x02""([CIIC)I",                                   nativeBinarySearch32),
+    NATIVE_METHOD("\x11\x00\xC8\x06""binarySearchRange", "\x08\x00\x0B\x02""([BIIB)I",                                   nativeBinarySearch32),
+    NATIVE_METHOD("\x11\x00\xC8\x06""binarySearchRange", "\x08\x00\x13\x02""([FIIF)I",                                   nativeBinarySearch32),
+    NATIVE_METHOD("\x11\x00\xC8\x06""binarySearchRange", "\x08\x00\x0F\x02""([DIID)I",                                   nativeBinarySearch64),
+    NATIVE_METHOD("\x06\x00\x8B\x02""equals",            "\x07\x00\xF5\x01""([J[J)Z",                                    nativeEquals),
+    NATIVE_METHOD("\x06\x00\x8B\x02""equals",            "\x07\x00\xF3\x01""([I[I)Z",                                    nativeEquals),
+    NATIVE_METHOD("\x06\x00\x8B\x02""equals",            "\x07\x00\x07\x02""([S[S)Z",                                    nativeEquals),
+    NATIVE_METHOD("\x06\x00\x8B\x02""equals",            "\x07\x00\xE7\x01""([C[C)Z",                                    nativeEquals),
+    NATIVE_METHOD("\x06\x00\x8B\x02""equals",            "\x07\x00\xE5\x01""([B[B)Z",                                    nativeEquals),
+    NATIVE_METHOD("\x06\x00\x8B\x02""equals",            "\x07\x00\x15\x02""([Z[Z)Z",                                    nativeEquals),
+    NATIVE_METHOD("\x06\x00\x8B\x02""equals",            "\x07\x00\xED\x01""([F[F)Z",                                    nativeEquals),
+    NATIVE_METHOD("\x06\x00\x8B\x02""equals",            "\x07\x00\xE9\x01""([D[D)Z",                                    nativeEquals),
+    NATIVE_METHOD("\x09\x00\x94\x03""fillRange",         "\x08\x00\x28\x02""([JIIJ)V",                                   nativeFill64),
+    NATIVE_METHOD("\x09\x00\x94\x03""fillRange",         "\x08\x00\x26\x02""([IIII)V",                                   nativeFill32),
+    NATIVE_METHOD("\x09\x00\x94\x03""fillRange",         "\x08\x00\x3A\x02""([SIIS)V",                                   nativeFill32),
+    NATIVE_METHOD("\x09\x00\x94\x03""fillRange",         "\x08\x00\x1A\x02""([CIIC)V",                                   nativeFill32),
+    NATIVE_METHOD("\x09\x00\x94\x03""fillRange",         "\x08\x00\x18\x02""([BIIB)V",                                   nativeFill32),
+    NATIVE_METHOD("\x09\x00\x94\x03""fillRange",         "\x08\x00\x48\x02""([ZIIZ)V",                                   nativeFill32),
+    NATIVE_METHOD("\x09\x00\x94\x03""fillRange",         "\x08\x00\x20\x02""([FIIF)V",                                   nativeFill32),
+    NATIVE_METHOD("\x09\x00\x94\x03""fillRange",         "\x08\x00\x1C\x02""([DIID)V",                                   nativeFill64),
+    NATIVE_METHOD("\x09\x00\xA8\x03""copyRange",         "\x08\x00\x2D\x02""([JII)[J",                                   nativeCopyRange),
+    NATIVE_METHOD("\x09\x00\xA8\x03""copyRange",         "\x08\x00\x2B\x02""([III)[I",                                   nativeCopyRange),
+    NATIVE_METHOD("\x09\x00\xA8\x03""copyRange",         "\x08\x00\x3F\x02""([SII)[S",                                   nativeCopyRange),
+    NATIVE_METHOD("\x09\x00\xA8\x03""copyRange",         "\x08\x00\x1F\x02""([CII)[C",                                   nativeCopyRange),
+    NATIVE_METHOD("\x09\x00\xA8\x03""copyRange",         "\x08\x00\x1D\x02""([BII)[B",                                   nativeCopyRange),
+    NATIVE_METHOD("\x09\x00\xA8\x03""copyRange",         "\x08\x00\x4D\x02""([ZII)[Z",                                   nativeCopyRange),
+    NATIVE_METHOD("\x09\x00\xA8\x03""copyRange",         "\x08\x00\x25\x02""([FII)[F",                                   nativeCopyRange),
+    NATIVE_METHOD("\x09\x00\xA8\x03""copyRange",         "\x08\x00\x21\x02""([DII)[D",                                   nativeCopyRange),
+    NATIVE_METHOD("\x09\x00\xA8\x03""copyRange",         "\x2A\x00\x99\x0E""([Ljava/lang/Object;II)[Ljava/lang/Object;", nativeCopyRange),
+    NATIVE_METHOD("\x08\x00\x1F\x03""hashCode",          "\x05\x00\x3F\x01""([J)I",                                      nativeHashCode),
+    NATIVE_METHOD("\x08\x00\x1F\x03""hashCode",          "\x05\x00\x3E\x01""([I)I",                                      nativeHashCode),
+    NATIVE_METHOD("\x08\x00\x1F\x03""hashCode",          "\x05\x00\x48\x01""([S)I",                                      nativeHashCode),
+    NATIVE_METHOD("\x08\x00\x1F\x03""hashCode",          "\x05\x00\x38\x01""([C)I",                                      nativeHashCode),
+    NATIVE_METHOD("\x08\x00\x1F\x03""hashCode",          "\x05\x00\x37\x01""([B)I",                                      nativeHashCode),
+    NATIVE_METHOD("\x08\x00\x1F\x03""hashCode",          "\x05\x00\x4F\x01""([Z)I",                                      nativeHashCode),
+    NATIVE_METHOD("\x08\x00\x1F\x03""hashCode",          "\x05\x00\x3B\x01""([F)I",                                      nativeHashCode),
+    NATIVE_METHOD("\x08\x00\x1F\x03""hashCode",          "\x05\x00\x39\x01""([D)I",                                      nativeHashCode),
+};
+
+const NativeClass ARRAYS_CLASS = NATIVE_CLASS(arraysClassName, methods);
@@ -0,0 +1,45 @@
+
+#include "mjvm.h"
+#include "mjvm_const_name.h"
+#include "mjvm_fields_data.h"
+#include "mjvm_native_atomic_integer_class.h"
+
+static const uint32_t valueFieldName[] = {
+    (uint32_t)"\x05\x00\x1D\x02""value",                /* field name */
+    (uint32_t)"\x01\x00\x49\x00""I"                     /* field type */
+};
+
+static volatile int32_t *getValue(MjvmObject *obj) {
+    MjvmFieldsData &fields = *(MjvmFieldsData *)obj->data;
+    return &fields.getFieldData32(*(MjvmConstNameAndType *)valueFieldName).value;
+}
+
+static bool nativeGetAndSet(MjvmExecution &execution) {
+    int32_t newValue = execution.stackPopInt32();
+    MjvmObject *obj = execution.stackPopObject();
+    execution.stackPushInt32(Mjvm_GetAndSet32(getValue(obj), newValue));
+    return true;
+}
+
+static bool nativeCompareAndSet(MjvmExecution &execution) {
+    int32_t newValue = execution.stackPopInt32();
+    int32_t expectedValue = execution.stackPopInt32();
+    MjvmObject *obj = execution.stackPopObject();
+    execution.stackPushInt32(Mjvm_CompareAndSwap32(getValue(obj), expectedValue, newValue));
+    return true;
+}
+
+static bool nativeGetAndAdd(MjvmExecution &execution) {
+    int32_t delta = execution.stackPopInt32();
+    MjvmObject *obj = execution.stackPopObject();
+    execution.stackPushInt32(Mjvm_GetAndAdd32(getValue(obj), delta));
+    return true;
+}
+
+static const NativeMethod methods[] = {
+    NATIVE_METHOD("\x09\x00\x7F\x03""getAndSet",     "\x04\x00\xE3\x00""(I)I",  nativeGetAndSet),
+    NATIVE_METHOD("\x0D\x00\x26\x05""compareAndSet", "\x05\x00\x3D\x01""(II)Z", nativeCompareAndSet),
+    NATIVE_METHOD("\x09\x00\x5C\x03""getAndAdd",     "\x04\x00\xE3\x00""(I)I",  nativeGetAndAdd),
+};
+
+const NativeClass ATOMIC_INTEGER_CLASS = NATIVE_CLASS(atomicIntegerClassName, methods);
@@ -0,0 +1,60 @@
+
+#include "mjvm.h"
+#include "mjvm_const_name.h"
+#include "mjvm_fields_data.h"
+#include "mjvm_native_atomic_long_class.h"
+
+static const uint32_t valueFieldName[] = {
+    (uint32_t)"\x05\x00\x1D\x02""value",                /* field name */
+    (uint32_t)"\x01\x00\x4A\x00""J"                     /* field type */
+};
+
+static volatile int64_t *getValue(MjvmObject *obj) {
+    MjvmFieldsData &fields = *(MjvmFieldsData *)obj->data;
+    return &fields.getFieldData64(*(MjvmConstNameAndType *)valueFieldName).value;
+}
+
+static bool nativeGet(MjvmExecution &execution) {
+    MjvmObject *obj = execution.stackPopObject();
+    execution.stackPushInt64(Mjvm_AtomicLoad64(getValue(obj)));
+    return true;
+}
+
+static bool nativeSet(MjvmExecution &execution) {
+    int64_t newValue = execution.stackPopInt64();
+    MjvmObject *obj = execution.stackPopObject();
+    Mjvm_AtomicStore64(getValue(obj), newValue);
+    return true;
+}
+
+static bool nativeGetAndSet(MjvmExecution &execution) {
+    int64_t newValue = execution.stackPopInt64();
+    MjvmObject *obj = execution.stackPopObject();
+    execution.stackPushInt64(Mjvm_GetAndSet64(getValue(obj), newValue));
+    return true;
+}
+
+static bool nativeCompareAndSet(MjvmExecution &execution) {
+    int64_t newValue = execution.stackPopInt64();
+    int64_t expectedValue = execution.stackPopInt64();
+    MjvmObject *obj = execution.stackPopObject();
+    execution.stackPushInt32(Mjvm_CompareAndSwap64(getValue(obj), expectedValue, newValue));
+    return true;
+}
+
+static bool nativeGetAndAdd(MjvmExecution &execution) {
+    int64_t delta = execution.stackPopInt64();
+    MjvmObject *obj = execution.stackPopObject();
+    execution.stackPushInt64(Mjvm_GetAndAdd64(getValue(obj), delta));
+    return true;
+}
+
+static const NativeMethod methods[] = {
+    NATIVE_METHOD("\x03\x00\x40\x01""get",           "\x03\x00\x9B\x00""()J",   nativeGet),
+    NATIVE_METHOD("\x03\x00\x4C\x01""set",           "\x04\x00\xF1\x00""(J)V",  nativeSet),
+    NATIVE_METHOD("\x09\x00\x7F\x03""getAndSet",     "\x04\x00\xE5\x00""(J)J",  nativeGetAndSet),
+    NATIVE_METHOD("\x0D\x00\x26\x05""compareAndSet", "\x05\x00\x3F\x01""(JJ)Z", nativeCompareAndSet),
+    NATIVE_METHOD("\x09\x00\x5C\x03""getAndAdd",     "\x04\x00\xE5\x00""(J)J",  nativeGetAndAdd),
+};
+
+const NativeClass ATOMIC_LONG_CLASS = NATIVE_CLASS(atomicLongClassName, methods);
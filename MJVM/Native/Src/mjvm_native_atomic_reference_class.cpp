@@ -0,0 +1,37 @@
+
+#include "mjvm.h"
+#include "mjvm_const_name.h"
+#include "mjvm_fields_data.h"
+#include "mjvm_native_atomic_reference_class.h"
+
+static const uint32_t valueFieldName[] = {
+    (uint32_t)"\x05\x00\x1D\x02""value",                /* field name */
+    (uint32_t)"\x12\x00\x80\x06""Ljava/lang/Object;"    /* field type */
+};
+
+static volatile int32_t *getValue(MjvmObject *obj) {
+    MjvmFieldsData &fields = *(MjvmFieldsData *)obj->data;
+    return (volatile int32_t *)&fields.getFieldObject(*(MjvmConstNameAndType *)valueFieldName).object;
+}
+
+static bool nativeGetAndSet(MjvmExecution &execution) {
+    MjvmObject *newValue = execution.stackPopObject();
+    MjvmObject *obj = execution.stackPopObject();
+    execution.stackPushObject((MjvmObject *)Mjvm_GetAndSet32(getValue(obj), (int32_t)newValue));
+    return true;
+}
+
+static bool nativeCompareAndSet(MjvmExecution &execution) {
+    MjvmObject *newValue = execution.stackPopObject();
+    MjvmObject *expectedValue = execution.stackPopObject();
+    MjvmObject *obj = execution.stackPopObject();
+    execution.stackPushInt32(Mjvm_CompareAndSwap32(getValue(obj), (int32_t)expectedValue, (int32_t)newValue));
+    return true;
+}
+
+static const NativeMethod methods[] = {
+    NATIVE_METHOD("\x09\x00\x7F\x03""getAndSet",     "\x26\x00\x51\x0D""(Ljava/lang/Object;)Ljava/lang/Object;",  nativeGetAndSet),
+    NATIVE_METHOD("\x0D\x00\x26\x05""compareAndSet", "\x27\x00\xAB\x0D""(Ljava/lang/Object;Ljava/lang/Object;)Z", nativeCompareAndSet),
+};
+
+const NativeClass ATOMIC_REFERENCE_CLASS = NATIVE_CLASS(atomicReferenceClassName, methods);
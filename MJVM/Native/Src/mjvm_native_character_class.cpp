@@ -115,17 +115,25 @@ static int32_t findIndex(const uint16_t *letterList, uint16_t c) {
     return -1;
 }
 
+uint16_t Character_ToLower(uint16_t c) {
+    int32_t index = findIndex(letterUpper, c);
+    return (index >= 0) ? letterLower[index] : c;
+}
+
+uint16_t Character_ToUpper(uint16_t c) {
+    int32_t index = findIndex(letterLower, c);
+    return (index >= 0) ? letterUpper[index] : c;
+}
+
 static bool nativeToLower(MjvmExecution &execution) {
     uint16_t c = execution.stackPopInt32();
-    int32_t index = findIndex(letterUpper, c);
-    execution.stackPushInt32((index >= 0) ? letterLower[index] : c);
+    execution.stackPushInt32(Character_ToLower(c));
     return true;
 }
 
 static bool nativeToUpper(MjvmExecution &execution) {
     uint16_t c = execution.stackPopInt32();
-    int32_t index = findIndex(letterLower, c);
-    execution.stackPushInt32((index >= 0) ? letterUpper[index] : c);
+    execution.stackPushInt32(Character_ToUpper(c));
     return true;
 }
 
@@ -1,13 +1,28 @@
 
+#include <string.h>
+#include "mjvm.h"
 #include "mjvm_native_math_class.h"
 #include "mjvm_native_class_class.h"
 #include "mjvm_native_float_class.h"
 #include "mjvm_native_double_class.h"
 #include "mjvm_native_object_class.h"
 #include "mjvm_native_string_class.h"
+#include "mjvm_native_string_latin1_class.h"
+#include "mjvm_native_string_utf16_class.h"
+#include "mjvm_native_abstract_string_builder_class.h"
 #include "mjvm_native_system_class.h"
 #include "mjvm_native_character_class.h"
 #include "mjvm_native_print_stream_class.h"
+#include "mjvm_native_unsafe_class.h"
+#include "mjvm_native_atomic_long_class.h"
+#include "mjvm_native_fork_join_pool_class.h"
+#include "mjvm_native_atomic_integer_class.h"
+#include "mjvm_native_atomic_reference_class.h"
+#include "mjvm_native_arrays_class.h"
+#include "mjvm_native_hash_map_class.h"
+#include "mjvm_native_int_int_hash_map_class.h"
+#include "mjvm_native_integer_class.h"
+#include "mjvm_native_long_class.h"
 
 const NativeClass *NATIVE_CLASS_LIST[] = {
     &MATH_CLASS,
@@ -16,9 +31,117 @@ const NativeClass *NATIVE_CLASS_LIST[] = {
     &DOUBLE_CLASS,
     &OBJECT_CLASS,
     &STRING_CLASS,
+    &STRING_LATIN1_CLASS,
+    &STRING_UTF16_CLASS,
+    &ABSTRACT_STRING_BUILDER_CLASS,
     &SYSTEM_CLASS,
     &CHARACTER_CLASS,
     &PRINT_STREAM_CLASS,
+    &UNSAFE_CLASS,
+    &ATOMIC_LONG_CLASS,
+    &FORK_JOIN_POOL_CLASS,
+    &ATOMIC_INTEGER_CLASS,
+    &ATOMIC_REFERENCE_CLASS,
+    &ARRAYS_CLASS,
+    &HASH_MAP_CLASS,
+    &INT_INT_HASH_MAP_CLASS,
+    &INTEGER_CLASS,
+    &LONG_CLASS,
 };
 
 const uint32_t NATIVE_CLASS_COUNT = LENGTH(NATIVE_CLASS_LIST);
+
+NativeMethodEntry *NativeMethodTable::entries = 0;
+uint32_t NativeMethodTable::capacity = 0;
+uint32_t NativeMethodTable::count = 0;
+
+uint32_t NativeMethodTable::calcHash(const MjvmConstUtf8 &className, const MjvmConstUtf8 &name, const MjvmConstUtf8 &descriptor) {
+    /* the length and the crc of each string are already in its header */
+    uint32_t hash = CONST_UTF8_HASH(className);
+    hash = hash * 31 + CONST_UTF8_HASH(name);
+    hash = hash * 31 + CONST_UTF8_HASH(descriptor);
+    return hash ^ (hash >> 15);
+}
+
+void NativeMethodTable::grow(uint32_t minCount) {
+    uint32_t newCapacity = capacity ? capacity : 32;
+    while(newCapacity < (minCount << 1))
+        newCapacity <<= 1;
+    if(newCapacity == capacity)
+        return;
+    NativeMethodEntry *newEntries = (NativeMethodEntry *)Mjvm::malloc(newCapacity * sizeof(NativeMethodEntry));
+    memset(newEntries, 0, newCapacity * sizeof(NativeMethodEntry));
+    for(uint32_t i = 0; i < capacity; i++) {
+        if(entries[i].method) {
+            uint32_t index = entries[i].hash & (newCapacity - 1);
+            while(newEntries[index].method)
+                index = (index + 1) & (newCapacity - 1);
+            newEntries[index] = entries[i];
+        }
+    }
+    if(entries)
+        Mjvm::free(entries);
+    entries = newEntries;
+    capacity = newCapacity;
+}
+
+void NativeMethodTable::add(const NativeClass &nativeClass) {
+    grow(count + nativeClass.methodCount);
+    uint32_t mask = capacity - 1;
+    for(uint32_t i = 0; i < nativeClass.methodCount; i++) {
+        const NativeMethod &method = nativeClass.methods[i];
+        uint32_t hash = calcHash(nativeClass.className, method.name, method.descriptor);
+        uint32_t index = hash & mask;
+        while(entries[index].method) {
+            NativeMethodEntry &entry = entries[index];
+            if(
+                entry.hash == hash &&
+                entry.nativeClass->className == nativeClass.className &&
+                entry.method->name == method.name &&
+                entry.method->descriptor == method.descriptor
+            ) {
+                break;
+            }
+            index = (index + 1) & mask;
+        }
+        if(entries[index].method == 0)
+            count++;
+        entries[index].hash = hash;
+        entries[index].nativeClass = &nativeClass;
+        entries[index].method = &method;
+    }
+}
+
+void NativeMethodTable::init(void) {
+    uint32_t methodCount = 0;
+    for(uint32_t i = 0; i < NATIVE_CLASS_COUNT; i++)
+        methodCount += NATIVE_CLASS_LIST[i]->methodCount;
+    grow(methodCount);
+    for(uint32_t i = 0; i < NATIVE_CLASS_COUNT; i++)
+        add(*NATIVE_CLASS_LIST[i]);
+}
+
+void NativeMethodTable::registerClass(const NativeClass &nativeClass) {
+    if(entries == 0)
+        init();
+    add(nativeClass);
+}
+
+MjvmNativeMethodPtr NativeMethodTable::findMethod(const MjvmConstUtf8 &className, const MjvmConstUtf8 &name, const MjvmConstUtf8 &descriptor) {
+    if(entries == 0)
+        init();
+    uint32_t hash = calcHash(className, name, descriptor);
+    uint32_t mask = capacity - 1;
+    for(uint32_t index = hash & mask; entries[index].method; index = (index + 1) & mask) {
+        NativeMethodEntry &entry = entries[index];
+        if(
+            entry.hash == hash &&
+            entry.nativeClass->className == className &&
+            entry.method->name == name &&
+            entry.method->descriptor == descriptor
+        ) {
+            return entry.method->nativeMathod;
+        }
+    }
+    return 0;
+}
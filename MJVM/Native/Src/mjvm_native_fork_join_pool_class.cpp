@@ -0,0 +1,61 @@
+
+#include "mjvm.h"
+#include "mjvm_const_name.h"
+#include "mjvm_task_pool.h"
+#include "mjvm_native_fork_join_pool_class.h"
+
+static bool nativeCreate(MjvmExecution &execution) {
+    bool asyncMode = execution.stackPopInt32();
+    int32_t parallelism = execution.stackPopInt32();
+    MjvmObject *owner = execution.stackPopObject();
+    MjvmTaskPool &pool = execution.mjvm.newTaskPool(parallelism, asyncMode, owner);
+    execution.stackPushInt32((int32_t)&pool);
+    return true;
+}
+
+static bool nativeSubmit(MjvmExecution &execution) {
+    MjvmObject *task = execution.stackPopObject();
+    MjvmTaskPool *pool = (MjvmTaskPool *)execution.stackPopInt32();
+    execution.stackPushInt32(pool->execute(execution, task));
+    return true;
+}
+
+static bool nativeShutdown(MjvmExecution &execution) {
+    MjvmTaskPool *pool = (MjvmTaskPool *)execution.stackPopInt32();
+    pool->shutdown();
+    return true;
+}
+
+static bool nativeIsShutdown(MjvmExecution &execution) {
+    MjvmTaskPool *pool = (MjvmTaskPool *)execution.stackPopInt32();
+    execution.stackPushInt32(pool->isShutdown());
+    return true;
+}
+
+static bool nativeIsTerminated(MjvmExecution &execution) {
+    MjvmTaskPool *pool = (MjvmTaskPool *)execution.stackPopInt32();
+    execution.stackPushInt32(pool->isTerminated());
+    return true;
+}
+
+static bool nativeAwaitTermination(MjvmExecution &execution) {
+    int64_t timeout = execution.stackPopInt64();
+    MjvmTaskPool *pool = (MjvmTaskPool *)execution.stackPopInt32();
+    if(timeout < 0)
+        timeout = 0;
+    else if(timeout > 0xFFFFFFFF)
+        timeout = 0xFFFFFFFF;
+    execution.stackPushInt32(pool->awaitTermination(timeout));
+    return true;
+}
+
+static const NativeMethod methods[] = {
+    NATIVE_METHOD("\x06\x00\x74\x02""create",           "\x28\x00\xB0\x0E""(Ljava/util/concurrent/ForkJoinPool;IZ)I", nativeCreate),
+    NATIVE_METHOD("\x06\x00\x94\x02""submit",           "\x18\x00\x54\x08""(ILjava/lang/Runnable;)Z",                 nativeSubmit),
+    NATIVE_METHOD("\x08\x00\x7C\x03""shutdown",         "\x04\x00\xF0\x00""(I)V",                                     nativeShutdown),
+    NATIVE_METHOD("\x0A\x00\x38\x04""isShutdown",       "\x04\x00\xF4\x00""(I)Z",                                     nativeIsShutdown),
+    NATIVE_METHOD("\x0C\x00\xE9\x04""isTerminated",     "\x04\x00\xF4\x00""(I)Z",                                     nativeIsTerminated),
+    NATIVE_METHOD("\x10\x00\xA0\x06""awaitTermination", "\x05\x00\x3E\x01""(IJ)Z",                                    nativeAwaitTermination),
+};
+
+const NativeClass FORK_JOIN_POOL_CLASS = NATIVE_CLASS(forkJoinPoolClassName, methods);
@@ -0,0 +1,85 @@
+
+#include "mjvm.h"
+#include "mjvm_object.h"
+#include "mjvm_const_name.h"
+#include "mjvm_native_hash_map_class.h"
+
+/*
+ * The table of HashMap is made of three arrays with a power of two length, hashes, keys and values.
+ * A slot with hash 0 is empty, the stored hashes are never 0.
+ */
+static bool nativeProbe(MjvmExecution &execution) {
+    uint32_t index = execution.stackPopInt32();
+    int32_t hash = execution.stackPopInt32();
+    MjvmObject *hashes = execution.stackPopObject();
+    const int32_t *data = (const int32_t *)hashes->data;
+    uint32_t mask = hashes->size / sizeof(int32_t) - 1;
+    while(data[index] != hash && data[index] != 0)
+        index = (index + 1) & mask;
+    execution.stackPushInt32(index);
+    return true;
+}
+
+static bool nativeRehash(MjvmExecution &execution) {
+    MjvmObject **newValues = (MjvmObject **)execution.stackPopObject()->data;
+    MjvmObject **newKeys = (MjvmObject **)execution.stackPopObject()->data;
+    MjvmObject *newHashes = execution.stackPopObject();
+    MjvmObject **values = (MjvmObject **)execution.stackPopObject()->data;
+    MjvmObject **keys = (MjvmObject **)execution.stackPopObject()->data;
+    MjvmObject *hashes = execution.stackPopObject();
+    const int32_t *data = (const int32_t *)hashes->data;
+    int32_t *newData = (int32_t *)newHashes->data;
+    uint32_t length = hashes->size / sizeof(int32_t);
+    uint32_t mask = newHashes->size / sizeof(int32_t) - 1;
+    /* the references are moved under the lock like System.arraycopy does */
+    Mjvm::lock();
+    for(uint32_t i = 0; i < length; i++) {
+        int32_t hash = data[i];
+        if(hash == 0)
+            continue;
+        uint32_t index = hash & mask;
+        while(newData[index] != 0)
+            index = (index + 1) & mask;
+        newData[index] = hash;
+        newKeys[index] = keys[i];
+        newValues[index] = values[i];
+    }
+    Mjvm::unlock();
+    return true;
+}
+
+/*
+ * Backward shift deletion, the entries after the removed one move back when their probe passes through the hole.
+ * So the table never needs tombstones and the probe always stops at the first empty slot.
+ */
+static bool nativeRemoveAt(MjvmExecution &execution) {
+    uint32_t hole = execution.stackPopInt32();
+    MjvmObject **values = (MjvmObject **)execution.stackPopObject()->data;
+    MjvmObject **keys = (MjvmObject **)execution.stackPopObject()->data;
+    MjvmObject *hashes = execution.stackPopObject();
+    int32_t *data = (int32_t *)hashes->data;
+    uint32_t mask = hashes->size / sizeof(int32_t) - 1;
+    Mjvm::lock();
+    for(uint32_t index = (hole + 1) & mask; data[index] != 0; index = (index + 1) & mask) {
+        uint32_t home = data[index] & mask;
+        if(((index - home) & mask) >= ((index - hole) & mask)) {
+            data[hole] = data[index];
+            keys[hole] = keys[index];
+            values[hole] = values[index];
+            hole = index;
+        }
+    }
+    data[hole] = 0;
+    keys[hole] = 0;
+    values[hole] = 0;
+    Mjvm::unlock();
+    return true;
+}
+
+static const NativeMethod methods[] = {
+    NATIVE_METHOD("\x05\x00\x18\x02""probe",    "\x07\x00\xD0\x01""([III)I",                                                                               nativeProbe),
+    NATIVE_METHOD("\x06\x00\x7B\x02""rehash",   "\x53\x00\x5B\x1D""([I[Ljava/lang/Object;[Ljava/lang/Object;[I[Ljava/lang/Object;[Ljava/lang/Object;)V", nativeRehash),
+    NATIVE_METHOD("\x08\x00\x43\x03""removeAt", "\x2C\x00\x4A\x0F""([I[Ljava/lang/Object;[Ljava/lang/Object;I)V",                                         nativeRemoveAt),
+};
+
+const NativeClass HASH_MAP_CLASS = NATIVE_CLASS(hashMapClassName, methods);
@@ -0,0 +1,94 @@
+
+#include "mjvm.h"
+#include "mjvm_object.h"
+#include "mjvm_const_name.h"
+#include "mjvm_native_int_int_hash_map_class.h"
+
+/*
+ * The keys of IntIntHashMap are spread by the golden ratio multiplier, key 0 marks an empty slot.
+ * The arrays have a power of two length and at least one empty slot.
+ */
+static inline uint32_t getHomeIndex(int32_t key, uint32_t mask) {
+    uint32_t hash = (uint32_t)key * 0x9E3779B9;
+    return (hash ^ (hash >> 16)) & mask;
+}
+
+static int32_t indexOf(MjvmObject *keys, int32_t key) {
+    const int32_t *data = (const int32_t *)keys->data;
+    uint32_t mask = keys->size / sizeof(int32_t) - 1;
+    uint32_t index = getHomeIndex(key, mask);
+    while(data[index] != 0) {
+        if(data[index] == key)
+            return index;
+        index = (index + 1) & mask;
+    }
+    return -(int32_t)(index + 1);
+}
+
+static bool nativeIndexOf(MjvmExecution &execution) {
+    int32_t key = execution.stackPopInt32();
+    MjvmObject *keys = execution.stackPopObject();
+    execution.stackPushInt32(indexOf(keys, key));
+    return true;
+}
+
+static bool nativeGet(MjvmExecution &execution) {
+    int32_t defaultValue = execution.stackPopInt32();
+    int32_t key = execution.stackPopInt32();
+    MjvmObject *values = execution.stackPopObject();
+    MjvmObject *keys = execution.stackPopObject();
+    int32_t index = indexOf(keys, key);
+    execution.stackPushInt32((index >= 0) ? ((int32_t *)values->data)[index] : defaultValue);
+    return true;
+}
+
+static bool nativeRehash(MjvmExecution &execution) {
+    int32_t *newValues = (int32_t *)execution.stackPopObject()->data;
+    MjvmObject *newKeys = execution.stackPopObject();
+    const int32_t *values = (const int32_t *)execution.stackPopObject()->data;
+    MjvmObject *keys = execution.stackPopObject();
+    const int32_t *data = (const int32_t *)keys->data;
+    int32_t *newData = (int32_t *)newKeys->data;
+    uint32_t length = keys->size / sizeof(int32_t);
+    uint32_t mask = newKeys->size / sizeof(int32_t) - 1;
+    for(uint32_t i = 0; i < length; i++) {
+        int32_t key = data[i];
+        if(key == 0)
+            continue;
+        uint32_t index = getHomeIndex(key, mask);
+        while(newData[index] != 0)
+            index = (index + 1) & mask;
+        newData[index] = key;
+        newValues[index] = values[i];
+    }
+    return true;
+}
+
+/* backward shift deletion, the same as the one of HashMap */
+static bool nativeRemoveAt(MjvmExecution &execution) {
+    uint32_t hole = execution.stackPopInt32();
+    int32_t *values = (int32_t *)execution.stackPopObject()->data;
+    MjvmObject *keys = execution.stackPopObject();
+    int32_t *data = (int32_t *)keys->data;
+    uint32_t mask = keys->size / sizeof(int32_t) - 1;
+    for(uint32_t index = (hole + 1) & mask; data[index] != 0; index = (index + 1) & mask) {
+        uint32_t home = getHomeIndex(data[index], mask);
+        if(((index - home) & mask) >= ((index - hole) & mask)) {
+            data[hole] = data[index];
+            values[hole] = values[index];
+            hole = index;
+        }
+    }
+    data[hole] = 0;
+    values[hole] = 0;
+    return true;
+}
+
+static const NativeMethod methods[] = {
+    NATIVE_METHOD("\x07\x00\xCD\x02""indexOf",  "\x06\x00\x87\x01""([II)I",      nativeIndexOf),
+    NATIVE_METHOD("\x03\x00\x40\x01""get",      "\x09\x00\x74\x02""([I[III)I",   nativeGet),
+    NATIVE_METHOD("\x06\x00\x7B\x02""rehash",   "\x0B\x00\x37\x03""([I[I[I[I)V", nativeRehash),
+    NATIVE_METHOD("\x08\x00\x43\x03""removeAt", "\x08\x00\x38\x02""([I[II)V",    nativeRemoveAt),
+};
+
+const NativeClass INT_INT_HASH_MAP_CLASS = NATIVE_CLASS(intIntHashMapClassName, methods);
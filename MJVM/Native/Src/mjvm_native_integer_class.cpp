@@ -0,0 +1,51 @@
+
+#include <string.h>
+#include "mjvm.h"
+#include "mjvm_object.h"
+#include "mjvm_const_name.h"
+#include "mjvm_native_number_format.h"
+#include "mjvm_native_number_parse.h"
+#include "mjvm_native_integer_class.h"
+
+static MjvmString *newLatin1String(Mjvm &mjvm, const char *text, uint32_t length) {
+    MjvmString *strObj = mjvm.newString(length, 0);
+    memcpy((char *)strObj->getText(), text, length);
+    return strObj;
+}
+
+static bool nativeToString(MjvmExecution &execution) {
+    char buff[NUMBER_FORMAT_BUFF_SIZE];
+    int32_t value = execution.stackPopInt32();
+    uint32_t length = NumberFormat_Int32(value, buff);
+    execution.stackPushObject(newLatin1String(execution.mjvm, buff, length));
+    return true;
+}
+
+static bool nativeToStringRadix(MjvmExecution &execution) {
+    char buff[NUMBER_FORMAT_RADIX_BUFF_SIZE];
+    int32_t radix = execution.stackPopInt32();
+    int32_t value = execution.stackPopInt32();
+    if(radix < 2 || radix > 36)
+        radix = 10;
+    uint32_t length = NumberFormat_Int64Radix(value, radix, buff);
+    execution.stackPushObject(newLatin1String(execution.mjvm, buff, length));
+    return true;
+}
+
+static bool nativeParseInt(MjvmExecution &execution) {
+    int32_t radix = execution.stackPopInt32();
+    MjvmString *str = (MjvmString *)execution.stackPopObject();
+    int32_t value;
+    if(!NumberParse_Int32(execution, str, radix, value))
+        return false;
+    execution.stackPushInt32(value);
+    return true;
+}
+
+static const NativeMethod methods[] = {
+    NATIVE_METHOD("\x08\x00\x5A\x03""toString", "\x15\x00\x3A\x07""(I)Ljava/lang/String;",  nativeToString),
+    NATIVE_METHOD("\x08\x00\x5A\x03""toString", "\x16\x00\x83\x07""(II)Ljava/lang/String;", nativeToStringRadix),
+    NATIVE_METHOD("\x08\x00\x46\x03""parseInt", "\x16\x00\x83\x07""(Ljava/lang/String;I)I", nativeParseInt),
+};
+
+const NativeClass INTEGER_CLASS = NATIVE_CLASS(integerClassName, methods);
@@ -0,0 +1,161 @@
+
+#include <string.h>
+#include "mjvm.h"
+#include "mjvm_object.h"
+#include "mjvm_const_name.h"
+#include "mjvm_native_string_kernel.h"
+#include "mjvm_native_number_format.h"
+#include "mjvm_native_number_parse.h"
+
+#define NUMBER_PARSE_SUCCESS            -1
+
+static uint32_t NumberParse_Digit(uint32_t c) {
+    if((c - '0') < 10)
+        return c - '0';
+    c |= 0x20;
+    if((c - 'a') < 26)
+        return c - 'a' + 10;
+    return 36;
+}
+
+static bool NumberParse_IsEightDigits(uint64_t chunk) {
+    return ((chunk & 0xF0F0F0F0F0F0F0F0) | (((chunk + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) == 0x3333333333333333;
+}
+
+/* convert 8 ascii digits in one word, the first digit is in the lowest byte */
+static uint32_t NumberParse_EightDigits(uint64_t chunk) {
+    chunk -= 0x3030303030303030;
+    chunk = (chunk * 10) + (chunk >> 8);
+    chunk = (((chunk & 0x000000FF000000FF) * (100 + (1000000ULL << 32))) + (((chunk >> 16) & 0x000000FF000000FF) * (1 + (10000ULL << 32)))) >> 32;
+    return (uint32_t)chunk;
+}
+
+/*
+ * The value is accumulated as a negative number like Integer.parseInt does, so the minimum value is reached without overflow.
+ * maxSafeDigits is the number of digits that can never overflow T, the latin1 decimal strings take 8 digits at a time within it.
+ * Returns NUMBER_PARSE_SUCCESS or the index of the character where the parsing failed.
+ */
+template <class T>
+static int32_t NumberParse_Digits(const char *text, uint32_t length, uint8_t coder, uint32_t radix, T minValue, uint32_t maxSafeDigits, T &value) {
+    const uint8_t *latin1 = (const uint8_t *)text;
+    const uint16_t *utf16 = (const uint16_t *)text;
+    uint32_t i = 0;
+    bool negative = false;
+    T limit = minValue + 1;
+    uint32_t firstChar = coder ? utf16[0] : latin1[0];
+    if(firstChar < '0') {
+        if(firstChar == '-') {
+            negative = true;
+            limit = minValue;
+        }
+        else if(firstChar != '+')
+            return 0;
+        i++;
+        if(i == length)
+            return i;
+    }
+    T result = 0;
+    if(coder == 0 && radix == 10) {
+        uint32_t digitCount = 0;
+        while((length - i) >= 8 && (digitCount + 8) <= maxSafeDigits) {
+            uint64_t chunk;
+            memcpy(&chunk, &latin1[i], sizeof(chunk));
+            if(!NumberParse_IsEightDigits(chunk))
+                break;
+            result = result * 100000000 - (T)NumberParse_EightDigits(chunk);
+            digitCount += 8;
+            i += 8;
+        }
+    }
+    T multmin = limit / (T)radix;
+    for(; i < length; i++) {
+        uint32_t digit = NumberParse_Digit(coder ? utf16[i] : latin1[i]);
+        if(digit >= radix || result < multmin)
+            return i;
+        result *= (T)radix;
+        if(result < limit + (T)digit)
+            return i;
+        result -= (T)digit;
+    }
+    value = negative ? result : -result;
+    return NUMBER_PARSE_SUCCESS;
+}
+
+static void NumberParse_CopyText(uint8_t *dst, uint8_t coder, const char *text, uint32_t length) {
+    if(coder == 0)
+        memcpy(dst, text, length);
+    else
+        StringKernel_Inflate((const uint8_t *)text, (uint16_t *)dst, length);
+}
+
+static bool NumberParse_Throw(MjvmExecution &execution, const char *prefix, uint32_t prefixLength, MjvmString *str, const char *suffix, uint32_t suffixLength) {
+    uint32_t textLength = str ? str->getLength() : 0;
+    uint8_t coder = str ? str->getCoder() : 0;
+    MjvmString *strObj = execution.mjvm.newString(prefixLength + textLength + suffixLength, coder);
+    uint8_t *buff = (uint8_t *)strObj->getText();
+    NumberParse_CopyText(buff, coder, prefix, prefixLength);
+    buff += prefixLength << coder;
+    if(textLength) {
+        memcpy(buff, str->getText(), textLength << coder);
+        buff += textLength << coder;
+    }
+    NumberParse_CopyText(buff, coder, suffix, suffixLength);
+    MjvmThrowable *excpObj = execution.mjvm.newThrowable(strObj, *(MjvmConstUtf8 *)&numberFormatExceptionClassName);
+    execution.stackPushObject(excpObj);
+    return false;
+}
+
+static bool NumberParse_ThrowRadix(MjvmExecution &execution, int32_t radix) {
+    char buff[48];
+    uint32_t length = sizeof("radix ") - 1;
+    memcpy(buff, "radix ", length);
+    length += NumberFormat_Int32(radix, &buff[length]);
+    if(radix < 2) {
+        memcpy(&buff[length], " less than 2", sizeof(" less than 2") - 1);
+        length += sizeof(" less than 2") - 1;
+    }
+    else {
+        memcpy(&buff[length], " greater than 36", sizeof(" greater than 36") - 1);
+        length += sizeof(" greater than 36") - 1;
+    }
+    return NumberParse_Throw(execution, buff, length, 0, 0, 0);
+}
+
+template <class T>
+static bool NumberParse_Parse(MjvmExecution &execution, MjvmString *str, int32_t radix, T minValue, uint32_t maxSafeDigits, T &value) {
+    if(str == 0)
+        return NumberParse_Throw(execution, STR_AND_SIZE("Cannot parse null string"), 0, 0, 0);
+    else if(radix < 2 || radix > 36)
+        return NumberParse_ThrowRadix(execution, radix);
+    uint32_t length = str->getLength();
+    if(length == 0) {
+        char buff[32];
+        uint32_t suffixLength = 1;
+        buff[0] = '"';
+        if(radix != 10) {
+            memcpy(&buff[1], " under radix ", sizeof(" under radix ") - 1);
+            suffixLength += sizeof(" under radix ") - 1;
+            suffixLength += NumberFormat_Int32(radix, &buff[suffixLength]);
+        }
+        return NumberParse_Throw(execution, STR_AND_SIZE("For input string: \""), 0, buff, suffixLength);
+    }
+    int32_t errorIndex = NumberParse_Digits<T>(str->getText(), length, str->getCoder(), radix, minValue, maxSafeDigits, value);
+    if(errorIndex != NUMBER_PARSE_SUCCESS) {
+        char buff[40];
+        uint32_t prefixLength = sizeof("Error at index ") - 1;
+        memcpy(buff, "Error at index ", prefixLength);
+        prefixLength += NumberFormat_Int32(errorIndex, &buff[prefixLength]);
+        memcpy(&buff[prefixLength], " in: \"", sizeof(" in: \"") - 1);
+        prefixLength += sizeof(" in: \"") - 1;
+        return NumberParse_Throw(execution, buff, prefixLength, str, STR_AND_SIZE("\""));
+    }
+    return true;
+}
+
+bool NumberParse_Int32(MjvmExecution &execution, MjvmString *str, int32_t radix, int32_t &value) {
+    return NumberParse_Parse<int32_t>(execution, str, radix, INT32_MIN, 9, value);
+}
+
+bool NumberParse_Int64(MjvmExecution &execution, MjvmString *str, int32_t radix, int64_t &value) {
+    return NumberParse_Parse<int64_t>(execution, str, radix, INT64_MIN, 18, value);
+}
@@ -10,8 +10,15 @@ static bool nativeIntern(MjvmExecution &execution) {
     return true;
 }
 
+static bool nativeHashCode(MjvmExecution &execution) {
+    MjvmString *obj = (MjvmString *)execution.stackPopObject();
+    execution.stackPushInt32(obj->getHashCode());
+    return true;
+}
+
 static const NativeMethod methods[] = {
-    NATIVE_METHOD("\x06\x00\x90\x02""intern", "\x14\x00\xF1\x06""()Ljava/lang/String;", nativeIntern),
+    NATIVE_METHOD("\x06\x00\x90\x02""intern",   "\x14\x00\xF1\x06""()Ljava/lang/String;", nativeIntern),
+    NATIVE_METHOD("\x08\x00\x1F\x03""hashCode", "\x03\x00\x9A\x00""()I",                  nativeHashCode),
 };
 
 const NativeClass STRING_CLASS = NATIVE_CLASS(stringClassName, methods);
@@ -0,0 +1,357 @@
+
+#include <string.h>
+#include "mjvm_native_string_kernel.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+
+#define VECTOR_SIZE                 32
+#define VECTOR_FULL_MASK            0xFFFFFFFF
+
+typedef __m256i StringVector;
+
+#define VectorLoad(p)               _mm256_loadu_si256((const __m256i *)(p))
+#define VectorStore(p, v)           _mm256_storeu_si256((__m256i *)(p), v)
+#define VectorSet8(c)               _mm256_set1_epi8((char)(c))
+#define VectorSet16(c)              _mm256_set1_epi16((short)(c))
+#define VectorZero()                _mm256_setzero_si256()
+#define VectorCmpEq8(a, b)          _mm256_cmpeq_epi8(a, b)
+#define VectorCmpEq16(a, b)         _mm256_cmpeq_epi16(a, b)
+#define VectorAnd(a, b)             _mm256_and_si256(a, b)
+#define VectorAndNot(a, b)          _mm256_andnot_si256(a, b)
+#define VectorOr(a, b)              _mm256_or_si256(a, b)
+#define VectorAdd8(a, b)            _mm256_add_epi8(a, b)
+#define VectorSub8(a, b)            _mm256_sub_epi8(a, b)
+#define VectorMinU8(a, b)           _mm256_min_epu8(a, b)
+#define VectorMask(v)               ((uint32_t)_mm256_movemask_epi8(v))
+
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+
+#define VECTOR_SIZE                 16
+#define VECTOR_FULL_MASK            0xFFFF
+
+typedef __m128i StringVector;
+
+#define VectorLoad(p)               _mm_loadu_si128((const __m128i *)(p))
+#define VectorStore(p, v)           _mm_storeu_si128((__m128i *)(p), v)
+#define VectorSet8(c)               _mm_set1_epi8((char)(c))
+#define VectorSet16(c)              _mm_set1_epi16((short)(c))
+#define VectorZero()                _mm_setzero_si128()
+#define VectorCmpEq8(a, b)          _mm_cmpeq_epi8(a, b)
+#define VectorCmpEq16(a, b)         _mm_cmpeq_epi16(a, b)
+#define VectorAnd(a, b)             _mm_and_si128(a, b)
+#define VectorAndNot(a, b)          _mm_andnot_si128(a, b)
+#define VectorOr(a, b)              _mm_or_si128(a, b)
+#define VectorAdd8(a, b)            _mm_add_epi8(a, b)
+#define VectorSub8(a, b)            _mm_sub_epi8(a, b)
+#define VectorMinU8(a, b)           _mm_min_epu8(a, b)
+#define VectorMask(v)               ((uint32_t)_mm_movemask_epi8(v))
+
+#endif
+
+#define FIRST_BIT(mask)             ((uint32_t)__builtin_ctz(mask))
+#define LAST_BIT(mask)              (31 - (uint32_t)__builtin_clz(mask))
+
+static inline bool StringKernel_IsUpper8(uint8_t c) {
+    return ((uint8_t)(c - 'A') <= ('Z' - 'A')) || (((uint8_t)(c - 0xC0) <= (0xDE - 0xC0)) && (c != 0xD7));
+}
+
+static inline bool StringKernel_IsLower8(uint8_t c) {
+    return ((uint8_t)(c - 'a') <= ('z' - 'a')) || (((uint8_t)(c - 0xE0) <= (0xFE - 0xE0)) && (c != 0xF7));
+}
+
+static inline bool StringKernel_IsCase8(uint8_t c, bool isToUpper) {
+    return isToUpper ? StringKernel_IsLower8(c) : StringKernel_IsUpper8(c);
+}
+
+static inline uint8_t StringKernel_ToLower8(uint8_t c) {
+    return StringKernel_IsUpper8(c) ? (c + 32) : c;
+}
+
+#ifdef VECTOR_SIZE
+/* 0xFF for each byte in [first, last] except the multiplication or division sign in the middle of the range */
+static inline StringVector StringKernel_CaseMask(StringVector value, bool isToUpper) {
+    uint8_t first = isToUpper ? 'a' : 'A';
+    uint8_t accentFirst = isToUpper ? 0xE0 : 0xC0;
+    uint8_t sign = isToUpper ? 0xF7 : 0xD7;
+    StringVector temp = VectorSub8(value, VectorSet8(first));
+    StringVector ret = VectorCmpEq8(VectorMinU8(temp, VectorSet8('Z' - 'A')), temp);
+    temp = VectorSub8(value, VectorSet8(accentFirst));
+    temp = VectorCmpEq8(VectorMinU8(temp, VectorSet8(0xDE - 0xC0)), temp);
+    temp = VectorAndNot(VectorCmpEq8(value, VectorSet8(sign)), temp);
+    return VectorOr(ret, temp);
+}
+
+static inline StringVector StringKernel_ToLowerVector(StringVector value) {
+    return VectorAdd8(value, VectorAnd(StringKernel_CaseMask(value, false), VectorSet8(0x20)));
+}
+#endif
+
+int32_t StringKernel_IndexOf8(const uint8_t *data, uint32_t length, uint8_t c) {
+    uint32_t i = 0;
+#ifdef VECTOR_SIZE
+    StringVector key = VectorSet8(c);
+    for(; (i + VECTOR_SIZE) <= length; i += VECTOR_SIZE) {
+        uint32_t mask = VectorMask(VectorCmpEq8(VectorLoad(&data[i]), key));
+        if(mask)
+            return i + FIRST_BIT(mask);
+    }
+#endif
+    const uint8_t *ret = (const uint8_t *)memchr(&data[i], c, length - i);
+    return ret ? (ret - data) : -1;
+}
+
+int32_t StringKernel_IndexOf16(const uint16_t *data, uint32_t length, uint16_t c) {
+    uint32_t i = 0;
+#ifdef VECTOR_SIZE
+    StringVector key = VectorSet16(c);
+    for(; (i + VECTOR_SIZE / 2) <= length; i += VECTOR_SIZE / 2) {
+        uint32_t mask = VectorMask(VectorCmpEq16(VectorLoad(&data[i]), key));
+        if(mask)
+            return i + (FIRST_BIT(mask) >> 1);
+    }
+#endif
+    for(; i < length; i++) {
+        if(data[i] == c)
+            return i;
+    }
+    return -1;
+}
+
+int32_t StringKernel_LastIndexOf8(const uint8_t *data, uint32_t length, uint8_t c) {
+    uint32_t i = length;
+#ifdef VECTOR_SIZE
+    StringVector key = VectorSet8(c);
+    for(; i >= VECTOR_SIZE; i -= VECTOR_SIZE) {
+        uint32_t mask = VectorMask(VectorCmpEq8(VectorLoad(&data[i - VECTOR_SIZE]), key));
+        if(mask)
+            return i - VECTOR_SIZE + LAST_BIT(mask);
+    }
+#endif
+    while(i--) {
+        if(data[i] == c)
+            return i;
+    }
+    return -1;
+}
+
+int32_t StringKernel_LastIndexOf16(const uint16_t *data, uint32_t length, uint16_t c) {
+    uint32_t i = length;
+#ifdef VECTOR_SIZE
+    StringVector key = VectorSet16(c);
+    for(; i >= VECTOR_SIZE / 2; i -= VECTOR_SIZE / 2) {
+        uint32_t mask = VectorMask(VectorCmpEq16(VectorLoad(&data[i - VECTOR_SIZE / 2]), key));
+        if(mask)
+            return i - VECTOR_SIZE / 2 + (LAST_BIT(mask) >> 1);
+    }
+#endif
+    while(i--) {
+        if(data[i] == c)
+            return i;
+    }
+    return -1;
+}
+
+uint32_t StringKernel_Mismatch(const uint8_t *data1, const uint8_t *data2, uint32_t length) {
+    uint32_t i = 0;
+#ifdef VECTOR_SIZE
+    for(; (i + VECTOR_SIZE) <= length; i += VECTOR_SIZE) {
+        uint32_t mask = VectorMask(VectorCmpEq8(VectorLoad(&data1[i]), VectorLoad(&data2[i])));
+        if(mask != VECTOR_FULL_MASK)
+            return i + FIRST_BIT(~mask);
+    }
+#endif
+    for(; i < length; i++) {
+        if(data1[i] != data2[i])
+            return i;
+    }
+    return length;
+}
+
+/*
+ * The hash is s[0] * 31^(n - 1) + s[1] * 31^(n - 2) + ... + s[n - 1] like in Java.
+ * With AVX2 each of the 8 lanes sums every 8th character, the lanes are weighted by 31^7 ... 31^0 at the end.
+ * Without it 4 characters are added per step to shorten the dependency chain of the multiplications.
+ */
+#ifdef __AVX2__
+#define HASH_MULTIPLIER_8           ((int)0x94446F01)   /* 31^8 truncated to 32 bits */
+
+static uint32_t StringKernel_HashLanes(__m256i lanes) {
+    uint32_t values[8];
+    uint32_t hash = 0;
+    _mm256_storeu_si256((__m256i *)values, lanes);
+    for(uint32_t i = 0; i < 8; i++)
+        hash = hash * 31 + values[i];
+    return hash;
+}
+#endif
+
+int32_t StringKernel_HashCode8(const uint8_t *data, uint32_t length) {
+    uint32_t i = 0;
+    uint32_t hash = 0;
+#ifdef __AVX2__
+    if(length >= 8) {
+        __m256i lanes = _mm256_setzero_si256();
+        __m256i multiplier = _mm256_set1_epi32(HASH_MULTIPLIER_8);
+        for(; (i + 8) <= length; i += 8) {
+            __m256i value = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)&data[i]));
+            lanes = _mm256_add_epi32(_mm256_mullo_epi32(lanes, multiplier), value);
+        }
+        hash = StringKernel_HashLanes(lanes);
+    }
+#endif
+    for(; (i + 4) <= length; i += 4)
+        hash = hash * (31 * 31 * 31 * 31) + data[i] * (31 * 31 * 31) + data[i + 1] * (31 * 31) + data[i + 2] * 31 + data[i + 3];
+    for(; i < length; i++)
+        hash = hash * 31 + data[i];
+    return hash;
+}
+
+int32_t StringKernel_HashCode16(const uint16_t *data, uint32_t length) {
+    uint32_t i = 0;
+    uint32_t hash = 0;
+#ifdef __AVX2__
+    if(length >= 8) {
+        __m256i lanes = _mm256_setzero_si256();
+        __m256i multiplier = _mm256_set1_epi32(HASH_MULTIPLIER_8);
+        for(; (i + 8) <= length; i += 8) {
+            __m256i value = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)&data[i]));
+            lanes = _mm256_add_epi32(_mm256_mullo_epi32(lanes, multiplier), value);
+        }
+        hash = StringKernel_HashLanes(lanes);
+    }
+#endif
+    for(; (i + 4) <= length; i += 4)
+        hash = hash * (31 * 31 * 31 * 31) + data[i] * (31 * 31 * 31) + data[i + 1] * (31 * 31) + data[i + 2] * 31 + data[i + 3];
+    for(; i < length; i++)
+        hash = hash * 31 + data[i];
+    return hash;
+}
+
+bool StringKernel_IsLatin1(const uint16_t *data, uint32_t length) {
+    uint32_t i = 0;
+#ifdef VECTOR_SIZE
+    StringVector highByte = VectorSet16(0xFF00);
+    for(; (i + VECTOR_SIZE / 2) <= length; i += VECTOR_SIZE / 2) {
+        StringVector temp = VectorAnd(VectorLoad(&data[i]), highByte);
+        if(VectorMask(VectorCmpEq8(temp, VectorZero())) != VECTOR_FULL_MASK)
+            return false;
+    }
+#endif
+    for(; i < length; i++) {
+        if(data[i] > 0xFF)
+            return false;
+    }
+    return true;
+}
+
+void StringKernel_Inflate(const uint8_t *src, uint16_t *dst, uint32_t length) {
+    uint32_t i = 0;
+#ifdef __SSE2__
+    /* unpacking works within 128 bit lanes, so this one stays on SSE2 even with AVX2 */
+    __m128i zero = _mm_setzero_si128();
+    for(; (i + 16) <= length; i += 16) {
+        __m128i value = _mm_loadu_si128((const __m128i *)&src[i]);
+        _mm_storeu_si128((__m128i *)&dst[i], _mm_unpacklo_epi8(value, zero));
+        _mm_storeu_si128((__m128i *)&dst[i + 8], _mm_unpackhi_epi8(value, zero));
+    }
+#endif
+    for(; i < length; i++)
+        dst[i] = src[i];
+}
+
+void StringKernel_Compress(const uint16_t *src, uint8_t *dst, uint32_t length) {
+    uint32_t i = 0;
+#ifdef __SSE2__
+    /* the caller has checked all characters are latin1 so the saturation never happens */
+    for(; (i + 16) <= length; i += 16) {
+        __m128i value1 = _mm_loadu_si128((const __m128i *)&src[i]);
+        __m128i value2 = _mm_loadu_si128((const __m128i *)&src[i + 8]);
+        _mm_storeu_si128((__m128i *)&dst[i], _mm_packus_epi16(value1, value2));
+    }
+#endif
+    for(; i < length; i++)
+        dst[i] = (uint8_t)src[i];
+}
+
+void StringKernel_Replace8(const uint8_t *src, uint8_t *dst, uint32_t length, uint8_t oldChar, uint8_t newChar) {
+    uint32_t i = 0;
+#ifdef VECTOR_SIZE
+    StringVector oldValue = VectorSet8(oldChar);
+    StringVector newValue = VectorSet8(newChar);
+    for(; (i + VECTOR_SIZE) <= length; i += VECTOR_SIZE) {
+        StringVector value = VectorLoad(&src[i]);
+        StringVector mask = VectorCmpEq8(value, oldValue);
+        VectorStore(&dst[i], VectorOr(VectorAndNot(mask, value), VectorAnd(mask, newValue)));
+    }
+#endif
+    for(; i < length; i++)
+        dst[i] = (src[i] == oldChar) ? newChar : src[i];
+}
+
+void StringKernel_Replace16(const uint16_t *src, uint16_t *dst, uint32_t length, uint16_t oldChar, uint16_t newChar) {
+    uint32_t i = 0;
+#ifdef VECTOR_SIZE
+    StringVector oldValue = VectorSet16(oldChar);
+    StringVector newValue = VectorSet16(newChar);
+    for(; (i + VECTOR_SIZE / 2) <= length; i += VECTOR_SIZE / 2) {
+        StringVector value = VectorLoad(&src[i]);
+        StringVector mask = VectorCmpEq16(value, oldValue);
+        VectorStore(&dst[i], VectorOr(VectorAndNot(mask, value), VectorAnd(mask, newValue)));
+    }
+#endif
+    for(; i < length; i++)
+        dst[i] = (src[i] == oldChar) ? newChar : src[i];
+}
+
+int32_t StringKernel_FindCase8(const uint8_t *data, uint32_t length, bool isToUpper) {
+    uint32_t i = 0;
+#ifdef VECTOR_SIZE
+    for(; (i + VECTOR_SIZE) <= length; i += VECTOR_SIZE) {
+        uint32_t mask = VectorMask(StringKernel_CaseMask(VectorLoad(&data[i]), isToUpper));
+        if(mask)
+            return i + FIRST_BIT(mask);
+    }
+#endif
+    for(; i < length; i++) {
+        if(StringKernel_IsCase8(data[i], isToUpper))
+            return i;
+    }
+    return -1;
+}
+
+void StringKernel_ConvertCase8(const uint8_t *src, uint8_t *dst, uint32_t length, bool isToUpper) {
+    uint32_t i = 0;
+#ifdef VECTOR_SIZE
+    StringVector caseBit = VectorSet8(0x20);
+    for(; (i + VECTOR_SIZE) <= length; i += VECTOR_SIZE) {
+        StringVector value = VectorLoad(&src[i]);
+        StringVector diff = VectorAnd(StringKernel_CaseMask(value, isToUpper), caseBit);
+        VectorStore(&dst[i], isToUpper ? VectorSub8(value, diff) : VectorAdd8(value, diff));
+    }
+#endif
+    for(; i < length; i++) {
+        uint8_t c = src[i];
+        if(StringKernel_IsCase8(c, isToUpper))
+            c = isToUpper ? (c - 32) : (c + 32);
+        dst[i] = c;
+    }
+}
+
+bool StringKernel_EqualsIgnoreCase8(const uint8_t *data1, const uint8_t *data2, uint32_t length) {
+    uint32_t i = 0;
+#ifdef VECTOR_SIZE
+    for(; (i + VECTOR_SIZE) <= length; i += VECTOR_SIZE) {
+        StringVector value1 = StringKernel_ToLowerVector(VectorLoad(&data1[i]));
+        StringVector value2 = StringKernel_ToLowerVector(VectorLoad(&data2[i]));
+        if(VectorMask(VectorCmpEq8(value1, value2)) != VECTOR_FULL_MASK)
+            return false;
+    }
+#endif
+    for(; i < length; i++) {
+        if(data1[i] != data2[i] && StringKernel_ToLower8(data1[i]) != StringKernel_ToLower8(data2[i]))
+            return false;
+    }
+    return true;
+}
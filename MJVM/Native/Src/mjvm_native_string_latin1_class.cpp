@@ -0,0 +1,191 @@
+
+#include <string.h>
+#include "mjvm.h"
+#include "mjvm_object.h"
+#include "mjvm_const_name.h"
+#include "mjvm_native_string_kernel.h"
+#include "mjvm_native_string_latin1_class.h"
+
+static int32_t indexOf(const MjvmObject *value, const MjvmObject *str, int32_t fromIndex) {
+    int32_t count = value->size;
+    int32_t strCount = str->size;
+    if(fromIndex >= count)
+        return (strCount == 0) ? count : -1;
+    if(fromIndex < 0)
+        fromIndex = 0;
+    if(strCount == 0)
+        return fromIndex;
+    const uint8_t *data = value->data;
+    const uint8_t *strData = str->data;
+    int32_t max = count - strCount;
+    for(int32_t i = fromIndex; i <= max; i++) {
+        int32_t index = StringKernel_IndexOf8(&data[i], max - i + 1, strData[0]);
+        if(index < 0)
+            return -1;
+        i += index;
+        if(memcmp(&data[i + 1], &strData[1], strCount - 1) == 0)
+            return i;
+    }
+    return -1;
+}
+
+static int32_t lastIndexOf(const MjvmObject *value, const MjvmObject *str, int32_t fromIndex) {
+    int32_t strCount = str->size;
+    int32_t rightIndex = value->size - strCount;
+    if(fromIndex > rightIndex)
+        fromIndex = rightIndex;
+    if(fromIndex < 0)
+        return -1;
+    if(strCount == 0)
+        return fromIndex;
+    const uint8_t *data = value->data;
+    const uint8_t *strData = str->data;
+    for(int32_t i = fromIndex; i >= 0; i--) {
+        i = StringKernel_LastIndexOf8(data, i + 1, strData[0]);
+        if(i < 0)
+            return -1;
+        if(memcmp(&data[i + 1], &strData[1], strCount - 1) == 0)
+            return i;
+    }
+    return -1;
+}
+
+static bool nativeIndexOf(MjvmExecution &execution) {
+    int32_t fromIndex = execution.stackPopInt32();
+    int32_t ch = execution.stackPopInt32();
+    MjvmObject *value = execution.stackPopObject();
+    int32_t count = value->size;
+    if(fromIndex < 0)
+        fromIndex = 0;
+    if(ch < 0 || ch > 0xFF || fromIndex >= count)
+        execution.stackPushInt32(-1);
+    else {
+        int32_t index = StringKernel_IndexOf8(&value->data[fromIndex], count - fromIndex, ch);
+        execution.stackPushInt32((index < 0) ? -1 : (index + fromIndex));
+    }
+    return true;
+}
+
+static bool nativeIndexOfString(MjvmExecution &execution) {
+    int32_t fromIndex = execution.stackPopInt32();
+    MjvmObject *str = execution.stackPopObject();
+    MjvmObject *value = execution.stackPopObject();
+    execution.stackPushInt32(indexOf(value, str, fromIndex));
+    return true;
+}
+
+static bool nativeLastIndexOf(MjvmExecution &execution) {
+    int32_t fromIndex = execution.stackPopInt32();
+    int32_t ch = execution.stackPopInt32();
+    MjvmObject *value = execution.stackPopObject();
+    if(fromIndex >= (int32_t)value->size)
+        fromIndex = value->size - 1;
+    if(ch < 0 || ch > 0xFF || fromIndex < 0)
+        execution.stackPushInt32(-1);
+    else
+        execution.stackPushInt32(StringKernel_LastIndexOf8(value->data, fromIndex + 1, ch));
+    return true;
+}
+
+static bool nativeLastIndexOfString(MjvmExecution &execution) {
+    int32_t fromIndex = execution.stackPopInt32();
+    MjvmObject *str = execution.stackPopObject();
+    MjvmObject *value = execution.stackPopObject();
+    execution.stackPushInt32(lastIndexOf(value, str, fromIndex));
+    return true;
+}
+
+static bool nativeReplace(MjvmExecution &execution) {
+    uint16_t newChar = execution.stackPopInt32();
+    uint16_t oldChar = execution.stackPopInt32();
+    MjvmObject *value = execution.stackPopObject();
+    uint32_t length = value->size;
+    int32_t index = (oldChar > 0xFF) ? -1 : StringKernel_IndexOf8(value->data, length, oldChar);
+    if(index < 0) {
+        /* nothing to replace, the caller keeps the original string */
+        execution.stackPushObject(0);
+        return true;
+    }
+    if(newChar <= 0xFF) {
+        MjvmString *strObj = execution.mjvm.newString(length, 0);
+        uint8_t *data = (uint8_t *)strObj->getText();
+        memcpy(data, value->data, index);
+        StringKernel_Replace8(&value->data[index], &data[index], length - index, oldChar, newChar);
+        execution.stackPushObject(strObj);
+    }
+    else {
+        MjvmString *strObj = execution.mjvm.newString(length, 1);
+        uint16_t *data = (uint16_t *)strObj->getText();
+        StringKernel_Inflate(value->data, data, length);
+        StringKernel_Replace16(&data[index], &data[index], length - index, oldChar, newChar);
+        execution.stackPushObject(strObj);
+    }
+    return true;
+}
+
+static bool convertCase(MjvmExecution &execution, bool isToUpper) {
+    MjvmObject *value = execution.stackPopObject();
+    uint32_t length = value->size;
+    int32_t index = StringKernel_FindCase8(value->data, length, isToUpper);
+    if(index < 0) {
+        execution.stackPushObject(0);
+        return true;
+    }
+    MjvmString *strObj = execution.mjvm.newString(length, 0);
+    uint8_t *data = (uint8_t *)strObj->getText();
+    memcpy(data, value->data, index);
+    StringKernel_ConvertCase8(&value->data[index], &data[index], length - index, isToUpper);
+    execution.stackPushObject(strObj);
+    return true;
+}
+
+static bool nativeToLower(MjvmExecution &execution) {
+    return convertCase(execution, false);
+}
+
+static bool nativeToUpper(MjvmExecution &execution) {
+    return convertCase(execution, true);
+}
+
+static bool nativeCompareTo(MjvmExecution &execution) {
+    MjvmObject *other = execution.stackPopObject();
+    MjvmObject *value = execution.stackPopObject();
+    uint32_t lim = (value->size < other->size) ? value->size : other->size;
+    uint32_t index = StringKernel_Mismatch(value->data, other->data, lim);
+    if(index < lim)
+        execution.stackPushInt32((int32_t)value->data[index] - (int32_t)other->data[index]);
+    else
+        execution.stackPushInt32((int32_t)value->size - (int32_t)other->size);
+    return true;
+}
+
+static bool nativeEquals(MjvmExecution &execution) {
+    MjvmObject *other = execution.stackPopObject();
+    MjvmObject *value = execution.stackPopObject();
+    uint32_t length = value->size;
+    execution.stackPushInt32((length == other->size) && (StringKernel_Mismatch(value->data, other->data, length) == length));
+    return true;
+}
+
+static bool nativeEqualsIgnoreCase(MjvmExecution &execution) {
+    MjvmObject *other = execution.stackPopObject();
+    MjvmObject *value = execution.stackPopObject();
+    uint32_t length = value->size;
+    execution.stackPushInt32((length == other->size) && StringKernel_EqualsIgnoreCase8(value->data, other->data, length));
+    return true;
+}
+
+static const NativeMethod methods[] = {
+    NATIVE_METHOD("\x07\x00\xCD\x02""indexOf",          "\x07\x00\xC9\x01""([BII)I",                  nativeIndexOf),
+    NATIVE_METHOD("\x07\x00\xCD\x02""indexOf",          "\x08\x00\x1D\x02""([B[BI)I",                 nativeIndexOfString),
+    NATIVE_METHOD("\x0B\x00\x61\x04""lastIndexOf",      "\x07\x00\xC9\x01""([BII)I",                  nativeLastIndexOf),
+    NATIVE_METHOD("\x0B\x00\x61\x04""lastIndexOf",      "\x08\x00\x1D\x02""([B[BI)I",                 nativeLastIndexOfString),
+    NATIVE_METHOD("\x07\x00\xDC\x02""replace",          "\x18\x00\x14\x08""([BCC)Ljava/lang/String;", nativeReplace),
+    NATIVE_METHOD("\x07\x00\xEC\x02""toLower",          "\x16\x00\x8E\x07""([B)Ljava/lang/String;",   nativeToLower),
+    NATIVE_METHOD("\x07\x00\xEF\x02""toUpper",          "\x16\x00\x8E\x07""([B)Ljava/lang/String;",   nativeToUpper),
+    NATIVE_METHOD("\x09\x00\xAA\x03""compareTo",        "\x07\x00\xD4\x01""([B[B)I",                  nativeCompareTo),
+    NATIVE_METHOD("\x06\x00\x8B\x02""equals",           "\x07\x00\xE5\x01""([B[B)Z",                  nativeEquals),
+    NATIVE_METHOD("\x10\x00\x6B\x06""equalsIgnoreCase", "\x07\x00\xE5\x01""([B[B)Z",                  nativeEqualsIgnoreCase),
+};
+
+const NativeClass STRING_LATIN1_CLASS = NATIVE_CLASS(stringLatin1ClassName, methods);
@@ -0,0 +1,249 @@
+
+#include <string.h>
+#include "mjvm.h"
+#include "mjvm_object.h"
+#include "mjvm_const_name.h"
+#include "mjvm_native_string_kernel.h"
+#include "mjvm_native_character_class.h"
+#include "mjvm_native_string_utf16_class.h"
+
+static bool isLatin1Match(const uint16_t *data, const uint8_t *str, uint32_t length) {
+    for(uint32_t i = 0; i < length; i++) {
+        if(data[i] != str[i])
+            return false;
+    }
+    return true;
+}
+
+static int32_t indexOf(const MjvmObject *value, const MjvmObject *str, int32_t fromIndex, bool isLatin1) {
+    int32_t count = value->size >> 1;
+    int32_t strCount = isLatin1 ? str->size : (str->size >> 1);
+    if(fromIndex >= count)
+        return (strCount == 0) ? count : -1;
+    if(fromIndex < 0)
+        fromIndex = 0;
+    if(strCount == 0)
+        return fromIndex;
+    const uint16_t *data = (const uint16_t *)value->data;
+    uint16_t first = isLatin1 ? str->data[0] : ((const uint16_t *)str->data)[0];
+    int32_t max = count - strCount;
+    for(int32_t i = fromIndex; i <= max; i++) {
+        int32_t index = StringKernel_IndexOf16(&data[i], max - i + 1, first);
+        if(index < 0)
+            return -1;
+        i += index;
+        if(isLatin1) {
+            if(isLatin1Match(&data[i + 1], &str->data[1], strCount - 1))
+                return i;
+        }
+        else if(memcmp(&data[i + 1], &str->data[2], (strCount - 1) << 1) == 0)
+            return i;
+    }
+    return -1;
+}
+
+static int32_t lastIndexOf(const MjvmObject *value, const MjvmObject *str, int32_t fromIndex, bool isLatin1) {
+    int32_t strCount = isLatin1 ? str->size : (str->size >> 1);
+    int32_t rightIndex = (value->size >> 1) - strCount;
+    if(fromIndex > rightIndex)
+        fromIndex = rightIndex;
+    if(fromIndex < 0)
+        return -1;
+    if(strCount == 0)
+        return fromIndex;
+    const uint16_t *data = (const uint16_t *)value->data;
+    uint16_t first = isLatin1 ? str->data[0] : ((const uint16_t *)str->data)[0];
+    for(int32_t i = fromIndex; i >= 0; i--) {
+        i = StringKernel_LastIndexOf16(data, i + 1, first);
+        if(i < 0)
+            return -1;
+        if(isLatin1) {
+            if(isLatin1Match(&data[i + 1], &str->data[1], strCount - 1))
+                return i;
+        }
+        else if(memcmp(&data[i + 1], &str->data[2], (strCount - 1) << 1) == 0)
+            return i;
+    }
+    return -1;
+}
+
+static inline uint16_t toCase(uint16_t c, bool isToUpper) {
+    /* ascii letters are the common case, the table search is only needed for the others */
+    if(c < 0x80) {
+        if(isToUpper)
+            return ((uint16_t)(c - 'a') <= ('z' - 'a')) ? (c - 32) : c;
+        return ((uint16_t)(c - 'A') <= ('Z' - 'A')) ? (c + 32) : c;
+    }
+    return isToUpper ? Character_ToUpper(c) : Character_ToLower(c);
+}
+
+static bool nativeIndexOf(MjvmExecution &execution) {
+    int32_t fromIndex = execution.stackPopInt32();
+    int32_t ch = execution.stackPopInt32();
+    MjvmObject *value = execution.stackPopObject();
+    int32_t count = value->size >> 1;
+    if(fromIndex < 0)
+        fromIndex = 0;
+    if(ch < 0 || ch > 0xFFFF || fromIndex >= count)
+        execution.stackPushInt32(-1);
+    else {
+        int32_t index = StringKernel_IndexOf16(&((const uint16_t *)value->data)[fromIndex], count - fromIndex, ch);
+        execution.stackPushInt32((index < 0) ? -1 : (index + fromIndex));
+    }
+    return true;
+}
+
+static bool nativeIndexOfString(MjvmExecution &execution) {
+    int32_t fromIndex = execution.stackPopInt32();
+    MjvmObject *str = execution.stackPopObject();
+    MjvmObject *value = execution.stackPopObject();
+    execution.stackPushInt32(indexOf(value, str, fromIndex, false));
+    return true;
+}
+
+static bool nativeIndexOfLatin1(MjvmExecution &execution) {
+    int32_t fromIndex = execution.stackPopInt32();
+    MjvmObject *str = execution.stackPopObject();
+    MjvmObject *value = execution.stackPopObject();
+    execution.stackPushInt32(indexOf(value, str, fromIndex, true));
+    return true;
+}
+
+static bool nativeLastIndexOf(MjvmExecution &execution) {
+    int32_t fromIndex = execution.stackPopInt32();
+    int32_t ch = execution.stackPopInt32();
+    MjvmObject *value = execution.stackPopObject();
+    int32_t count = value->size >> 1;
+    if(fromIndex >= count)
+        fromIndex = count - 1;
+    if(ch < 0 || ch > 0xFFFF || fromIndex < 0)
+        execution.stackPushInt32(-1);
+    else
+        execution.stackPushInt32(StringKernel_LastIndexOf16((const uint16_t *)value->data, fromIndex + 1, ch));
+    return true;
+}
+
+static bool nativeLastIndexOfString(MjvmExecution &execution) {
+    int32_t fromIndex = execution.stackPopInt32();
+    MjvmObject *str = execution.stackPopObject();
+    MjvmObject *value = execution.stackPopObject();
+    execution.stackPushInt32(lastIndexOf(value, str, fromIndex, false));
+    return true;
+}
+
+static bool nativeLastIndexOfLatin1(MjvmExecution &execution) {
+    int32_t fromIndex = execution.stackPopInt32();
+    MjvmObject *str = execution.stackPopObject();
+    MjvmObject *value = execution.stackPopObject();
+    execution.stackPushInt32(lastIndexOf(value, str, fromIndex, true));
+    return true;
+}
+
+static bool nativeReplace(MjvmExecution &execution) {
+    uint16_t newChar = execution.stackPopInt32();
+    uint16_t oldChar = execution.stackPopInt32();
+    MjvmObject *value = execution.stackPopObject();
+    uint32_t length = value->size >> 1;
+    const uint16_t *src = (const uint16_t *)value->data;
+    int32_t index = StringKernel_IndexOf16(src, length, oldChar);
+    if(index < 0) {
+        execution.stackPushObject(0);
+        return true;
+    }
+    MjvmString *strObj = execution.mjvm.newString(length, 1);
+    uint16_t *data = (uint16_t *)strObj->getText();
+    memcpy(data, src, index << 1);
+    StringKernel_Replace16(&src[index], &data[index], length - index, oldChar, newChar);
+    if(newChar <= 0xFF && StringKernel_IsLatin1(data, length)) {
+        /* the replaced character was the only one out of latin1, keep the utf16 string on the stack while allocating */
+        execution.stackPushObject(strObj);
+        MjvmString *latin1Obj = execution.mjvm.newString(length, 0);
+        execution.stackPopObject();
+        StringKernel_Compress((const uint16_t *)strObj->getText(), (uint8_t *)latin1Obj->getText(), length);
+        strObj = latin1Obj;
+    }
+    execution.stackPushObject(strObj);
+    return true;
+}
+
+static bool convertCase(MjvmExecution &execution, bool isToUpper) {
+    MjvmObject *value = execution.stackPopObject();
+    uint32_t length = value->size >> 1;
+    const uint16_t *src = (const uint16_t *)value->data;
+    uint32_t index = 0;
+    while(index < length && toCase(src[index], isToUpper) == src[index])
+        index++;
+    if(index == length) {
+        execution.stackPushObject(0);
+        return true;
+    }
+    MjvmString *strObj = execution.mjvm.newString(length, 1);
+    uint16_t *data = (uint16_t *)strObj->getText();
+    memcpy(data, src, index << 1);
+    for(; index < length; index++)
+        data[index] = toCase(src[index], isToUpper);
+    execution.stackPushObject(strObj);
+    return true;
+}
+
+static bool nativeToLower(MjvmExecution &execution) {
+    return convertCase(execution, false);
+}
+
+static bool nativeToUpper(MjvmExecution &execution) {
+    return convertCase(execution, true);
+}
+
+static bool nativeCompareTo(MjvmExecution &execution) {
+    MjvmObject *other = execution.stackPopObject();
+    MjvmObject *value = execution.stackPopObject();
+    uint32_t len1 = value->size >> 1;
+    uint32_t len2 = other->size >> 1;
+    uint32_t lim = (len1 < len2) ? len1 : len2;
+    uint32_t index = StringKernel_Mismatch(value->data, other->data, lim << 1) >> 1;
+    if(index < lim)
+        execution.stackPushInt32((int32_t)((const uint16_t *)value->data)[index] - (int32_t)((const uint16_t *)other->data)[index]);
+    else
+        execution.stackPushInt32((int32_t)len1 - (int32_t)len2);
+    return true;
+}
+
+static bool nativeEqualsIgnoreCase(MjvmExecution &execution) {
+    MjvmObject *other = execution.stackPopObject();
+    MjvmObject *value = execution.stackPopObject();
+    if(value->size != other->size) {
+        execution.stackPushInt32(0);
+        return true;
+    }
+    uint32_t length = value->size >> 1;
+    const uint16_t *data1 = (const uint16_t *)value->data;
+    const uint16_t *data2 = (const uint16_t *)other->data;
+    /* skip the identical parts at once, only the differing characters need the case mapping */
+    for(uint32_t i = 0; i < length; i++) {
+        i += StringKernel_Mismatch((const uint8_t *)&data1[i], (const uint8_t *)&data2[i], (length - i) << 1) >> 1;
+        if(i >= length)
+            break;
+        if(toCase(data1[i], false) != toCase(data2[i], false)) {
+            execution.stackPushInt32(0);
+            return true;
+        }
+    }
+    execution.stackPushInt32(1);
+    return true;
+}
+
+static const NativeMethod methods[] = {
+    NATIVE_METHOD("\x07\x00\xCD\x02""indexOf",           "\x07\x00\xC9\x01""([BII)I",                  nativeIndexOf),
+    NATIVE_METHOD("\x07\x00\xCD\x02""indexOf",           "\x08\x00\x1D\x02""([B[BI)I",                 nativeIndexOfString),
+    NATIVE_METHOD("\x0D\x00\xF6\x04""indexOfLatin1",     "\x08\x00\x1D\x02""([B[BI)I",                 nativeIndexOfLatin1),
+    NATIVE_METHOD("\x0B\x00\x61\x04""lastIndexOf",       "\x07\x00\xC9\x01""([BII)I",                  nativeLastIndexOf),
+    NATIVE_METHOD("\x0B\x00\x61\x04""lastIndexOf",       "\x08\x00\x1D\x02""([B[BI)I",                 nativeLastIndexOfString),
+    NATIVE_METHOD("\x11\x00\x8A\x06""lastIndexOfLatin1", "\x08\x00\x1D\x02""([B[BI)I",                 nativeLastIndexOfLatin1),
+    NATIVE_METHOD("\x07\x00\xDC\x02""replace",           "\x18\x00\x14\x08""([BCC)Ljava/lang/String;", nativeReplace),
+    NATIVE_METHOD("\x07\x00\xEC\x02""toLower",           "\x16\x00\x8E\x07""([B)Ljava/lang/String;",   nativeToLower),
+    NATIVE_METHOD("\x07\x00\xEF\x02""toUpper",           "\x16\x00\x8E\x07""([B)Ljava/lang/String;",   nativeToUpper),
+    NATIVE_METHOD("\x09\x00\xAA\x03""compareTo",         "\x07\x00\xD4\x01""([B[B)I",                  nativeCompareTo),
+    NATIVE_METHOD("\x10\x00\x6B\x06""equalsIgnoreCase",  "\x07\x00\xE5\x01""([B[B)Z",                  nativeEqualsIgnoreCase),
+};
+
+const NativeClass STRING_UTF16_CLASS = NATIVE_CLASS(stringUtf16ClassName, methods);
@@ -1,4 +1,5 @@
 
+#include <string.h>
 #include "mjvm.h"
 #include "mjvm_object.h"
 #include "mjvm_system_api.h"
@@ -15,44 +16,146 @@ static bool nativeNanoTime(MjvmExecution &execution) {
     return true;
 }
 
+static bool throwArraycopyException(MjvmExecution &execution, const char *msg, bool isIndexError) {
+    MjvmString *strObj = execution.mjvm.newString(msg, strlen(msg));
+    MjvmThrowable *excpObj;
+    if(isIndexError)
+        excpObj = execution.mjvm.newArrayIndexOutOfBoundsException(strObj);
+    else
+        excpObj = execution.mjvm.newArrayStoreException(strObj);
+    execution.stackPushObject(excpObj);
+    return false;
+}
+
+static bool isComponentOf(Mjvm &mjvm, MjvmObject *obj, MjvmObject *array, const char *typeName, uint16_t length) {
+    uint32_t dimensions = array->dimensions - 1;
+    if(array->type == objectClassName && obj->dimensions >= dimensions)
+        return true;
+    else if(obj->dimensions != dimensions)
+        return false;
+    else if(MjvmObject::isPrimType(array->type) || MjvmObject::isPrimType(obj->type))
+        return array->type == obj->type;
+    return mjvm.isInstanceof(obj, typeName, length);
+}
+
+/*
+ * Copy the references one by one and check each of them against the component type of dest.
+ * The elements of an array mostly have the same type, an element is only checked when its type differs from the previous one.
+ */
+static int32_t copyCheckedElements(Mjvm &mjvm, MjvmObject **src, MjvmObject **dst, int32_t length, MjvmObject *dest, const char *typeName, uint16_t typeLength) {
+    MjvmConstUtf8 *lastType = 0;
+    uint32_t lastDimensions = 0;
+    for(int32_t i = 0; i < length; i++) {
+        MjvmObject *obj = src[i];
+        if(obj && (lastType == 0 || obj->dimensions != lastDimensions || obj->type != *lastType)) {
+            if(!isComponentOf(mjvm, obj, dest, typeName, typeLength))
+                return i;
+            lastType = &obj->type;
+            lastDimensions = obj->dimensions;
+        }
+        dst[i] = obj;
+    }
+    return length;
+}
+
 static bool nativeArraycopy(MjvmExecution &execution) {
     int32_t length = execution.stackPopInt32();
     int32_t destPos = execution.stackPopInt32();
     MjvmObject *dest = execution.stackPopObject();
     int32_t srcPos = execution.stackPopInt32();
     MjvmObject *src = execution.stackPopObject();
-    if(src->type == dest->type) {
-        uint8_t atype = MjvmObject::isPrimType(src->type);
-        uint8_t elementSize = atype ? MjvmObject::getPrimitiveTypeSize(atype) : sizeof(MjvmObject *);
-        if((length < 0) || ((length + srcPos) > src->size / elementSize) || ((length + destPos) > dest->size / elementSize))
-            throw "Index out of range in System.arraycopy";
-        void *srcVal = src->data;
-        void *dstVal = dest->data;
-        switch(elementSize) {
-            case 1:
-                for(uint32_t i = 0; i < length; i++)
-                    ((uint8_t *)dstVal)[i + destPos] = ((uint8_t *)srcVal)[i + srcPos];
-                break;
-            case 2:
-                for(uint32_t i = 0; i < length; i++)
-                    ((uint16_t *)dstVal)[i + destPos] = ((uint16_t *)srcVal)[i + srcPos];
-                break;
-            case 4:
-                for(uint32_t i = 0; i < length; i++)
-                    ((uint32_t *)dstVal)[i + destPos] = ((uint32_t *)srcVal)[i + srcPos];
-                break;
-            case 8:
-                for(uint32_t i = 0; i < length; i++)
-                    ((uint64_t *)dstVal)[i + destPos] = ((uint64_t *)srcVal)[i + srcPos];
-                break;
+    if(src == 0 || dest == 0) {
+        MjvmString *strObj = execution.mjvm.newString(STR_AND_SIZE("arraycopy: the array is null"));
+        MjvmThrowable *excpObj = execution.mjvm.newNullPointerException(strObj);
+        execution.stackPushObject(excpObj);
+        return false;
+    }
+    if(src->dimensions == 0)
+        return throwArraycopyException(execution, "arraycopy: source type is not an array", false);
+    if(dest->dimensions == 0)
+        return throwArraycopyException(execution, "arraycopy: destination type is not an array", false);
+    uint8_t atype = (src->dimensions == 1) ? MjvmObject::isPrimType(src->type) : 0;
+    uint8_t destAtype = (dest->dimensions == 1) ? MjvmObject::isPrimType(dest->type) : 0;
+    if(atype != destAtype)
+        return throwArraycopyException(execution, "Type mismatch, can not copy array object", false);
+    uint32_t elementSize = atype ? MjvmObject::getPrimitiveTypeSize(atype) : sizeof(MjvmObject *);
+    if(length < 0)
+        return throwArraycopyException(execution, "arraycopy: length is negative", true);
+    if(srcPos < 0 || (uint32_t)srcPos > src->size / elementSize || (uint32_t)length > (src->size / elementSize) - srcPos)
+        return throwArraycopyException(execution, "arraycopy: source index out of bounds", true);
+    if(destPos < 0 || (uint32_t)destPos > dest->size / elementSize || (uint32_t)length > (dest->size / elementSize) - destPos)
+        return throwArraycopyException(execution, "arraycopy: destination index out of bounds", true);
+    if(length == 0)
+        return true;
+
+    uint8_t *srcData = &src->data[srcPos * elementSize];
+    uint8_t *destData = &dest->data[destPos * elementSize];
+    /* memmove keeps the result right when src and dest are the same array and the ranges overlap */
+    if(atype) {
+        memmove(destData, srcData, length * elementSize);
+        return true;
+    }
+    /*
+     * The collector marks the references under the lock, so the references are copied under the lock too.
+     * There is no other write barrier, the copied elements were already stored and are no longer new objects.
+     */
+    bool isAssignable = (src->dimensions == dest->dimensions && src->type == dest->type);
+    isAssignable = isAssignable || (dest->dimensions == 1 && dest->type == objectClassName);
+    if(isAssignable) {
+        Mjvm::lock();
+        memmove(destData, srcData, length * elementSize);
+        Mjvm::unlock();
+        return true;
+    }
+
+    /* the source elements are checked one by one, so a copy within the same array never reaches here */
+    int32_t count;
+    if(dest->dimensions == 1) {
+        Mjvm::lock();
+        try {
+            count = copyCheckedElements(execution.mjvm, (MjvmObject **)srcData, (MjvmObject **)destData, length, dest, dest->type.text, dest->type.length);
+        }
+        catch(MjvmLoadFileError *file) {
+            Mjvm::unlock();
+            throw file;
+        }
+        catch(MjvmOutOfMemoryError *err) {
+            Mjvm::unlock();
+            throw err;
         }
+        Mjvm::unlock();
     }
     else {
-        MjvmString *strObj = execution.mjvm.newString(STR_AND_SIZE("Type mismatch, can not copy array object"));
-        MjvmThrowable *excpObj = execution.mjvm.newArrayStoreException(strObj);
-        execution.stackPushObject(excpObj);
-        return false;
+        /* the name is allocated before taking the lock, the allocation can throw */
+        uint32_t typeLength = (dest->dimensions - 1) + dest->type.length + 2;
+        char *typeName = (char *)Mjvm::malloc(typeLength + 1);
+        uint32_t index = 0;
+        while(index < dest->dimensions - 1U)
+            typeName[index++] = '[';
+        typeName[index++] = 'L';
+        memcpy(&typeName[index], dest->type.text, dest->type.length);
+        index += dest->type.length;
+        typeName[index++] = ';';
+        typeName[index] = 0;
+        Mjvm::lock();
+        try {
+            count = copyCheckedElements(execution.mjvm, (MjvmObject **)srcData, (MjvmObject **)destData, length, dest, typeName, typeLength);
+        }
+        catch(MjvmLoadFileError *file) {
+            Mjvm::unlock();
+            Mjvm::free(typeName);
+            throw file;
+        }
+        catch(MjvmOutOfMemoryError *err) {
+            Mjvm::unlock();
+            Mjvm::free(typeName);
+            throw err;
+        }
+        Mjvm::unlock();
+        Mjvm::free(typeName);
     }
+    if(count < length)
+        return throwArraycopyException(execution, "arraycopy: element type mismatch, can not store into destination array", false);
     return true;
 }
 
@@ -0,0 +1,305 @@
+
+#include "mjvm.h"
+#include "mjvm_const_name.h"
+#include "mjvm_fields_data.h"
+#include "mjvm_native_unsafe_class.h"
+
+#if __has_include("mjvm_conf.h")
+#include "mjvm_conf.h"
+#endif
+#include "mjvm_default_conf.h"
+
+/*
+ * Field offsets handed out by objectFieldOffset are the addresses of the MjvmFieldInfo of the field,
+ * offsets used on an array object are the byte offsets from the first element of the array.
+ */
+static void *getValueAddress(MjvmObject *obj, int64_t offset, uint8_t size) {
+    if(obj == 0)
+        return 0;
+    if(obj->dimensions) {
+        if(offset < 0 || (offset + size) > obj->size)
+            throw "invalid array offset";
+        return &obj->data[(uint32_t)offset];
+    }
+    MjvmFieldsData &fields = *(MjvmFieldsData *)obj->data;
+    MjvmFieldInfo &fieldInfo = *(MjvmFieldInfo *)(uint32_t)offset;
+    switch(fieldInfo.descriptor.text[0]) {
+        case 'J':
+        case 'D': {
+            MjvmFieldData64 *field = &fields.getFieldData64(fieldInfo);
+            if(field && size == sizeof(int64_t))
+                return &field->value;
+            break;
+        }
+        case 'L':
+        case '[': {
+            MjvmFieldObject *field = &fields.getFieldObject(fieldInfo);
+            if(field && size == sizeof(MjvmObject *))
+                return &field->object;
+            break;
+        }
+        default: {
+            MjvmFieldData32 *field = &fields.getFieldData32(fieldInfo);
+            if(field && size == sizeof(int32_t))
+                return &field->value;
+            break;
+        }
+    }
+    throw "invalid field offset";
+}
+
+static bool pushNullPointerException(MjvmExecution &execution) {
+    MjvmString *strObj = execution.mjvm.newString(STR_AND_SIZE("Cannot access field of null object"));
+    MjvmThrowable *excpObj = execution.mjvm.newNullPointerException(strObj);
+    execution.stackPushObject(excpObj);
+    return false;
+}
+
+static bool nativeObjectFieldOffset(MjvmExecution &execution) {
+    MjvmString *name = (MjvmString *)execution.stackPopObject();
+    MjvmClass *clsObj = (MjvmClass *)execution.stackPopObject();
+    execution.stackPopObject();
+    if(name == 0 || clsObj == 0)
+        return pushNullPointerException(execution);
+    MjvmString &clsName = clsObj->getName();
+    uint32_t length = clsName.getLength();
+    if(clsName.getCoder() != 0 || length >= FILE_NAME_BUFF_SIZE)
+        throw "invalid class name";
+    char buff[FILE_NAME_BUFF_SIZE];
+    const char *text = clsName.getText();
+    for(uint32_t i = 0; i < length; i++)
+        buff[i] = (text[i] == '.') ? '/' : text[i];
+    buff[length] = 0;
+    try {
+        MjvmClassLoader *loader = &execution.mjvm.load(buff, length);
+        while(loader) {
+            uint16_t fieldsCount = loader->getFieldsCount();
+            for(uint16_t i = 0; i < fieldsCount; i++) {
+                MjvmFieldInfo &fieldInfo = loader->getFieldInfo(i);
+                if((fieldInfo.accessFlag & FIELD_STATIC) != FIELD_STATIC && name->equals(fieldInfo.name)) {
+                    execution.stackPushInt64((uint32_t)&fieldInfo);
+                    return true;
+                }
+            }
+            MjvmConstUtf8 *superClass = &loader->getSuperClass();
+            loader = superClass ? &execution.mjvm.load(*superClass) : 0;
+        }
+    }
+    catch(MjvmLoadFileError *file) {
+        const char *msg[] = {"Could not find or load class ", file->getFileName(), ".class"};
+        MjvmString *strObj = execution.mjvm.newString(msg, LENGTH(msg));
+        MjvmThrowable *excpObj = execution.mjvm.newClassNotFoundException(strObj);
+        execution.stackPushObject(excpObj);
+        return false;
+    }
+    throw "can't find the field";
+}
+
+static bool nativeArrayBaseOffset(MjvmExecution &execution) {
+    execution.stackPopObject();
+    execution.stackPopObject();
+    execution.stackPushInt32(0);
+    return true;
+}
+
+static bool nativeArrayIndexScale(MjvmExecution &execution) {
+    MjvmClass *clsObj = (MjvmClass *)execution.stackPopObject();
+    execution.stackPopObject();
+    MjvmString &clsName = clsObj->getName();
+    const char *text = clsName.getText();
+    if(clsName.getCoder() != 0 || clsName.getLength() < 2 || text[0] != '[')
+        throw "class is not an array class";
+    uint8_t atype = (clsName.getLength() == 2) ? MjvmObject::convertToAType(text[1]) : 0;
+    execution.stackPushInt32(atype ? MjvmObject::getPrimitiveTypeSize(atype) : sizeof(MjvmObject *));
+    return true;
+}
+
+static bool nativeCompareAndSetInt(MjvmExecution &execution) {
+    int32_t x = execution.stackPopInt32();
+    int32_t expected = execution.stackPopInt32();
+    int64_t offset = execution.stackPopInt64();
+    MjvmObject *obj = execution.stackPopObject();
+    execution.stackPopObject();
+    volatile int32_t *value = (volatile int32_t *)getValueAddress(obj, offset, sizeof(int32_t));
+    if(value == 0)
+        return pushNullPointerException(execution);
+    execution.stackPushInt32(Mjvm_CompareAndSwap32(value, expected, x));
+    return true;
+}
+
+static bool nativeCompareAndSetLong(MjvmExecution &execution) {
+    int64_t x = execution.stackPopInt64();
+    int64_t expected = execution.stackPopInt64();
+    int64_t offset = execution.stackPopInt64();
+    MjvmObject *obj = execution.stackPopObject();
+    execution.stackPopObject();
+    volatile int64_t *value = (volatile int64_t *)getValueAddress(obj, offset, sizeof(int64_t));
+    if(value == 0)
+        return pushNullPointerException(execution);
+    execution.stackPushInt32(Mjvm_CompareAndSwap64(value, expected, x));
+    return true;
+}
+
+static bool nativeCompareAndSetReference(MjvmExecution &execution) {
+    MjvmObject *x = execution.stackPopObject();
+    MjvmObject *expected = execution.stackPopObject();
+    int64_t offset = execution.stackPopInt64();
+    MjvmObject *obj = execution.stackPopObject();
+    execution.stackPopObject();
+    volatile int32_t *value = (volatile int32_t *)getValueAddress(obj, offset, sizeof(MjvmObject *));
+    if(value == 0)
+        return pushNullPointerException(execution);
+    execution.stackPushInt32(Mjvm_CompareAndSwap32(value, (int32_t)expected, (int32_t)x));
+    return true;
+}
+
+static bool nativeGetAndAddInt(MjvmExecution &execution) {
+    int32_t delta = execution.stackPopInt32();
+    int64_t offset = execution.stackPopInt64();
+    MjvmObject *obj = execution.stackPopObject();
+    execution.stackPopObject();
+    volatile int32_t *value = (volatile int32_t *)getValueAddress(obj, offset, sizeof(int32_t));
+    if(value == 0)
+        return pushNullPointerException(execution);
+    execution.stackPushInt32(Mjvm_GetAndAdd32(value, delta));
+    return true;
+}
+
+static bool nativeGetAndAddLong(MjvmExecution &execution) {
+    int64_t delta = execution.stackPopInt64();
+    int64_t offset = execution.stackPopInt64();
+    MjvmObject *obj = execution.stackPopObject();
+    execution.stackPopObject();
+    volatile int64_t *value = (volatile int64_t *)getValueAddress(obj, offset, sizeof(int64_t));
+    if(value == 0)
+        return pushNullPointerException(execution);
+    execution.stackPushInt64(Mjvm_GetAndAdd64(value, delta));
+    return true;
+}
+
+static bool nativeGetAndSetInt(MjvmExecution &execution) {
+    int32_t x = execution.stackPopInt32();
+    int64_t offset = execution.stackPopInt64();
+    MjvmObject *obj = execution.stackPopObject();
+    execution.stackPopObject();
+    volatile int32_t *value = (volatile int32_t *)getValueAddress(obj, offset, sizeof(int32_t));
+    if(value == 0)
+        return pushNullPointerException(execution);
+    execution.stackPushInt32(Mjvm_GetAndSet32(value, x));
+    return true;
+}
+
+static bool nativeGetAndSetLong(MjvmExecution &execution) {
+    int64_t x = execution.stackPopInt64();
+    int64_t offset = execution.stackPopInt64();
+    MjvmObject *obj = execution.stackPopObject();
+    execution.stackPopObject();
+    volatile int64_t *value = (volatile int64_t *)getValueAddress(obj, offset, sizeof(int64_t));
+    if(value == 0)
+        return pushNullPointerException(execution);
+    execution.stackPushInt64(Mjvm_GetAndSet64(value, x));
+    return true;
+}
+
+static bool nativeGetAndSetReference(MjvmExecution &execution) {
+    MjvmObject *x = execution.stackPopObject();
+    int64_t offset = execution.stackPopInt64();
+    MjvmObject *obj = execution.stackPopObject();
+    execution.stackPopObject();
+    volatile int32_t *value = (volatile int32_t *)getValueAddress(obj, offset, sizeof(MjvmObject *));
+    if(value == 0)
+        return pushNullPointerException(execution);
+    execution.stackPushObject((MjvmObject *)Mjvm_GetAndSet32(value, (int32_t)x));
+    return true;
+}
+
+static bool nativeGetIntVolatile(MjvmExecution &execution) {
+    int64_t offset = execution.stackPopInt64();
+    MjvmObject *obj = execution.stackPopObject();
+    execution.stackPopObject();
+    volatile int32_t *value = (volatile int32_t *)getValueAddress(obj, offset, sizeof(int32_t));
+    if(value == 0)
+        return pushNullPointerException(execution);
+    execution.stackPushInt32(Mjvm_AtomicLoad32(value));
+    return true;
+}
+
+static bool nativePutIntVolatile(MjvmExecution &execution) {
+    int32_t x = execution.stackPopInt32();
+    int64_t offset = execution.stackPopInt64();
+    MjvmObject *obj = execution.stackPopObject();
+    execution.stackPopObject();
+    volatile int32_t *value = (volatile int32_t *)getValueAddress(obj, offset, sizeof(int32_t));
+    if(value == 0)
+        return pushNullPointerException(execution);
+    Mjvm_AtomicStore32(value, x);
+    return true;
+}
+
+static bool nativeGetLongVolatile(MjvmExecution &execution) {
+    int64_t offset = execution.stackPopInt64();
+    MjvmObject *obj = execution.stackPopObject();
+    execution.stackPopObject();
+    volatile int64_t *value = (volatile int64_t *)getValueAddress(obj, offset, sizeof(int64_t));
+    if(value == 0)
+        return pushNullPointerException(execution);
+    execution.stackPushInt64(Mjvm_AtomicLoad64(value));
+    return true;
+}
+
+static bool nativePutLongVolatile(MjvmExecution &execution) {
+    int64_t x = execution.stackPopInt64();
+    int64_t offset = execution.stackPopInt64();
+    MjvmObject *obj = execution.stackPopObject();
+    execution.stackPopObject();
+    volatile int64_t *value = (volatile int64_t *)getValueAddress(obj, offset, sizeof(int64_t));
+    if(value == 0)
+        return pushNullPointerException(execution);
+    Mjvm_AtomicStore64(value, x);
+    return true;
+}
+
+static bool nativeGetReferenceVolatile(MjvmExecution &execution) {
+    int64_t offset = execution.stackPopInt64();
+    MjvmObject *obj = execution.stackPopObject();
+    execution.stackPopObject();
+    volatile int32_t *value = (volatile int32_t *)getValueAddress(obj, offset, sizeof(MjvmObject *));
+    if(value == 0)
+        return pushNullPointerException(execution);
+    execution.stackPushObject((MjvmObject *)Mjvm_AtomicLoad32(value));
+    return true;
+}
+
+static bool nativePutReferenceVolatile(MjvmExecution &execution) {
+    MjvmObject *x = execution.stackPopObject();
+    int64_t offset = execution.stackPopInt64();
+    MjvmObject *obj = execution.stackPopObject();
+    execution.stackPopObject();
+    volatile int32_t *value = (volatile int32_t *)getValueAddress(obj, offset, sizeof(MjvmObject *));
+    if(value == 0)
+        return pushNullPointerException(execution);
+    Mjvm_AtomicStore32(value, (int32_t)x);
+    return true;
+}
+
+static const NativeMethod methods[] = {
+    NATIVE_METHOD("\x11\x00\xC2\x06""objectFieldOffset",      "\x26\x00\x5A\x0D""(Ljava/lang/Class;Ljava/lang/String;)J",                      nativeObjectFieldOffset),
+    NATIVE_METHOD("\x0F\x00\x01\x06""arrayBaseOffset",        "\x14\x00\xB9\x06""(Ljava/lang/Class;)I",                                        nativeArrayBaseOffset),
+    NATIVE_METHOD("\x0F\x00\xFF\x05""arrayIndexScale",        "\x14\x00\xB9\x06""(Ljava/lang/Class;)I",                                        nativeArrayIndexScale),
+    NATIVE_METHOD("\x10\x00\x51\x06""compareAndSetInt",       "\x18\x00\x07\x08""(Ljava/lang/Object;JII)Z",                                    nativeCompareAndSetInt),
+    NATIVE_METHOD("\x11\x00\xB6\x06""compareAndSetLong",      "\x18\x00\x09\x08""(Ljava/lang/Object;JJJ)Z",                                    nativeCompareAndSetLong),
+    NATIVE_METHOD("\x16\x00\xB5\x08""compareAndSetReference", "\x3A\x00\x75\x14""(Ljava/lang/Object;JLjava/lang/Object;Ljava/lang/Object;)Z", nativeCompareAndSetReference),
+    NATIVE_METHOD("\x0C\x00\x87\x04""getAndAddInt",           "\x17\x00\xAD\x07""(Ljava/lang/Object;JI)I",                                     nativeGetAndAddInt),
+    NATIVE_METHOD("\x0D\x00\xEC\x04""getAndAddLong",          "\x17\x00\xAF\x07""(Ljava/lang/Object;JJ)J",                                     nativeGetAndAddLong),
+    NATIVE_METHOD("\x0C\x00\xAA\x04""getAndSetInt",           "\x17\x00\xAD\x07""(Ljava/lang/Object;JI)I",                                     nativeGetAndSetInt),
+    NATIVE_METHOD("\x0D\x00\x0F\x05""getAndSetLong",          "\x17\x00\xAF\x07""(Ljava/lang/Object;JJ)J",                                     nativeGetAndSetLong),
+    NATIVE_METHOD("\x12\x00\x0E\x07""getAndSetReference",     "\x39\x00\x1B\x14""(Ljava/lang/Object;JLjava/lang/Object;)Ljava/lang/Object;",   nativeGetAndSetReference),
+    NATIVE_METHOD("\x0E\x00\xAB\x05""getIntVolatile",         "\x16\x00\x64\x07""(Ljava/lang/Object;J)I",                                      nativeGetIntVolatile),
+    NATIVE_METHOD("\x0E\x00\xC4\x05""putIntVolatile",         "\x17\x00\xBA\x07""(Ljava/lang/Object;JI)V",                                     nativePutIntVolatile),
+    NATIVE_METHOD("\x0F\x00\x10\x06""getLongVolatile",        "\x16\x00\x65\x07""(Ljava/lang/Object;J)J",                                      nativeGetLongVolatile),
+    NATIVE_METHOD("\x0F\x00\x29\x06""putLongVolatile",        "\x17\x00\xBB\x07""(Ljava/lang/Object;JJ)V",                                     nativePutLongVolatile),
+    NATIVE_METHOD("\x14\x00\x0F\x08""getReferenceVolatile",   "\x27\x00\x9B\x0D""(Ljava/lang/Object;J)Ljava/lang/Object;",                     nativeGetReferenceVolatile),
+    NATIVE_METHOD("\x14\x00\x28\x08""putReferenceVolatile",   "\x28\x00\xF1\x0D""(Ljava/lang/Object;JLjava/lang/Object;)V",                    nativePutReferenceVolatile),
+};
+
+const NativeClass UNSAFE_CLASS = NATIVE_CLASS(unsafeClassName, methods);
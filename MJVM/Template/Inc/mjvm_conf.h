@@ -7,8 +7,12 @@
 #include "mjvm_common.h"
 
 #define FILE_NAME_BUFF_SIZE     256
+#define KEEP_CLASS_IMAGE        0
+#define LAZY_METHOD_CODE        0
 
 #define DEFAULT_STACK_SIZE      MEGA_BYTE(1)
+#define INITIAL_STACK_SIZE      KILO_BYTE(1)
+#define MAX_OF_FREE_EXECUTION   4
 #define OBJECT_SIZE_TO_GC       MEGA_BYTE(1)
 
 #define MAX_OF_BREAK_POINT      20
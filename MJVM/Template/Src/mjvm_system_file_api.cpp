@@ -30,3 +30,14 @@ MjvmSys_FileResult MjvmSystem_FileSeek(void *fileHandle, uint32_t offset) {
 MjvmSys_FileResult MjvmSystem_FileClose(void *fileHandle) {
     throw "MjvmSystem_FileClose is not implemented in VM";
 }
+
+void *MjvmSystem_FileMap(void *fileHandle, uint32_t *size) {
+    /* Optional, map the whole file into memory (e.g. mmap on Linux) and return its address */
+    /* The mapping must be private and writable (copy-on-write) and stay valid after the file is closed */
+    /* Returning 0 makes the class loader read the whole file into a buffer instead */
+    return 0;
+}
+
+void MjvmSystem_FileUnmap(void *addr, uint32_t size) {
+    /* Release the mapping returned by MjvmSystem_FileMap */
+}
@@ -14,3 +14,19 @@ void MjvmSystem_ThreadTerminate(void *threadHandle) {
 void MjvmSystem_ThreadSleep(uint32_t ms) {
     throw "MjvmSystem_ThreadSleep is not implemented in VM";
 }
+
+void *MjvmSystem_SemaphoreCreate(uint32_t initialCount, uint32_t maxCount) {
+    throw "MjvmSystem_SemaphoreCreate is not implemented in VM";
+}
+
+bool MjvmSystem_SemaphoreTake(void *semaphoreHandle, uint32_t timeoutMs) {
+    throw "MjvmSystem_SemaphoreTake is not implemented in VM";
+}
+
+void MjvmSystem_SemaphoreGive(void *semaphoreHandle) {
+    throw "MjvmSystem_SemaphoreGive is not implemented in VM";
+}
+
+void MjvmSystem_SemaphoreDelete(void *semaphoreHandle) {
+    throw "MjvmSystem_SemaphoreDelete is not implemented in VM";
+}
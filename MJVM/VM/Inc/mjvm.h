@@ -4,6 +4,7 @@
 
 #include <stdint.h>
 #include "mjvm_execution.h"
+#include "mjvm_task_pool.h"
 #include "mjvm_class.h"
 #include "mjvm_string.h"
 #include "mjvm_throwable.h"
@@ -12,6 +13,8 @@
 #include "mjvm_out_of_memory.h"
 #include "mjvm_load_file_error.h"
 
+class NativeClass;
+
 class MjvmExecutionNode : public MjvmExecution {
 public:
     MjvmExecutionNode *prev;
@@ -30,15 +33,45 @@ private:
     static Mjvm mjvmInstance;
     MjvmDebugger *dbg;
     MjvmExecutionNode *executionList;
+    MjvmExecutionNode *freeExecutionList;
+    uint32_t freeExecutionCount;
+    MjvmTaskPool *taskPoolList;
     ClassData *classDataList;
     MjvmObject *objectList;
     MjvmConstClass *constClassList;
     MjvmConstString *constStringList;
+    MjvmConstClass **constClassTable;
+    MjvmConstString **constStringTable;
+    uint32_t constClassTableSize;
+    uint32_t constStringTableSize;
+    uint32_t constClassCount;
+    uint32_t constStringCount;
+    MjvmClassArchive *classArchive;
+    MjvmClassBundle *classBundle;
+    uint8_t *snapshotUtf8;
     uint32_t objectSizeToGc;
 
     Mjvm(void);
     Mjvm(const Mjvm &) = delete;
     void operator=(const Mjvm &) = delete;
+
+    MjvmExecutionNode *takeFreeExecution(uint32_t stackSize);
+    ClassData *newClassData(const char *className, uint16_t length);
+    ClassData *findClassData(const char *className, uint16_t length) const;
+    ClassData *findClassData(MjvmString &className) const;
+    ClassData *preload(const char *className, uint16_t length);
+
+    void addConstClass(MjvmClass &classObj);
+    void addConstString(MjvmString &str);
+    void removeConstClassHash(MjvmConstClass *node);
+    void removeConstStringHash(MjvmConstString *node);
+
+    bool isIdle(void) const;
+    void markClass(ClassData &classData, ClassData *&markedList);
+    void markClass(const char *className, uint16_t length, ClassData *&markedList);
+    void unloadClasses(void);
+
+    bool isImplementationOf(MjvmClassLoader &classLoader, const char *text, uint16_t length);
 public:
     static void *malloc(uint32_t size);
     static void *realloc(void *p, uint32_t size);
@@ -51,6 +84,10 @@ public:
 
     MjvmExecution &newExecution(void);
     MjvmExecution &newExecution(uint32_t stackSize);
+    void releaseExecution(MjvmExecution &execution);
+    void releaseExecutionLocked(MjvmExecution &execution);
+
+    MjvmTaskPool &newTaskPool(uint16_t workerCount, bool asyncMode = false, MjvmObject *owner = 0);
 public:
     MjvmDebugger *getDebugger(void) const;
     void setDebugger(MjvmDebugger *dbg);
@@ -64,7 +101,7 @@ public:
     MjvmClass *getConstClass(const char *text, uint16_t length);
     MjvmClass *getConstClass(MjvmString &str);
 
-    MjvmString *newString(uint16_t length, uint8_t coder);
+    MjvmString *newString(uint32_t length, uint8_t coder);
     MjvmString *newString(const char *text, uint16_t size, bool isUtf8 = false);
     MjvmString *newString(const char *latin1Str[], uint16_t count);
     MjvmString *getConstString(MjvmConstUtf8 &utf8);
@@ -79,28 +116,51 @@ public:
     MjvmThrowable *newNegativeArraySizeException(MjvmString *strObj);
     MjvmThrowable *newArrayIndexOutOfBoundsException(MjvmString *strObj);
     MjvmThrowable *newUnsupportedOperationException(MjvmString *strObj);
+    MjvmThrowable *newNoClassDefFoundError(MjvmString *strObj);
 
     void freeAllObject(void);
     void clearProtectObjectNew(MjvmObject *obj);
     void garbageCollectionProtectObject(MjvmObject *obj);
+    void garbageCollectionTaskPools(void);
 
     void initStaticField(ClassData &classData);
+    void finishClassInit(ClassData &classData, bool isSucceeded);
+    void cancelClassInit(ClassData &classData);
+    void waitClassInit(ClassData &classData);
     MjvmFieldsData &getStaticFields(MjvmConstUtf8 &className) const;
 
     MjvmMethodInfo &findMethod(MjvmConstMethod &constMethod);
 
     bool isInstanceof(MjvmObject *obj, const char *typeName, uint16_t length);
 
-    void garbageCollection(void);
+    void garbageCollection(bool isUnloadClasses = false);
+
+    uint32_t getClassMemoryUsage(void) const;
+    uint32_t getClassMemoryUsage(MjvmClassLoader &classLoader) const;
 
     MjvmClassLoader &load(const char *className, uint16_t length);
     MjvmClassLoader &load(const char *className);
     MjvmClassLoader &load(MjvmConstUtf8 &className);
 
+    void openClassArchive(const char *fileName);
+    void openClassBundle(const char *fileName);
+
+    void registerNativeClass(const NativeClass &nativeClass);
+
+    void preloadClasses(const char *mainClass, uint16_t workerCount);
+    void preloadClassList(const char *fileName, uint16_t workerCount);
+    void saveClassList(const char *fileName);
+
+    void saveSnapshot(const char *fileName);
+    void restoreSnapshot(const char *fileName);
+
     void runToMain(const char *mainClass);
     void runToMain(const char *mainClass, uint32_t stackSize);
 
     void terminateAll(void);
+
+    friend class MjvmSnapshot;
+    friend class MjvmClassPreloader;
 };
 
 #endif /* __MJVM_H */
@@ -93,13 +93,15 @@ public:
 private:
     MjvmExceptionTable *exceptionTable;
     MjvmAttribute *attributes;
+    bool isCodeInImage;
+    bool isExceptionTableInImage;
 
     MjvmCodeAttribute(uint16_t maxStack, uint16_t maxLocals);
     MjvmCodeAttribute(const MjvmCodeAttribute &) = delete;
     void operator=(const MjvmCodeAttribute &) = delete;
 
-    void setCode(uint8_t *code, uint32_t length);
-    void setExceptionTable(MjvmExceptionTable *exceptionTable, uint16_t length);
+    void setCode(uint8_t *code, uint32_t length, bool isInImage = false);
+    void setExceptionTable(MjvmExceptionTable *exceptionTable, uint16_t length, bool isInImage = false);
     void addAttribute(MjvmAttribute *attribute);
 
     ~MjvmCodeAttribute(void);
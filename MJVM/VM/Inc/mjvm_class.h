@@ -16,6 +16,7 @@ protected:
 class MjvmConstClass {
 private:
     MjvmConstClass *next;
+    MjvmConstClass *hashNext;
 public:
     MjvmClass &mjvmClass;
 private:
@@ -24,6 +25,7 @@ private:
     void operator=(const MjvmConstClass &) = delete;
 
     friend class Mjvm;
+    friend class MjvmSnapshot;
 };
 
 #endif /* __MJVM_CLASS_H */
@@ -0,0 +1,87 @@
+
+#ifndef __MJVM_CLASS_ARCHIVE_H
+#define __MJVM_CLASS_ARCHIVE_H
+
+#include "mjvm_std_types.h"
+
+#define CLASS_ARCHIVE_MAGIC         0x41434A4D  /* "MJCA" */
+#define CLASS_ARCHIVE_VERSION       1
+
+/*
+ * All structures are stored little-endian with their natural alignment.
+ * Offsets are relative to the start of the archive.
+ */
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t classCount;
+    uint32_t bucketCount;
+    uint32_t bucketsOffset;
+    uint32_t utf8Offset;
+    uint32_t utf8Size;
+} MjvmArchiveHeader;
+
+typedef struct {
+    uint32_t nameOffset;
+    uint16_t minorVersion;
+    uint16_t majorVersion;
+    uint16_t accessFlags;
+    uint16_t thisClass;
+    uint16_t superClass;
+    uint16_t poolCount;
+    uint16_t interfacesCount;
+    uint16_t fieldsCount;
+    uint16_t methodsCount;
+    uint16_t reserved;
+    uint32_t poolOffset;
+    uint32_t interfacesOffset;
+    uint32_t fieldsOffset;
+    uint32_t methodsOffset;
+    uint32_t bootstrapMethodsOffset;
+} MjvmArchiveClass;
+
+typedef struct {
+    uint16_t accessFlag;
+    uint16_t nameIndex;
+    uint16_t descriptorIndex;
+    uint16_t reserved;
+} MjvmArchiveField;
+
+typedef struct {
+    uint16_t accessFlag;
+    uint16_t nameIndex;
+    uint16_t descriptorIndex;
+    uint16_t maxStack;
+    uint16_t maxLocals;
+    uint16_t exceptionTableLength;
+    uint32_t codeLength;
+    uint32_t codeOffset;
+    uint32_t exceptionTableOffset;
+} MjvmArchiveMethod;
+
+class MjvmClassArchive {
+private:
+    uint8_t *data;
+    uint32_t size;
+    bool isMapped;
+
+    MjvmClassArchive(const char *fileName);
+    MjvmClassArchive(const MjvmClassArchive &) = delete;
+    void operator=(const MjvmClassArchive &) = delete;
+
+    ~MjvmClassArchive(void);
+
+    bool isValidRange(uint32_t offset, uint32_t length, uint32_t alignment = 1) const;
+    bool isValidUtf8(uint32_t offset) const;
+    bool isValidClass(const MjvmArchiveClass &archiveClass) const;
+
+    friend class Mjvm;
+public:
+    static uint32_t calcHash(const char *text, uint16_t length);
+
+    const MjvmArchiveClass *findClass(const char *className, uint16_t length) const;
+    void *getData(uint32_t offset) const;
+};
+
+#endif /* __MJVM_CLASS_ARCHIVE_H */
@@ -0,0 +1,48 @@
+
+#ifndef __MJVM_CLASS_BUNDLE_H
+#define __MJVM_CLASS_BUNDLE_H
+
+#include "mjvm_std_types.h"
+
+typedef struct {
+    const char *name;       /* class name without the ".class" extension, 0 for an empty bucket */
+    uint16_t nameLength;
+    uint16_t headerSize;    /* local header size expected from the central directory */
+    uint32_t hash;
+    uint32_t offset;        /* offset of the local file header */
+    uint32_t size;
+} MjvmBundleEntry;
+
+/*
+ * A class bundle is a ZIP (or JAR) file whose class entries are stored without compression.
+ * The central directory is indexed once when the bundle is opened, loading a class is then
+ * a single hash probe and a single read (no read at all when the bundle can be mapped).
+ * Compressed entries are ignored, such classes are loaded from the file system as usual.
+ */
+class MjvmClassBundle {
+private:
+    void *file;
+    uint8_t *data;
+    uint32_t size;
+    bool isMapped;
+    char *names;
+    MjvmBundleEntry *buckets;
+    uint32_t bucketCount;
+
+    MjvmClassBundle(const char *fileName);
+    MjvmClassBundle(const MjvmClassBundle &) = delete;
+    void operator=(const MjvmClassBundle &) = delete;
+
+    void read(uint32_t offset, void *buff, uint32_t size) const;
+    void loadIndex(void);
+
+    ~MjvmClassBundle(void);
+
+    friend class Mjvm;
+public:
+    const MjvmBundleEntry *findClass(const char *className, uint16_t length) const;
+    uint8_t *readClass(const MjvmBundleEntry &entry) const;
+    bool isClassMapped(void) const;
+};
+
+#endif /* __MJVM_CLASS_BUNDLE_H */
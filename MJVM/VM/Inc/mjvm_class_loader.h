@@ -7,6 +7,8 @@
 #include "mjvm_method_info.h"
 #include "mjvm_class.h"
 #include "mjvm_string.h"
+#include "mjvm_class_archive.h"
+#include "mjvm_class_bundle.h"
 
 class Mjvm;
 
@@ -28,20 +30,36 @@ private:
     MjvmFieldInfo *fields;
     MjvmMethodInfo *methods;
     MjvmAttribute *attributes;
+    uint8_t *classImage;
+    uint32_t classImageSize;
+    bool isImageMapped;
+    bool isImageShared;
+    bool isArchived;
+    uint8_t *utf8Pool;
 
     MjvmClassLoader(const MjvmClassLoader &) = delete;
     void operator=(const MjvmClassLoader &) = delete;
 
     void addAttribute(MjvmAttribute *attribute);
+    void *getConstClassValue(MjvmConstPool &constPool);
 
+    void loadFile(void *file);
+    void loadBuffer(void *buff);
     void readFile(void *file);
     MjvmAttribute *readAttribute(void *file, bool isDummy = false);
     MjvmAttribute *readAttributeCode(void *file);
     MjvmAttribute *readAttributeBootstrapMethods(void *file);
+    MjvmCodeAttribute &loadCode(MjvmMethodInfo &methodInfo);
+
+    static uint32_t getAttributesSize(MjvmAttribute *attributes);
+
+    friend class MjvmMethodInfo;
 protected:
     MjvmClassLoader(const char *fileName);
     MjvmClassLoader(const char *fileName, uint16_t length);
     MjvmClassLoader(const MjvmConstUtf8 &fileName);
+    MjvmClassLoader(const MjvmClassArchive &archive, const MjvmArchiveClass &archiveClass);
+    MjvmClassLoader(const MjvmClassBundle &bundle, const MjvmBundleEntry &entry);
 
     ~MjvmClassLoader(void);
 public:
@@ -49,6 +67,7 @@ public:
     uint16_t getMinorVersion(void) const;
     uint16_t getMajorversion(void) const;
 
+    uint16_t getConstPoolCount(void) const;
     MjvmConstPool &getConstPool(uint16_t index) const;
 
     int32_t getConstInteger(uint16_t poolIndex) const;
@@ -67,6 +86,8 @@ public:
     MjvmConstUtf8 &getConstUtf8Class(MjvmConstPool &constPool) const;
     MjvmClass &getConstClass(Mjvm &mjvm, uint16_t poolIndex);
     MjvmClass &getConstClass(Mjvm &mjvm, MjvmConstPool &constPool);
+    MjvmClassLoader &getConstClassLoader(Mjvm &mjvm, uint16_t poolIndex);
+    MjvmClassLoader &getConstClassLoader(Mjvm &mjvm, MjvmConstPool &constPool);
 
     MjvmString &getConstString(Mjvm &mjvm, uint16_t poolIndex);
     MjvmString &getConstString(Mjvm &mjvm, MjvmConstPool &constPool);
@@ -82,6 +103,10 @@ public:
     MjvmConstMethod &getConstMethod(MjvmConstPool &constPool);
     MjvmConstInterfaceMethod &getConstInterfaceMethod(uint16_t poolIndex);
     MjvmConstInterfaceMethod &getConstInterfaceMethod(MjvmConstPool &constPool);
+    MjvmConstMethodHandle &getConstMethodHandle(uint16_t poolIndex);
+    MjvmConstMethodHandle &getConstMethodHandle(MjvmConstPool &constPool);
+    MjvmConstInvokeDynamic &getConstInvokeDynamic(uint16_t poolIndex);
+    MjvmConstInvokeDynamic &getConstInvokeDynamic(MjvmConstPool &constPool);
 
     MjvmClassAccessFlag getAccessFlag(void) const;
 
@@ -102,6 +127,11 @@ public:
     MjvmMethodInfo &getMethodInfo(MjvmConstNameAndType &nameAndType) const;
     MjvmMethodInfo &getMainMethodInfo(void) const;
     MjvmMethodInfo &getStaticConstructor(void) const;
+
+    MjvmBootstrapMethod &getBootstrapMethod(uint16_t index) const;
+
+    uint32_t getMemoryUsage(void) const;
+    bool isUnloadable(void) const;
 };
 
 #endif /* __MJVM_CLASS_LOADER_H */
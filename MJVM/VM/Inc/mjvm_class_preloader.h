@@ -0,0 +1,48 @@
+
+#ifndef __MJVM_CLASS_PRELOADER_H
+#define __MJVM_CLASS_PRELOADER_H
+
+#include "mjvm_std_types.h"
+
+class Mjvm;
+class ClassData;
+class MjvmClassLoader;
+
+typedef struct {
+    const char *text;
+    uint16_t length;
+    uint32_t hash;
+    ClassData *classData;
+} MjvmPreloadClass;
+
+class MjvmClassPreloader {
+private:
+    Mjvm &mjvm;
+    const uint16_t workerCount;
+    MjvmPreloadClass *classes;
+    uint32_t count;
+    uint32_t capacity;
+    volatile int32_t nextIndex;
+    int32_t endIndex;
+    char *classList;
+    void *doneSemaphore;
+
+    MjvmClassPreloader(Mjvm &mjvm, uint16_t workerCount);
+    MjvmClassPreloader(const MjvmClassPreloader &) = delete;
+    void operator=(const MjvmClassPreloader &) = delete;
+
+    void addClass(const char *text, uint16_t length);
+    void addReferences(const MjvmClassLoader &classLoader);
+    void loadClasses(uint32_t start);
+    void preload(const char *mainClass);
+    void preloadList(const char *fileName);
+
+    ~MjvmClassPreloader(void);
+
+    static void workerTask(MjvmClassPreloader *preloader);
+    static void threadTask(MjvmClassPreloader *preloader);
+
+    friend class Mjvm;
+};
+
+#endif /* __MJVM_CLASS_PRELOADER_H */
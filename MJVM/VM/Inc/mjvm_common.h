@@ -15,4 +15,15 @@ uint64_t Mjvm_Swap64(uint64_t value);
 
 uint16_t Mjvm_CalcCrc(const uint8_t *data, uint32_t length);
 
+bool Mjvm_CompareAndSwap32(volatile int32_t *target, int32_t expected, int32_t value);
+bool Mjvm_CompareAndSwap64(volatile int64_t *target, int64_t expected, int64_t value);
+int32_t Mjvm_GetAndAdd32(volatile int32_t *target, int32_t delta);
+int64_t Mjvm_GetAndAdd64(volatile int64_t *target, int64_t delta);
+int32_t Mjvm_GetAndSet32(volatile int32_t *target, int32_t value);
+int64_t Mjvm_GetAndSet64(volatile int64_t *target, int64_t value);
+int32_t Mjvm_AtomicLoad32(volatile int32_t *target);
+int64_t Mjvm_AtomicLoad64(volatile int64_t *target);
+void Mjvm_AtomicStore32(volatile int32_t *target, int32_t value);
+void Mjvm_AtomicStore64(volatile int64_t *target, int64_t value);
+
 #endif /* __MJVM_COMMON_H */
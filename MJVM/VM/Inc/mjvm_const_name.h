@@ -8,7 +8,10 @@ extern const MjvmConstUtf8 * const primTypeConstUtf8List[];
 extern const uint32_t stringNameFieldName[];
 extern const uint32_t stringValueFieldName[];
 extern const uint32_t stringCoderFieldName[];
+extern const uint32_t stringHashFieldName[];
 extern const uint32_t exceptionDetailMessageFieldName[];
+extern const uint32_t runnableRunMethodName[];
+extern const uint32_t toStringMethodName[];
 
 extern const MjvmConstUtf8 &mathClassName;
 extern const MjvmConstUtf8 &classClassName;
@@ -17,12 +20,29 @@ extern const MjvmConstUtf8 &doubleClassName;
 extern const MjvmConstUtf8 &objectClassName;
 extern const MjvmConstUtf8 &systemClassName;
 extern const MjvmConstUtf8 &stringClassName;
+extern const MjvmConstUtf8 &stringLatin1ClassName;
+extern const MjvmConstUtf8 &stringUtf16ClassName;
+extern const MjvmConstUtf8 &abstractStringBuilderClassName;
+extern const MjvmConstUtf8 &stringConcatFactoryClassName;
+extern const MjvmConstUtf8 &lambdaMetafactoryClassName;
 extern const MjvmConstUtf8 &characterClassName;
 extern const MjvmConstUtf8 &throwableClassName;
 extern const MjvmConstUtf8 &printStreamClassName;
+extern const MjvmConstUtf8 &unsafeClassName;
+extern const MjvmConstUtf8 &atomicLongClassName;
+extern const MjvmConstUtf8 &forkJoinPoolClassName;
+extern const MjvmConstUtf8 &atomicIntegerClassName;
+extern const MjvmConstUtf8 &atomicReferenceClassName;
+extern const MjvmConstUtf8 &arraysClassName;
+extern const MjvmConstUtf8 &hashMapClassName;
+extern const MjvmConstUtf8 &intIntHashMapClassName;
+extern const MjvmConstUtf8 &integerClassName;
+extern const MjvmConstUtf8 &longClassName;
 extern const MjvmConstUtf8 &nullPtrExcpClassName;
+extern const MjvmConstUtf8 &noClassDefFoundErrorClassName;
 extern const MjvmConstUtf8 &arrayStoreExceptionClassName;
 extern const MjvmConstUtf8 &arithmeticExceptionClassName;
+extern const MjvmConstUtf8 &numberFormatExceptionClassName;
 extern const MjvmConstUtf8 &classNotFoundExceptionClassName;
 extern const MjvmConstUtf8 &cloneNotSupportedExceptionClassName;
 extern const MjvmConstUtf8 &negativeArraySizeExceptionClassName;
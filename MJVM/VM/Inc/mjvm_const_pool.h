@@ -4,6 +4,10 @@
 
 #include "mjvm_types.h"
 
+class MjvmMethodInfo;
+class MjvmLambda;
+class MjvmStringConcat;
+
 #define CONST_UTF8_HASH(utf8)       *(uint32_t *)&(utf8)
 
 class MjvmConstPool {
@@ -51,10 +55,13 @@ public:
     MjvmConstUtf8 &className;
     MjvmConstNameAndType &nameAndType;
 private:
+    void *staticFieldData;
+
     MjvmConstField(MjvmConstUtf8 &className, MjvmConstNameAndType &nameAndType);
     MjvmConstField(const MjvmConstField &) = delete;
     void operator=(const MjvmConstField &) = delete;
 
+    friend class MjvmExecution;
     friend class MjvmClassLoader;
 };
 
@@ -69,6 +76,7 @@ public:
     MjvmConstNameAndType &nameAndType;
 private:
     MjvmParamInfo paramInfo;
+    MjvmMethodInfo *methodInfo;
 public:
     const MjvmParamInfo &getParmInfo(void);
 private:
@@ -78,10 +86,41 @@ private:
     void operator=(const MjvmConstMethod &) = delete;
 
     friend class Mjvm;
+    friend class MjvmLambda;
     friend class MjvmExecution;
+    friend class MjvmTaskWorker;
     friend class MjvmClassLoader;
 };
 
 typedef MjvmConstMethod MjvmConstInterfaceMethod;
 
+class MjvmConstMethodHandle {
+public:
+    const MjvmReferenceKind referenceKind;
+    MjvmConstUtf8 &className;
+    MjvmConstNameAndType &nameAndType;
+private:
+    MjvmConstMethodHandle(MjvmReferenceKind referenceKind, MjvmConstUtf8 &className, MjvmConstNameAndType &nameAndType);
+    MjvmConstMethodHandle(const MjvmConstMethodHandle &) = delete;
+    void operator=(const MjvmConstMethodHandle &) = delete;
+
+    friend class MjvmClassLoader;
+};
+
+class MjvmConstInvokeDynamic {
+public:
+    const uint16_t bootstrapMethodAttrIndex;
+    MjvmConstNameAndType &nameAndType;
+private:
+    MjvmLambda *lambda;
+    MjvmStringConcat *stringConcat;
+
+    MjvmConstInvokeDynamic(uint16_t bootstrapMethodAttrIndex, MjvmConstNameAndType &nameAndType);
+    MjvmConstInvokeDynamic(const MjvmConstInvokeDynamic &) = delete;
+    void operator=(const MjvmConstInvokeDynamic &) = delete;
+
+    friend class MjvmExecution;
+    friend class MjvmClassLoader;
+};
+
 #endif /* __MJVM_CONST_POOL_H */
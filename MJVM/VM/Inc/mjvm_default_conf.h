@@ -12,6 +12,30 @@
     #warning "DEFAULT_STACK_SIZE is not defined. Default value will be used"
 #endif /* DEFAULT_STACK_SIZE */
 
+#ifndef INITIAL_STACK_SIZE
+    #define INITIAL_STACK_SIZE          KILO_BYTE(1)
+    #warning "INITIAL_STACK_SIZE is not defined. Default value will be used"
+#endif /* INITIAL_STACK_SIZE */
+
+#ifndef MAX_OF_FREE_EXECUTION
+    #define MAX_OF_FREE_EXECUTION       4
+    #warning "MAX_OF_FREE_EXECUTION is not defined. Default value will be used"
+#endif /* MAX_OF_FREE_EXECUTION */
+
+#ifndef KEEP_CLASS_IMAGE
+    #define KEEP_CLASS_IMAGE            0
+    #warning "KEEP_CLASS_IMAGE is not defined. Default value will be used"
+#endif /* KEEP_CLASS_IMAGE */
+
+#ifndef LAZY_METHOD_CODE
+    #define LAZY_METHOD_CODE            0
+    #warning "LAZY_METHOD_CODE is not defined. Default value will be used"
+#endif /* LAZY_METHOD_CODE */
+
+#if LAZY_METHOD_CODE && !KEEP_CLASS_IMAGE
+    #error "LAZY_METHOD_CODE needs KEEP_CLASS_IMAGE to be enabled"
+#endif
+
 #ifndef OBJECT_SIZE_TO_GC
     #define OBJECT_SIZE_TO_GC           MEGA_BYTE(1)
     #warning "OBJECT_SIZE_TO_GC is not defined. Default value will be used"
@@ -3,6 +3,7 @@
 #define __MJVM_EXECUTION_H
 
 #include "mjvm_common.h"
+#include "mjvm_system_type.h"
 #include "mjvm_debugger.h"
 #include "mjvm_stack_info.h"
 #include "mjvm_const_pool.h"
@@ -11,13 +12,15 @@
 #define STR_AND_SIZE(str)           str, (sizeof(str) - 1)
 
 class Mjvm;
+class MjvmLambda;
 
 class MjvmExecution {
 public:
     Mjvm &mjvm;
 private:
     const void ** volatile opcodes;
-    const uint32_t stackLength;
+    const uint32_t maxStackLength;
+    uint32_t stackLength;
     MjvmMethodInfo *method;
     const uint8_t *code;
     uint32_t pc;
@@ -25,9 +28,13 @@ private:
     int32_t sp;
     int32_t startSp;
     int32_t peakSp;
+    int32_t concatSp;
     int32_t *stack;
     int32_t *locals;
     uint8_t *stackType;
+    void *completion;
+    volatile bool isFinished;
+    bool isReleaseRequested;
 protected:
     MjvmExecution(Mjvm &mjvm);
     MjvmExecution(Mjvm &mjvm, uint32_t stackSize);
@@ -54,18 +61,22 @@ public:
     double stackPopDouble(void);
     MjvmObject *stackPopObject(void);
 private:
+    void stackEnsureLength(uint32_t length);
+    void stackShrink(void);
     void stackInitExitPoint(uint32_t exitPc);
     void stackRestoreContext(void);
 
     void initNewContext(MjvmMethodInfo &methodInfo, uint16_t argc = 0);
 
     bool invoke(MjvmMethodInfo &methodInfo, uint8_t argc);
-    bool invokeStatic(MjvmConstMethod &constMethod);
+    bool invokeStatic(MjvmMethodInfo &methodInfo, uint8_t argc);
     bool invokeSpecial(MjvmConstMethod &constMethod);
     bool invokeVirtual(MjvmConstMethod &constMethod);
     bool invokeInterface(MjvmConstInterfaceMethod &interfaceMethod, uint8_t argc);
+    bool invokeLambda(MjvmLambda &lambda, uint8_t argc);
 
-    void run(void);
+    void run(MjvmObject *thisObj);
+    void execute(MjvmObject *thisObj);
     bool isRunning(void) const;
     void terminateRequest(void);
     bool getStackTrace(uint32_t index, MjvmStackFrame *stackTrace, bool *isEndStack) const;
@@ -75,9 +86,12 @@ private:
     static void runTask(MjvmExecution *execution);
 public:
     bool run(MjvmMethodInfo &method);
+    bool join(uint32_t timeoutMs = MJVM_WAIT_FOREVER);
 
     friend class Mjvm;
     friend class MjvmDebugger;
+    friend class MjvmTaskPool;
+    friend class MjvmTaskWorker;
 };
 
 #endif /* __MJVM_EXECUTION_H */
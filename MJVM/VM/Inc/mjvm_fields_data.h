@@ -51,15 +51,19 @@ public:
 
     MjvmFieldData32 &getFieldData32(const MjvmConstUtf8 &fieldName) const;
     MjvmFieldData32 &getFieldData32(const MjvmConstNameAndType &fieldNameAndType) const;
+    MjvmFieldData32 &getFieldData32(const MjvmFieldInfo &fieldInfo) const;
     MjvmFieldData64 &getFieldData64(const MjvmConstUtf8 &fieldName) const;
     MjvmFieldData64 &getFieldData64(const MjvmConstNameAndType &fieldNameAndType) const;
+    MjvmFieldData64 &getFieldData64(const MjvmFieldInfo &fieldInfo) const;
     MjvmFieldObject &getFieldObject(const MjvmConstUtf8 &fieldName) const;
     MjvmFieldObject &getFieldObject(const MjvmConstNameAndType &fieldNameAndType) const;
+    MjvmFieldObject &getFieldObject(const MjvmFieldInfo &fieldInfo) const;
 private:
     MjvmFieldData32 *fieldsData32;
     MjvmFieldData64 *fieldsData64;
     MjvmFieldObject *fieldsObject;
 private:
+    MjvmFieldsData(void);
     MjvmFieldsData(Mjvm &mjvm, const MjvmClassLoader &classLoader, bool isStatic);
     MjvmFieldsData(const MjvmFieldsData &) = delete;
     void operator=(const MjvmFieldsData &) = delete;
@@ -71,28 +75,49 @@ private:
 
     friend class Mjvm;
     friend class ClassData;
+    friend class MjvmLambda;
     friend class MjvmExecution;
+    friend class MjvmSnapshot;
 };
 
+typedef enum : uint8_t {
+    CLASS_UNINITIALIZED = 0,
+    CLASS_INITIALIZING,
+    CLASS_INITIALIZED,
+    CLASS_INIT_FAILED,
+} MjvmClassInitState;
+
 class ClassData : public MjvmClassLoader {
 private:
     ClassData *next;
+    ClassData *nextMarked;
+    bool isMarked;
 public:
     uint32_t ownId;
-    uint32_t monitorCount : 31;
-    uint32_t isInitializing : 1;
+    uint32_t monitorCount;
+    volatile MjvmClassInitState initState;
+    uint16_t initWaitCount;
+    uint32_t initOwnId;
+    int32_t initSp;
+    ClassData *initSubclass;
+    void *initSemaphore;
     MjvmFieldsData *staticFiledsData;
 
     ClassData(const char *fileName);
     ClassData(const char *fileName, uint16_t length);
     ClassData(const MjvmConstUtf8 &fileName);
+    ClassData(const MjvmClassArchive &archive, const MjvmArchiveClass &archiveClass);
+    ClassData(const MjvmClassBundle &bundle, const MjvmBundleEntry &entry);
 
     ClassData(const ClassData &) = delete;
     void operator=(const ClassData &) = delete;
 
     ~ClassData(void);
 
+    uint32_t getMemoryUsage(void) const;
+
     friend class Mjvm;
+    friend class MjvmSnapshot;
 };
 
 #endif /* __MJVM_FIELD_DATA_H */
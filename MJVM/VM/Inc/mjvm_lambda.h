@@ -0,0 +1,42 @@
+
+#ifndef __MJVM_LAMBDA_H
+#define __MJVM_LAMBDA_H
+
+#include "mjvm_object.h"
+#include "mjvm_class_loader.h"
+
+class Mjvm;
+
+/*
+ * A call site linked by LambdaMetafactory.
+ * Its objects have the type of the functional interface, the empty fields of the interface
+ * are followed by a pointer to the call site and by the captured arguments.
+ */
+class MjvmLambda {
+public:
+    MjvmClassLoader &classLoader;
+    MjvmConstUtf8 &interfaceName;
+    MjvmConstUtf8 &methodName;
+    MjvmConstMethodHandle &methodHandle;
+    const uint8_t capturedArgc;
+    const uint8_t methodArgc;
+    const bool isVoidMethod;
+private:
+    MjvmMethodInfo *implMethod;
+    uint8_t objectArgs[];
+
+    MjvmLambda(MjvmClassLoader &classLoader, MjvmConstUtf8 &interfaceName, MjvmConstUtf8 &methodName, MjvmConstMethodHandle &methodHandle, uint8_t capturedArgc, uint8_t methodArgc, bool isVoidMethod);
+    MjvmLambda(const MjvmLambda &) = delete;
+    void operator=(const MjvmLambda &) = delete;
+public:
+    bool isObjectArg(uint8_t index) const;
+    MjvmObject *newObject(Mjvm &mjvm, const int32_t *args);
+
+    static MjvmLambda *getLambda(MjvmObject *obj);
+    static const int32_t *getArgs(MjvmObject *obj);
+    static MjvmLambda *link(Mjvm &mjvm, MjvmClassLoader &classLoader, MjvmConstInvokeDynamic &constInvokeDynamic);
+
+    friend class MjvmExecution;
+};
+
+#endif /* __MJVM_LAMBDA_H */
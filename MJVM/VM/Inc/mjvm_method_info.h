@@ -14,7 +14,8 @@ public:
     MjvmConstUtf8 &name;
     MjvmConstUtf8 &descriptor;
 private:
-    MjvmAttribute *attributes;
+    MjvmAttribute * volatile attributes;
+    uint32_t codeOffset;
 
     MjvmMethodInfo(MjvmClassLoader &classLoader, MjvmMethodAccessFlag accessFlag, MjvmConstUtf8 &name, MjvmConstUtf8 &descriptor);
 
@@ -36,6 +36,7 @@ protected:
 
     friend class Mjvm;
     friend class MjvmExecution;
+    friend class MjvmSnapshot;
 };
 
 #endif /* __MJVM_OBJECT_H */
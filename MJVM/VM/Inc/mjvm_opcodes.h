@@ -232,6 +232,18 @@ typedef enum : uint8_t {
     OP_JSRW = 0xC9,
     OP_BREAKPOINT = 0xCA,
 
+    /* quick opcodes, rewritten in place once the referenced class is initialized */
+    OP_GETSTATIC_QUICK_32 = 0xCB,
+    OP_GETSTATIC_QUICK_64 = 0xCC,
+    OP_GETSTATIC_QUICK_OBJ = 0xCD,
+    OP_PUTSTATIC_QUICK_8 = 0xCE,
+    OP_PUTSTATIC_QUICK_16 = 0xCF,
+    OP_PUTSTATIC_QUICK_32 = 0xD0,
+    OP_PUTSTATIC_QUICK_64 = 0xD1,
+    OP_PUTSTATIC_QUICK_OBJ = 0xD2,
+    OP_INVOKESTATIC_QUICK = 0xD3,
+    OP_NEW_QUICK = 0xD4,
+
     OP_EXIT = 0xFF,
 } MjvmOpCode;
 
@@ -0,0 +1,124 @@
+
+#ifndef __MJVM_SNAPSHOT_H
+#define __MJVM_SNAPSHOT_H
+
+#include "mjvm_std_types.h"
+#include "mjvm_const_pool.h"
+
+#define HEAP_SNAPSHOT_MAGIC             0x53484A4D  /* "MJHS" */
+#define HEAP_SNAPSHOT_VERSION           1
+
+#define SNAPSHOT_OBJECT_CONST_STRING    0x01
+#define SNAPSHOT_OBJECT_CONST_CLASS     0x02
+
+/*
+ * All structures are stored little-endian and 4-byte aligned.
+ * Names are offsets into the utf8 table which uses the MjvmConstUtf8 layout.
+ * Objects are referenced by their 1-based index in the object table, 0 is null.
+ * The snapshot does not contain any pointer so it can be restored at any address,
+ * but it is only valid for the same class files it was taken from.
+ */
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t utf8Offset;
+    uint32_t utf8Size;
+    uint32_t classCount;
+    uint32_t classesOffset;
+    uint32_t objectCount;
+    uint32_t objectsOffset;
+    uint32_t size;
+} MjvmSnapshotHeader;
+
+/* Followed by fieldsCount static fields */
+typedef struct {
+    uint32_t name;
+    uint32_t fieldsCount;
+} MjvmSnapshotClass;
+
+/* Followed by the array data (object indexes for arrays of objects) or by size instance fields */
+typedef struct {
+    uint32_t type;
+    uint8_t dimensions;
+    uint8_t flags;
+    uint16_t reserved;
+    uint32_t size;
+} MjvmSnapshotObject;
+
+/* Followed by a 32-bit value, a 64-bit value or an object index depending on the descriptor */
+typedef struct {
+    uint32_t owner;
+    uint32_t name;
+    uint32_t descriptor;
+} MjvmSnapshotField;
+
+typedef struct {
+    uint8_t *data;
+    uint32_t size;
+    uint32_t capacity;
+} MjvmSnapshotBuffer;
+
+typedef struct {
+    const void **keys;
+    uint32_t *values;
+    uint32_t count;
+    uint32_t capacity;
+} MjvmSnapshotMap;
+
+class Mjvm;
+class MjvmObject;
+class MjvmFieldInfo;
+class MjvmFieldsData;
+
+class MjvmSnapshot {
+private:
+    Mjvm &mjvm;
+
+    /* used while saving */
+    MjvmSnapshotBuffer utf8Table;
+    MjvmSnapshotBuffer classTable;
+    MjvmSnapshotBuffer objectTable;
+    MjvmSnapshotMap utf8Map;
+    MjvmSnapshotMap objectMap;
+    uint32_t classCount;
+
+    /* used while restoring */
+    uint8_t *image;
+    uint32_t imageSize;
+    bool isImageMapped;
+
+    MjvmObject **objects;
+    uint8_t *objectFlags;
+    uint32_t objectCount;
+    uint32_t objectCapacity;
+
+    MjvmSnapshot(Mjvm &mjvm);
+    MjvmSnapshot(const MjvmSnapshot &) = delete;
+    void operator=(const MjvmSnapshot &) = delete;
+
+    static void append(MjvmSnapshotBuffer &buff, const void *data, uint32_t size);
+    static uint32_t *findValue(const MjvmSnapshotMap &map, const void *key);
+    static void putValue(MjvmSnapshotMap &map, const void *key, uint32_t value);
+
+    uint32_t addUtf8(const MjvmConstUtf8 &utf8);
+    uint32_t addObject(MjvmObject *obj);
+    void writeField(MjvmSnapshotBuffer &buff, const MjvmFieldInfo &fieldInfo, const void *value, uint8_t size);
+    void writeFields(MjvmSnapshotBuffer &buff, const MjvmFieldsData &fields);
+    void writeObject(MjvmObject *obj, uint8_t flags);
+    void save(const char *fileName);
+
+    const void *read(uint32_t &offset, uint32_t size) const;
+    MjvmConstUtf8 &getUtf8(uint32_t offset) const;
+    MjvmObject *getObject(uint32_t index) const;
+    bool isSameField(const MjvmFieldInfo &fieldInfo, const MjvmSnapshotField &field) const;
+    uint32_t readFields(uint32_t offset, uint32_t fieldsCount, MjvmFieldsData *fields) const;
+    void loadImage(const char *fileName);
+    void restore(const char *fileName);
+
+    ~MjvmSnapshot(void);
+
+    friend class Mjvm;
+};
+
+#endif /* __MJVM_SNAPSHOT_H */
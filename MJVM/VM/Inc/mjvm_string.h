@@ -9,6 +9,7 @@ public:
     const char *getText(void) const;
     uint32_t getLength(void) const;
     uint8_t getCoder(void) const;
+    int32_t getHashCode(void) const;
     bool equals(const char *text, uint32_t length) const;
     bool equals(const MjvmConstUtf8 &utf8) const;
     bool equals(MjvmString &utf8) const;
@@ -20,6 +21,7 @@ public:
     static uint8_t utf8Encode(uint16_t c, char *buff);
     static uint32_t utf8StrLen(const char *utf8);
     static uint32_t getUft8BuffSize(MjvmString &str);
+    static int32_t getHashCode(const MjvmConstUtf8 &utf8);
 protected:
     MjvmString(void) = delete;
     MjvmString(const MjvmString &) = delete;
@@ -29,6 +31,7 @@ protected:
 class MjvmConstString {
 private:
     MjvmConstString *next;
+    MjvmConstString *hashNext;
 public:
     MjvmString &mjvmString;
 private:
@@ -37,6 +40,7 @@ private:
     void operator=(const MjvmConstString &) = delete;
 
     friend class Mjvm;
+    friend class MjvmSnapshot;
 };
 
 #endif /* __MJVM_STRING_H */
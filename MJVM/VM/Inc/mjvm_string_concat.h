@@ -0,0 +1,39 @@
+
+#ifndef __MJVM_STRING_CONCAT_H
+#define __MJVM_STRING_CONCAT_H
+
+#include "mjvm_string.h"
+#include "mjvm_class_loader.h"
+
+class Mjvm;
+
+typedef struct {
+    uint8_t type;                   /* descriptor type of the argument, 0 for a constant text */
+    uint8_t coder;                  /* coder of the constant text */
+    uint16_t slot;                  /* stack slot of the argument counted from the first argument */
+    uint32_t length;                /* length of the constant text */
+    const uint8_t *text;            /* constant text */
+} MjvmConcatPart;
+
+class MjvmStringConcat {
+public:
+    const uint16_t argc;
+private:
+    uint16_t partsCount;
+    uint8_t constCoder;
+    uint32_t constLength;
+    MjvmConcatPart parts[];
+
+    MjvmStringConcat(uint16_t argc);
+    MjvmStringConcat(const MjvmStringConcat &) = delete;
+    void operator=(const MjvmStringConcat &) = delete;
+
+    void addConst(const uint8_t *text, uint32_t length, uint8_t coder, uint8_t *&textBuff);
+public:
+    int32_t findObjectArgument(const int32_t *args) const;
+    MjvmString *concat(Mjvm &mjvm, const int32_t *args) const;
+
+    static MjvmStringConcat *link(Mjvm &mjvm, MjvmClassLoader &classLoader, MjvmConstInvokeDynamic &constInvokeDynamic);
+};
+
+#endif /* __MJVM_STRING_CONCAT_H */
@@ -16,11 +16,18 @@ uint32_t MjvmSystem_FileSize(void *fileHandle);
 uint32_t MjvmSystem_FileTell(void *fileHandle);
 MjvmSys_FileResult MjvmSystem_FileSeek(void *fileHandle, uint32_t offset);
 MjvmSys_FileResult MjvmSystem_FileClose(void *fileHandle);
+void *MjvmSystem_FileMap(void *fileHandle, uint32_t *size);
+void MjvmSystem_FileUnmap(void *addr, uint32_t size);
 
 void *MjvmSystem_ThreadCreate(void (*task)(void *), void *param, uint32_t stackSize = 0);
 void MjvmSystem_ThreadTerminate(void *threadHandle);
 void MjvmSystem_ThreadSleep(uint32_t ms);
 
+void *MjvmSystem_SemaphoreCreate(uint32_t initialCount, uint32_t maxCount);
+bool MjvmSystem_SemaphoreTake(void *semaphoreHandle, uint32_t timeoutMs);
+void MjvmSystem_SemaphoreGive(void *semaphoreHandle);
+void MjvmSystem_SemaphoreDelete(void *semaphoreHandle);
+
 void *MjvmSystem_Malloc(uint32_t size);
 void *MjvmSystem_Realloc(void *p, uint32_t size);
 void MjvmSystem_Free(void *p);
@@ -4,6 +4,8 @@
 
 #include <stdint.h>
 
+#define MJVM_WAIT_FOREVER           0xFFFFFFFF
+
 typedef enum : uint8_t {
     MJVM_FILE_OPEN_EXISTING = 0x00,
     MJVM_FILE_READ = 0x01,
@@ -0,0 +1,84 @@
+
+#ifndef __MJVM_TASK_POOL_H
+#define __MJVM_TASK_POOL_H
+
+#include "mjvm_std_types.h"
+#include "mjvm_object.h"
+#include "mjvm_execution.h"
+
+class Mjvm;
+class MjvmTaskPool;
+
+typedef enum : uint8_t {
+    TASK_POOL_RUNNING = 0,
+    TASK_POOL_SHUTDOWN,
+    TASK_POOL_TERMINATED,
+} MjvmTaskPoolState;
+
+class MjvmTaskWorker {
+private:
+    MjvmTaskPool &pool;
+    MjvmExecution &execution;
+    MjvmObject * volatile currentTask;
+    MjvmObject **tasks;
+    uint32_t capacity;
+    uint32_t head;
+    uint32_t tail;
+
+    MjvmTaskWorker(MjvmTaskPool &pool, MjvmExecution &execution);
+    MjvmTaskWorker(const MjvmTaskWorker &) = delete;
+    void operator=(const MjvmTaskWorker &) = delete;
+
+    uint32_t getTaskCount(void) const;
+    void pushTask(MjvmObject *task);
+    MjvmObject *popTask(bool isFifo);
+
+    ~MjvmTaskWorker(void);
+
+    static void workerTask(MjvmTaskWorker *worker);
+
+    friend class Mjvm;
+    friend class MjvmTaskPool;
+};
+
+class MjvmTaskPool {
+private:
+    MjvmTaskPool *next;
+    Mjvm &mjvm;
+    MjvmObject *owner;
+    volatile MjvmTaskPoolState state;
+    const bool asyncMode;
+    const uint16_t workerCount;
+    volatile uint16_t activeCount;
+    volatile uint32_t pendingCount;
+    uint32_t submitIndex;
+    MjvmTaskWorker *workers;
+    void *taskSemaphore;
+    void *terminatedSemaphore;
+    bool isOwnerCollected;
+
+    MjvmTaskPool(Mjvm &mjvm, uint16_t workerCount, bool asyncMode, MjvmObject *owner);
+    MjvmTaskPool(const MjvmTaskPool &) = delete;
+    void operator=(const MjvmTaskPool &) = delete;
+
+    MjvmObject *takeTask(MjvmTaskWorker &worker);
+    void wakeUpAllWorkers(void);
+    void releaseWorkers(void);
+    void terminate(void);
+
+    ~MjvmTaskPool(void);
+public:
+    uint16_t getWorkerCount(void) const;
+    uint32_t getPendingCount(void) const;
+
+    bool execute(MjvmExecution &caller, MjvmObject *task);
+    void shutdown(void);
+    bool isShutdown(void) const;
+    bool isTerminated(void) const;
+    bool awaitTermination(uint32_t timeoutMs);
+
+    friend class Mjvm;
+    friend class MjvmTaskWorker;
+};
+
+#endif /* __MJVM_TASK_POOL_H */
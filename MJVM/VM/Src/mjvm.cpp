@@ -3,9 +3,59 @@
 #include <string.h>
 #include "mjvm.h"
 #include "mjvm_system_api.h"
+#include "mjvm_lambda.h"
+#include "mjvm_snapshot.h"
+#include "mjvm_class_preloader.h"
+#include "mjvm_native_class.h"
+
+#define CLASS_INIT_WAIT_TIMEOUT     10
 
 static uint32_t objectCount = 0;
 
+typedef struct {
+    MjvmConstUtf8 **buckets;
+    uint32_t capacity;
+    uint32_t count;
+} MjvmTypeSet;
+
+static uint32_t TypeSet_Index(const MjvmTypeSet &set, MjvmConstUtf8 *type) {
+    uint32_t mask = set.capacity - 1;
+    uint32_t index = (((uint32_t)type >> 2) * 2654435761U) & mask;
+    while(set.buckets[index] && set.buckets[index] != type)
+        index = (index + 1) & mask;
+    return index;
+}
+
+static bool TypeSet_Contains(const MjvmTypeSet &set, MjvmConstUtf8 *type) {
+    return set.capacity && set.buckets[TypeSet_Index(set, type)] == type;
+}
+
+/* returns 1 if the type is added, 0 if it is already there and -1 if there is no memory */
+static int8_t TypeSet_Add(MjvmTypeSet &set, MjvmConstUtf8 *type) {
+    if(((set.count + 1) << 1) > set.capacity) {
+        /* called from the garbage collector, the memory must not come from Mjvm::malloc */
+        uint32_t capacity = set.capacity ? (set.capacity << 1) : 64;
+        MjvmConstUtf8 **buckets = (MjvmConstUtf8 **)MjvmSystem_Malloc(capacity * sizeof(MjvmConstUtf8 *));
+        if(buckets == 0)
+            return -1;
+        memset(buckets, 0, capacity * sizeof(MjvmConstUtf8 *));
+        MjvmTypeSet newSet = {buckets, capacity, set.count};
+        for(uint32_t i = 0; i < set.capacity; i++) {
+            if(set.buckets[i])
+                buckets[TypeSet_Index(newSet, set.buckets[i])] = set.buckets[i];
+        }
+        if(set.buckets)
+            MjvmSystem_Free(set.buckets);
+        set = newSet;
+    }
+    uint32_t index = TypeSet_Index(set, type);
+    if(set.buckets[index])
+        return 0;
+    set.buckets[index] = type;
+    set.count++;
+    return 1;
+}
+
 Mjvm Mjvm::mjvmInstance;
 
 MjvmExecutionNode::MjvmExecutionNode(Mjvm &mjvm) : MjvmExecution(mjvm) {
@@ -61,10 +111,22 @@ Mjvm &Mjvm::getInstance(void) {
 Mjvm::Mjvm(void) {
     dbg = 0;
     executionList = 0;
+    freeExecutionList = 0;
+    freeExecutionCount = 0;
+    taskPoolList = 0;
     classDataList = 0;
     objectList = 0;
     constClassList = 0;
     constStringList = 0;
+    constClassTable = 0;
+    constStringTable = 0;
+    constClassTableSize = 0;
+    constStringTableSize = 0;
+    constClassCount = 0;
+    constStringCount = 0;
+    classArchive = 0;
+    classBundle = 0;
+    snapshotUtf8 = 0;
     objectSizeToGc = 0;
 }
 
@@ -76,21 +138,40 @@ void Mjvm::setDebugger(MjvmDebugger *dbg) {
     this->dbg = dbg;
 }
 
-MjvmExecution &Mjvm::newExecution(void) {
-    MjvmExecutionNode *newNode = (MjvmExecutionNode *)Mjvm::malloc(sizeof(MjvmExecutionNode));
+MjvmExecutionNode *Mjvm::takeFreeExecution(uint32_t stackSize) {
+    MjvmExecutionNode *bestFit = 0;
+    uint32_t length = stackSize / sizeof(int32_t);
     lock();
-    newNode->next = executionList;
-    if(executionList)
-        executionList->prev = newNode;
-    executionList = newNode;
+    /* choose the smallest free stack which is large enough */
+    for(MjvmExecutionNode *node = freeExecutionList; node != 0; node = node->next) {
+        if(node->maxStackLength >= length && (bestFit == 0 || node->maxStackLength < bestFit->maxStackLength))
+            bestFit = node;
+    }
+    if(bestFit) {
+        if(bestFit->prev)
+            bestFit->prev->next = bestFit->next;
+        else
+            freeExecutionList = bestFit->next;
+        if(bestFit->next)
+            bestFit->next->prev = bestFit->prev;
+        freeExecutionCount--;
+    }
     unlock();
-    return *new (newNode)MjvmExecutionNode(*this);
+    return bestFit;
+}
+
+MjvmExecution &Mjvm::newExecution(void) {
+    return newExecution(DEFAULT_STACK_SIZE);
 }
 
 MjvmExecution &Mjvm::newExecution(uint32_t stackSize) {
-    MjvmExecutionNode *newNode = (MjvmExecutionNode *)Mjvm::malloc(sizeof(MjvmExecutionNode));
-    new (newNode)MjvmExecutionNode(*this, stackSize);
+    MjvmExecutionNode *newNode = takeFreeExecution(stackSize);
+    if(newNode == 0) {
+        newNode = (MjvmExecutionNode *)Mjvm::malloc(sizeof(MjvmExecutionNode));
+        new (newNode)MjvmExecutionNode(*this, stackSize);
+    }
     lock();
+    newNode->prev = 0;
     newNode->next = executionList;
     if(executionList)
         executionList->prev = newNode;
@@ -99,6 +180,51 @@ MjvmExecution &Mjvm::newExecution(uint32_t stackSize) {
     return *newNode;
 }
 
+void Mjvm::releaseExecution(MjvmExecution &execution) {
+    lock();
+    releaseExecutionLocked(execution);
+    unlock();
+}
+
+/* same as releaseExecution but the caller already holds the lock */
+void Mjvm::releaseExecutionLocked(MjvmExecution &execution) {
+    MjvmExecutionNode *node = (MjvmExecutionNode *)&execution;
+    if(!node->isFinished) {
+        /* the execution is still running, it will be released when it finishes */
+        node->isReleaseRequested = true;
+        return;
+    }
+    node->isReleaseRequested = false;
+    if(node->prev)
+        node->prev->next = node->next;
+    else
+        executionList = node->next;
+    if(node->next)
+        node->next->prev = node->prev;
+    if(freeExecutionCount < MAX_OF_FREE_EXECUTION) {
+        node->stackShrink();
+        node->prev = 0;
+        node->next = freeExecutionList;
+        if(freeExecutionList)
+            freeExecutionList->prev = node;
+        freeExecutionList = node;
+        freeExecutionCount++;
+        return;
+    }
+    node->~MjvmExecution();
+    Mjvm::free(node);
+}
+
+MjvmTaskPool &Mjvm::newTaskPool(uint16_t workerCount, bool asyncMode, MjvmObject *owner) {
+    MjvmTaskPool *newPool = (MjvmTaskPool *)Mjvm::malloc(sizeof(MjvmTaskPool));
+    new (newPool)MjvmTaskPool(*this, workerCount, asyncMode, owner);
+    lock();
+    newPool->next = taskPoolList;
+    taskPoolList = newPool;
+    unlock();
+    return *newPool;
+}
+
 MjvmObject *Mjvm::newObject(uint32_t size, MjvmConstUtf8 &type, uint8_t dimensions) {
     objectSizeToGc += size;
     if(objectSizeToGc >= OBJECT_SIZE_TO_GC)
@@ -170,37 +296,88 @@ MjvmClass *Mjvm::newClass(const char *typeName, uint16_t length) {
     return newClass(*name);
 }
 
+static bool ConstClass_IsNameEquals(MjvmString &name, const char *typeName, uint16_t length) {
+    /* the name of the class object uses '.' where the type name has '/' */
+    if(name.getCoder() != 0 || name.getLength() != length)
+        return false;
+    const char *text = name.getText();
+    for(uint32_t i = 0; i < length; i++) {
+        if(text[i] != ((typeName[i] == '/') ? '.' : typeName[i]))
+            return false;
+    }
+    return true;
+}
+
 MjvmClass *Mjvm::getConstClass(const char *typeName, uint16_t length) {
-    for(MjvmConstClass *node = constClassList; node != 0; node = node->next) {
-        if(node->mjvmClass.getName().equals(typeName, length))
-            return &node->mjvmClass;
+    uint32_t hash = 0;
+    for(uint32_t i = 0; i < length; i++)
+        hash = hash * 31 + (uint8_t)((typeName[i] == '/') ? '.' : typeName[i]);
+    if(constClassTableSize) {
+        for(MjvmConstClass *node = constClassTable[hash & (constClassTableSize - 1)]; node != 0; node = node->hashNext) {
+            MjvmString &name = node->mjvmClass.getName();
+            if((uint32_t)name.getHashCode() == hash && ConstClass_IsNameEquals(name, typeName, length))
+                return &node->mjvmClass;
+        }
     }
     MjvmClass *classObj = newClass(typeName, length);
-    MjvmConstClass *newNode = (MjvmConstClass *)Mjvm::malloc(sizeof(MjvmConstClass));
-    new (newNode)MjvmConstClass(*classObj);
-
-    newNode->next = constClassList;
-    constClassList = newNode;
-
+    addConstClass(*classObj);
     return classObj;
 }
 
 MjvmClass *Mjvm::getConstClass(MjvmString &str) {
-    for(MjvmConstClass *node = constClassList; node != 0; node = node->next) {
-        if(node->mjvmClass.getName().equals(str))
-            return &node->mjvmClass;
+    int32_t hash = str.getHashCode();
+    if(constClassTableSize) {
+        for(MjvmConstClass *node = constClassTable[hash & (constClassTableSize - 1)]; node != 0; node = node->hashNext) {
+            MjvmString &name = node->mjvmClass.getName();
+            if(name.getHashCode() == hash && name.equals(str))
+                return &node->mjvmClass;
+        }
     }
     MjvmClass *classObj = newClass(str);
+    addConstClass(*classObj);
+    return classObj;
+}
+
+void Mjvm::addConstClass(MjvmClass &classObj) {
+    /* the table doubles when it is 3/4 full, all nodes are still in constClassList for rehashing */
+    if(constClassCount >= (constClassTableSize - (constClassTableSize >> 2))) {
+        uint32_t newSize = constClassTableSize ? (constClassTableSize << 1) : 64;
+        MjvmConstClass **newTable = (MjvmConstClass **)Mjvm::malloc(newSize * sizeof(MjvmConstClass *));
+        memset(newTable, 0, newSize * sizeof(MjvmConstClass *));
+        for(MjvmConstClass *node = constClassList; node != 0; node = node->next) {
+            uint32_t index = node->mjvmClass.getName().getHashCode() & (newSize - 1);
+            node->hashNext = newTable[index];
+            newTable[index] = node;
+        }
+        if(constClassTable)
+            Mjvm::free(constClassTable);
+        constClassTable = newTable;
+        constClassTableSize = newSize;
+    }
     MjvmConstClass *newNode = (MjvmConstClass *)Mjvm::malloc(sizeof(MjvmConstClass));
-    new (newNode)MjvmConstClass(*classObj);
+    new (newNode)MjvmConstClass(classObj);
 
     newNode->next = constClassList;
     constClassList = newNode;
 
-    return classObj;
+    uint32_t index = classObj.getName().getHashCode() & (constClassTableSize - 1);
+    newNode->hashNext = constClassTable[index];
+    constClassTable[index] = newNode;
+    constClassCount++;
 }
 
-MjvmString *Mjvm::newString(uint16_t length, uint8_t coder) {
+void Mjvm::removeConstClassHash(MjvmConstClass *node) {
+    uint32_t index = node->mjvmClass.getName().getHashCode() & (constClassTableSize - 1);
+    for(MjvmConstClass **link = &constClassTable[index]; *link != 0; link = &(*link)->hashNext) {
+        if(*link == node) {
+            *link = node->hashNext;
+            constClassCount--;
+            return;
+        }
+    }
+}
+
+MjvmString *Mjvm::newString(uint32_t length, uint8_t coder) {
     /* create new byte array to store string */
     MjvmObject *byteArray = newObject(length << (coder ? 1 : 0), *(MjvmConstUtf8 *)primTypeConstUtf8List[4], 1);
 
@@ -298,24 +475,45 @@ MjvmString *Mjvm::newString(const char *latin1Str[], uint16_t count) {
 }
 
 MjvmString *Mjvm::getConstString(MjvmConstUtf8 &utf8) {
-    for(MjvmConstString *node = constStringList; node != 0; node = node->next) {
-        if(node->mjvmString.equals(utf8))
-            return &node->mjvmString;
+    /* comparing the cached hashes first avoids decoding the utf8 text for each string in the bucket */
+    int32_t hash = MjvmString::getHashCode(utf8);
+    if(constStringTableSize) {
+        for(MjvmConstString *node = constStringTable[hash & (constStringTableSize - 1)]; node != 0; node = node->hashNext) {
+            if(node->mjvmString.getHashCode() == hash && node->mjvmString.equals(utf8))
+                return &node->mjvmString;
+        }
     }
     MjvmString *strObj = newString(utf8.text, utf8.length, true);
-    MjvmConstString *newNode = (MjvmConstString *)Mjvm::malloc(sizeof(MjvmConstString));
-    new (newNode)MjvmConstString(*strObj);
-
-    newNode->next = constStringList;
-    constStringList = newNode;
-
+    addConstString(*strObj);
     return strObj;
 }
 
 MjvmString *Mjvm::getConstString(MjvmString &str) {
-    for(MjvmConstString *node = constStringList; node != 0; node = node->next) {
-        if(node->mjvmString.equals(str))
-            return &node->mjvmString;
+    int32_t hash = str.getHashCode();
+    if(constStringTableSize) {
+        for(MjvmConstString *node = constStringTable[hash & (constStringTableSize - 1)]; node != 0; node = node->hashNext) {
+            if(node->mjvmString.getHashCode() == hash && node->mjvmString.equals(str))
+                return &node->mjvmString;
+        }
+    }
+    addConstString(str);
+    return &str;
+}
+
+void Mjvm::addConstString(MjvmString &str) {
+    if(constStringCount >= (constStringTableSize - (constStringTableSize >> 2))) {
+        uint32_t newSize = constStringTableSize ? (constStringTableSize << 1) : 64;
+        MjvmConstString **newTable = (MjvmConstString **)Mjvm::malloc(newSize * sizeof(MjvmConstString *));
+        memset(newTable, 0, newSize * sizeof(MjvmConstString *));
+        for(MjvmConstString *node = constStringList; node != 0; node = node->next) {
+            uint32_t index = node->mjvmString.getHashCode() & (newSize - 1);
+            node->hashNext = newTable[index];
+            newTable[index] = node;
+        }
+        if(constStringTable)
+            Mjvm::free(constStringTable);
+        constStringTable = newTable;
+        constStringTableSize = newSize;
     }
     MjvmConstString *newNode = (MjvmConstString *)Mjvm::malloc(sizeof(MjvmConstString));
     new (newNode)MjvmConstString(str);
@@ -323,7 +521,21 @@ MjvmString *Mjvm::getConstString(MjvmString &str) {
     newNode->next = constStringList;
     constStringList = newNode;
 
-    return &str;
+    uint32_t index = str.getHashCode() & (constStringTableSize - 1);
+    newNode->hashNext = constStringTable[index];
+    constStringTable[index] = newNode;
+    constStringCount++;
+}
+
+void Mjvm::removeConstStringHash(MjvmConstString *node) {
+    uint32_t index = node->mjvmString.getHashCode() & (constStringTableSize - 1);
+    for(MjvmConstString **link = &constStringTable[index]; *link != 0; link = &(*link)->hashNext) {
+        if(*link == node) {
+            *link = node->hashNext;
+            constStringCount--;
+            return;
+        }
+    }
 }
 
 MjvmThrowable *Mjvm::newThrowable(MjvmString *strObj, MjvmConstUtf8 &excpType) {
@@ -372,6 +584,10 @@ MjvmThrowable *Mjvm::newUnsupportedOperationException(MjvmString *strObj) {
     return newThrowable(strObj, *(MjvmConstUtf8 *)&unsupportedOperationExceptionClassName);
 }
 
+MjvmThrowable *Mjvm::newNoClassDefFoundError(MjvmString *strObj) {
+    return newThrowable(strObj, *(MjvmConstUtf8 *)&noClassDefFoundErrorClassName);
+}
+
 void Mjvm::freeAllObject(void) {
     for(MjvmConstClass *node = constClassList; node != 0;) {
         MjvmConstClass *next = node->next;
@@ -383,6 +599,18 @@ void Mjvm::freeAllObject(void) {
         Mjvm::free(node);
         node = next;
     }
+    constClassList = 0;
+    constStringList = 0;
+    if(constClassTable)
+        Mjvm::free(constClassTable);
+    if(constStringTable)
+        Mjvm::free(constStringTable);
+    constClassTable = 0;
+    constStringTable = 0;
+    constClassTableSize = 0;
+    constStringTableSize = 0;
+    constClassCount = 0;
+    constStringCount = 0;
     for(MjvmObject *node = objectList; node != 0;) {
         MjvmObject *next = node->next;
         if(node->dimensions == 0) {
@@ -412,6 +640,15 @@ void Mjvm::clearProtectObjectNew(MjvmObject *obj) {
             if(tmp && (tmp->getProtected() & 0x02))
                 clearProtectObjectNew(tmp);
         }
+        MjvmLambda *lambda = MjvmLambda::getLambda(obj);
+        if(lambda) {
+            const int32_t *args = MjvmLambda::getArgs(obj);
+            for(uint8_t i = 0; i < lambda->capturedArgc; i++) {
+                MjvmObject *tmp = lambda->isObjectArg(i) ? (MjvmObject *)args[i] : 0;
+                if(tmp && (tmp->getProtected() & 0x02))
+                    clearProtectObjectNew(tmp);
+            }
+        }
     }
     obj->clearProtected();
 }
@@ -433,27 +670,54 @@ void Mjvm::garbageCollectionProtectObject(MjvmObject *obj) {
             if(tmp && !tmp->getProtected())
                 garbageCollectionProtectObject(tmp);
         }
+        /* the arguments captured by a lambda are not fields */
+        MjvmLambda *lambda = MjvmLambda::getLambda(obj);
+        if(lambda) {
+            const int32_t *args = MjvmLambda::getArgs(obj);
+            for(uint8_t i = 0; i < lambda->capturedArgc; i++) {
+                MjvmObject *tmp = lambda->isObjectArg(i) ? (MjvmObject *)args[i] : 0;
+                if(tmp && !tmp->getProtected())
+                    garbageCollectionProtectObject(tmp);
+            }
+        }
     }
     obj->setProtected();
 }
 
-void Mjvm::garbageCollection(void) {
+void Mjvm::garbageCollection(bool isUnloadClasses) {
     Mjvm::lock();
     objectSizeToGc = 0;
-    for(MjvmConstClass *node = constClassList; node != 0; node = node->next) {
-        if(!node->mjvmClass.getProtected())
-            garbageCollectionProtectObject(&node->mjvmClass);
-    }
-    for(MjvmConstString *node = constStringList; node != 0; node = node->next) {
-        if(!node->mjvmString.getProtected())
-            garbageCollectionProtectObject(&node->mjvmString);
+    /* the interpreter and the debugger keep references to the classes, they are only unloaded when nothing runs */
+    isUnloadClasses = isUnloadClasses && (dbg == 0) && isIdle();
+    if(!isUnloadClasses) {
+        for(MjvmConstClass *node = constClassList; node != 0; node = node->next) {
+            if(!node->mjvmClass.getProtected())
+                garbageCollectionProtectObject(&node->mjvmClass);
+        }
+        for(MjvmConstString *node = constStringList; node != 0; node = node->next) {
+            if(!node->mjvmString.getProtected())
+                garbageCollectionProtectObject(&node->mjvmString);
+        }
+        for(ClassData *node = classDataList; node != 0; node = node->next) {
+            MjvmFieldsData *fieldsData = node->staticFiledsData;
+            if(fieldsData && fieldsData->fieldsObjCount) {
+                for(uint32_t i = 0; i < fieldsData->fieldsObjCount; i++) {
+                    MjvmObject *obj = fieldsData->fieldsObject[i].object;
+                    if(obj && !obj->getProtected())
+                        garbageCollectionProtectObject(obj);
+                }
+            }
+        }
     }
-    for(ClassData *node = classDataList; node != 0; node = node->next) {
-        MjvmFieldsData *fieldsData = node->staticFiledsData;
-        if(fieldsData && fieldsData->fieldsObjCount) {
-            for(uint32_t i = 0; i < fieldsData->fieldsObjCount; i++) {
-                MjvmObject *obj = fieldsData->fieldsObject[i].object;
-                if(obj && !obj->getProtected())
+    for(MjvmTaskPool *pool = taskPoolList; pool != 0; pool = pool->next) {
+        for(uint16_t i = 0; i < pool->workerCount; i++) {
+            MjvmTaskWorker &worker = pool->workers[i];
+            MjvmObject *obj = worker.currentTask;
+            if(obj && !obj->getProtected())
+                garbageCollectionProtectObject(obj);
+            for(uint32_t j = worker.head; j != worker.tail; j++) {
+                obj = worker.tasks[j & (worker.capacity - 1)];
+                if(!obj->getProtected())
                     garbageCollectionProtectObject(obj);
             }
         }
@@ -467,6 +731,9 @@ void Mjvm::garbageCollection(void) {
             }
         }
     }
+    if(isUnloadClasses)
+        unloadClasses();
+    garbageCollectionTaskPools();
     for(MjvmObject *node = objectList; node != 0;) {
         MjvmObject *next = node->next;
         uint8_t prot = node->getProtected();
@@ -491,6 +758,302 @@ void Mjvm::garbageCollection(void) {
     Mjvm::unlock();
 }
 
+/*
+ * A pool whose owner object is collected is shut down, its queued tasks still run before the workers exit.
+ * It is freed by a later collection once all of its workers have exited.
+ */
+void Mjvm::garbageCollectionTaskPools(void) {
+    for(MjvmTaskPool *pool = taskPoolList, *prev = 0; pool != 0;) {
+        MjvmTaskPool *next = pool->next;
+        if(pool->owner && !pool->owner->getProtected()) {
+            pool->owner = 0;
+            pool->isOwnerCollected = true;
+            pool->shutdown();
+        }
+        if(pool->isOwnerCollected && pool->state == TASK_POOL_TERMINATED) {
+            if(prev)
+                prev->next = next;
+            else
+                taskPoolList = next;
+            pool->~MjvmTaskPool();
+            Mjvm::free(pool);
+        }
+        else
+            prev = pool;
+        pool = next;
+    }
+}
+
+bool Mjvm::isIdle(void) const {
+    for(MjvmExecutionNode *node = executionList; node != 0; node = node->next) {
+        if(node->isRunning())
+            return false;
+    }
+    for(MjvmTaskPool *pool = taskPoolList; pool != 0; pool = pool->next) {
+        if(pool->pendingCount)
+            return false;
+    }
+    return true;
+}
+
+void Mjvm::markClass(ClassData &classData, ClassData *&markedList) {
+    if(classData.isMarked)
+        return;
+    classData.isMarked = true;
+    classData.nextMarked = markedList;
+    markedList = &classData;
+}
+
+void Mjvm::markClass(const char *className, uint16_t length, ClassData *&markedList) {
+    /* an array only needs its element class */
+    if(length && className[0] == '[') {
+        while(length && className[0] == '[') {
+            className++;
+            length--;
+        }
+        if(length < 3 || className[0] != 'L' || className[length - 1] != ';')
+            return;
+        className++;
+        length -= 2;
+    }
+    ClassData *classData = findClassData(className, length);
+    if(classData)
+        markClass(*classData, markedList);
+}
+
+void Mjvm::unloadClasses(void) {
+    ClassData *markedList = 0;
+    for(ClassData *node = classDataList; node != 0; node = node->next)
+        node->isMarked = false;
+    for(ClassData *node = classDataList; node != 0; node = node->next) {
+        if(node->initState == CLASS_INITIALIZING || node->initWaitCount || node->monitorCount || !node->isUnloadable())
+            markClass(*node, markedList);
+    }
+
+    MjvmTypeSet types = {0, 0, 0};
+    bool isMarkAll = false;
+    for(;;) {
+        /* the static fields of a live class are live, so are the classes and the strings it references */
+        while(markedList) {
+            ClassData *classData = markedList;
+            markedList = classData->nextMarked;
+            MjvmFieldsData *fieldsData = classData->staticFiledsData;
+            if(fieldsData) {
+                for(uint32_t i = 0; i < fieldsData->fieldsObjCount; i++) {
+                    MjvmObject *obj = fieldsData->fieldsObject[i].object;
+                    if(obj && !obj->getProtected())
+                        garbageCollectionProtectObject(obj);
+                }
+            }
+            uint16_t poolCount = classData->getConstPoolCount();
+            for(uint16_t i = 1; i <= poolCount; i++) {
+                MjvmConstPool &constPool = classData->getConstPool(i);
+                if((constPool.tag & 0x7F) == CONST_CLASS) {
+                    MjvmConstUtf8 &className = classData->getConstUtf8Class(constPool);
+                    markClass(className.text, className.length, markedList);
+                }
+                else if(constPool.tag == CONST_STRING) {
+                    MjvmObject *obj = (MjvmObject *)constPool.value;
+                    if(!obj->getProtected())
+                        garbageCollectionProtectObject(obj);
+                }
+                else if(constPool.tag == CONST_LONG || constPool.tag == CONST_DOUBLE)
+                    i++;
+            }
+        }
+        if(isMarkAll)
+            break;
+
+        /* a live object needs its class, and the class whose const pool holds its type name */
+        for(MjvmObject *obj = objectList; obj != 0; obj = obj->next) {
+            if(!obj->getProtected())
+                continue;
+            if(obj->dimensions == 0 && obj->type == classClassName) {
+                ClassData *classData = findClassData(((MjvmClass *)obj)->getName());
+                if(classData)
+                    markClass(*classData, markedList);
+            }
+            /* the call site of a lambda lives in the const pool of its class */
+            MjvmLambda *lambda = MjvmLambda::getLambda(obj);
+            if(lambda)
+                markClass(*(ClassData *)&lambda->classLoader, markedList);
+            int8_t ret = TypeSet_Add(types, &obj->type);
+            if(ret < 0) {
+                isMarkAll = true;
+                break;
+            }
+            else if(ret > 0)
+                markClass(obj->type.text, obj->type.length, markedList);
+        }
+        if(isMarkAll) {
+            for(ClassData *node = classDataList; node != 0; node = node->next)
+                markClass(*node, markedList);
+            continue;
+        }
+        for(ClassData *node = classDataList; node != 0; node = node->next) {
+            if(node->isMarked)
+                continue;
+            uint16_t poolCount = node->getConstPoolCount();
+            for(uint16_t i = 1; i <= poolCount; i++) {
+                MjvmConstPool &constPool = node->getConstPool(i);
+                if(constPool.tag == CONST_UTF8 && TypeSet_Contains(types, (MjvmConstUtf8 *)constPool.value)) {
+                    markClass(*node, markedList);
+                    break;
+                }
+                else if(constPool.tag == CONST_LONG || constPool.tag == CONST_DOUBLE)
+                    i++;
+            }
+        }
+        if(markedList == 0)
+            break;
+    }
+    if(types.buckets)
+        MjvmSystem_Free(types.buckets);
+
+    /* the class object of an unloaded class is dropped unless something still references it */
+    for(MjvmConstClass *node = constClassList, *prev = 0; node != 0;) {
+        MjvmConstClass *next = node->next;
+        if(!node->mjvmClass.getProtected()) {
+            ClassData *classData = findClassData(node->mjvmClass.getName());
+            if(classData && !classData->isMarked) {
+                if(prev)
+                    prev->next = next;
+                else
+                    constClassList = next;
+                removeConstClassHash(node);
+                Mjvm::free(node);
+                node = next;
+                continue;
+            }
+            garbageCollectionProtectObject(&node->mjvmClass);
+        }
+        prev = node;
+        node = next;
+    }
+    /* the string literals of the live classes have been marked above, the other ones can go */
+    for(MjvmConstString *node = constStringList, *prev = 0; node != 0;) {
+        MjvmConstString *next = node->next;
+        if(!node->mjvmString.getProtected()) {
+            if(prev)
+                prev->next = next;
+            else
+                constStringList = next;
+            removeConstStringHash(node);
+            Mjvm::free(node);
+        }
+        else
+            prev = node;
+        node = next;
+    }
+
+    for(ClassData *node = classDataList, *prev = 0; node != 0;) {
+        ClassData *next = node->next;
+        if(!node->isMarked) {
+            if(prev)
+                prev->next = next;
+            else
+                classDataList = next;
+            node->~ClassData();
+            Mjvm::free(node);
+        }
+        else
+            prev = node;
+        node = next;
+    }
+}
+
+uint32_t Mjvm::getClassMemoryUsage(void) const {
+    Mjvm::lock();
+    uint32_t size = 0;
+    for(ClassData *node = classDataList; node != 0; node = node->next)
+        size += node->getMemoryUsage();
+    Mjvm::unlock();
+    return size;
+}
+
+uint32_t Mjvm::getClassMemoryUsage(MjvmClassLoader &classLoader) const {
+    return ((ClassData &)classLoader).getMemoryUsage();
+}
+
+ClassData *Mjvm::newClassData(const char *className, uint16_t length) {
+    const MjvmArchiveClass *archiveClass = classArchive ? classArchive->findClass(className, length) : 0;
+    const MjvmBundleEntry *bundleEntry = (!archiveClass && classBundle) ? classBundle->findClass(className, length) : 0;
+    ClassData *classData = (ClassData *)Mjvm::malloc(sizeof(ClassData));
+    memset((void *)classData, 0, sizeof(ClassData));
+    try {
+        if(archiveClass)
+            new (classData)ClassData(*classArchive, *archiveClass);
+        else if(bundleEntry)
+            new (classData)ClassData(*classBundle, *bundleEntry);
+        else
+            new (classData)ClassData(className, length);
+    }
+    catch(const char *msg) {
+        classData->~ClassData();
+        Mjvm::free(classData);
+        throw msg;
+    }
+    catch(MjvmOutOfMemoryError *err) {
+        classData->~ClassData();
+        Mjvm::free(classData);
+        throw err;
+    }
+    return classData;
+}
+
+ClassData *Mjvm::findClassData(const char *className, uint16_t length) const {
+    for(ClassData *node = classDataList; node != 0; node = node->next) {
+        MjvmConstUtf8 &name = node->getThisClass();
+        if(name.length == length && strncmp(name.text, className, length) == 0)
+            return node;
+    }
+    return 0;
+}
+
+ClassData *Mjvm::findClassData(MjvmString &className) const {
+    /* the name of a class object uses '.' as the package separator */
+    uint32_t length = className.getLength();
+    if(className.getCoder() != 0)
+        return 0;
+    const char *text = className.getText();
+    for(ClassData *node = classDataList; node != 0; node = node->next) {
+        MjvmConstUtf8 &name = node->getThisClass();
+        if(name.length != length)
+            continue;
+        uint32_t i = 0;
+        while(i < length && (text[i] == name.text[i] || (text[i] == '.' && name.text[i] == '/')))
+            i++;
+        if(i == length)
+            return node;
+    }
+    return 0;
+}
+
+ClassData *Mjvm::preload(const char *className, uint16_t length) {
+    Mjvm::lock();
+    ClassData *classData = findClassData(className, length);
+    Mjvm::unlock();
+    if(classData)
+        return classData;
+
+    /* parse without holding the lock so that several classes can be parsed at the same time */
+    ClassData *newNode = newClassData(className, length);
+    Mjvm::lock();
+    classData = findClassData(className, length);
+    if(classData == 0) {
+        newNode->next = classDataList;
+        classDataList = newNode;
+        classData = newNode;
+        newNode = 0;
+    }
+    Mjvm::unlock();
+    if(newNode) {
+        newNode->~ClassData();
+        Mjvm::free(newNode);
+    }
+    return classData;
+}
+
 MjvmClassLoader &Mjvm::load(const char *className, uint16_t length) {
     Mjvm::lock();
     ClassData *newNode = 0;
@@ -505,9 +1068,7 @@ MjvmClassLoader &Mjvm::load(const char *className, uint16_t length) {
                     return *node;
             }
         }
-        newNode = (ClassData *)Mjvm::malloc(sizeof(ClassData));
-        memset((void *)newNode, 0, sizeof(ClassData));
-        new (newNode)ClassData(className, length);
+        newNode = newClassData(className, length);
         newNode->next = classDataList;
         classDataList = newNode;
         Mjvm::unlock();
@@ -537,9 +1098,7 @@ MjvmClassLoader &Mjvm::load(MjvmConstUtf8 &className) {
             if(hash == CONST_UTF8_HASH(name) && strncmp(name.text, className.text, className.length) == 0)
                 return *node;
         }
-        newNode = (ClassData *)Mjvm::malloc(sizeof(ClassData));
-        memset((void *)newNode, 0, sizeof(ClassData));
-        new (newNode)ClassData(className.text, className.length);
+        newNode = newClassData(className.text, className.length);
         newNode->next = classDataList;
         classDataList = newNode;
         Mjvm::unlock();
@@ -569,6 +1128,60 @@ void Mjvm::initStaticField(ClassData &classData) {
     classData.staticFiledsData = fieldsData;
 }
 
+void Mjvm::finishClassInit(ClassData &classData, bool isSucceeded) {
+    lock();
+    /* a subclass without static constructor finishes together with its superclass, after it */
+    for(ClassData *node = &classData; node != 0;) {
+        ClassData *next = node->initSubclass;
+        node->initSubclass = 0;
+        node->initState = isSucceeded ? CLASS_INITIALIZED : CLASS_INIT_FAILED;
+        node->initOwnId = 0;
+        node->initSp = -1;
+        /* wake up the executions which are waiting for this class */
+        for(; node->initWaitCount > 0; node->initWaitCount--)
+            MjvmSystem_SemaphoreGive(node->initSemaphore);
+        node = next;
+    }
+    unlock();
+}
+
+/* gives back a class which was claimed for initialization but not started, the waiters try again */
+void Mjvm::cancelClassInit(ClassData &classData) {
+    lock();
+    classData.initSubclass = 0;
+    classData.initState = CLASS_UNINITIALIZED;
+    classData.initOwnId = 0;
+    classData.initSp = -1;
+    for(; classData.initWaitCount > 0; classData.initWaitCount--)
+        MjvmSystem_SemaphoreGive(classData.initSemaphore);
+    unlock();
+}
+
+void Mjvm::waitClassInit(ClassData &classData) {
+    lock();
+    if(classData.initState != CLASS_INITIALIZING) {
+        unlock();
+        return;
+    }
+    if(classData.initSemaphore == 0) {
+        classData.initSemaphore = MjvmSystem_SemaphoreCreate(0, 0xFFFF);
+        if(classData.initSemaphore == 0) {
+            unlock();
+            MjvmSystem_ThreadSleep(1);
+            return;
+        }
+    }
+    classData.initWaitCount++;
+    unlock();
+    /* wait with a bounded timeout so that a termination request can still be served */
+    if(!MjvmSystem_SemaphoreTake(classData.initSemaphore, CLASS_INIT_WAIT_TIMEOUT)) {
+        lock();
+        if(classData.initWaitCount > 0 && classData.initState == CLASS_INITIALIZING)
+            classData.initWaitCount--;
+        unlock();
+    }
+}
+
 MjvmMethodInfo &Mjvm::findMethod(MjvmConstMethod &constMethod) {
     MjvmClassLoader *loader = &load(constMethod.className);
     while(loader) {
@@ -583,6 +1196,33 @@ MjvmMethodInfo &Mjvm::findMethod(MjvmConstMethod &constMethod) {
     throw "can't find the method";
 }
 
+static bool isClassNameEquals(const char *text, uint32_t length, const MjvmConstUtf8 &name) {
+    if(length != name.length)
+        return false;
+    const char *text2 = name.text;
+    for(uint32_t i = 0; i < length; i++) {
+        if(text[i] == text2[i])
+            continue;
+        else if((text[i] == '.' && text2[i] == '/') || (text[i] == '/' && text2[i] == '.'))
+            continue;
+        return false;
+    }
+    return true;
+}
+
+bool Mjvm::isImplementationOf(MjvmClassLoader &classLoader, const char *text, uint16_t length) {
+    /* the interfaces of the super interfaces are searched too */
+    uint16_t interfacesCount = classLoader.getInterfacesCount();
+    for(uint16_t i = 0; i < interfacesCount; i++) {
+        MjvmConstUtf8 &interfaceName = classLoader.getInterface(i);
+        if(isClassNameEquals(text, length, interfaceName))
+            return true;
+        if(isImplementationOf(load(interfaceName), text, length))
+            return true;
+    }
+    return false;
+}
+
 bool Mjvm::isInstanceof(MjvmObject *obj, const char *typeName, uint16_t length) {
     const char *text = typeName;
     while(*text == '[')
@@ -593,46 +1233,201 @@ bool Mjvm::isInstanceof(MjvmObject *obj, const char *typeName, uint16_t length)
         text++;
         len -= 2;
     }
-    if(len == 16 && obj->dimensions >= dimensions) {
-        bool isEquals = true;
-        const char *text2 = objectClassName.text;
-        for(uint32_t i = 0; i < len; i++) {
-            if(text[i] == text2[i])
-                continue;
-            else if((text[i] == '.' && text2[i] == '/') || (text[i] == '/' && text2[i] == '.'))
-                continue;
-            isEquals = false;
-            break;
-        }
-        if(isEquals)
-            return true;
-    }
+    if(obj->dimensions >= dimensions && isClassNameEquals(text, len, objectClassName))
+        return true;
     if(dimensions != obj->dimensions)
         return false;
     else {
         MjvmConstUtf8 *objType = &obj->type;
         while(1) {
-            if(len == objType->length) {
-                bool isEquals = true;
-                const char *text2 = objType->text;
-                for(uint32_t i = 0; i < len; i++) {
-                    if(text[i] == text2[i])
-                        continue;
-                    else if((text[i] == '.' && text2[i] == '/') || (text[i] == '/' && text2[i] == '.'))
-                        continue;
-                    isEquals = false;
-                    break;
-                }
-                if(isEquals)
-                    return true;
-            }
-            objType = &load(*objType).getSuperClass();
+            if(isClassNameEquals(text, len, *objType))
+                return true;
+            if(obj->dimensions && MjvmObject::isPrimType(*objType))
+                return false;
+            MjvmClassLoader &loader = load(*objType);
+            if(isImplementationOf(loader, text, len))
+                return true;
+            objType = &loader.getSuperClass();
             if(objType == 0)
                 return false;
         }
     }
 }
 
+void Mjvm::openClassArchive(const char *fileName) {
+    Mjvm::lock();
+    if(classArchive) {
+        Mjvm::unlock();
+        throw "class archive is already opened";
+    }
+    try {
+        MjvmClassArchive *archive = (MjvmClassArchive *)Mjvm::malloc(sizeof(MjvmClassArchive));
+        try {
+            new (archive)MjvmClassArchive(fileName);
+        }
+        catch(const char *msg) {
+            Mjvm::free(archive);
+            throw msg;
+        }
+        catch(MjvmOutOfMemoryError *err) {
+            Mjvm::free(archive);
+            throw err;
+        }
+        classArchive = archive;
+    }
+    catch(const char *msg) {
+        Mjvm::unlock();
+        throw msg;
+    }
+    catch(MjvmOutOfMemoryError *err) {
+        Mjvm::unlock();
+        throw err;
+    }
+    Mjvm::unlock();
+}
+
+void Mjvm::openClassBundle(const char *fileName) {
+    Mjvm::lock();
+    if(classBundle) {
+        Mjvm::unlock();
+        throw "class bundle is already opened";
+    }
+    try {
+        MjvmClassBundle *bundle = (MjvmClassBundle *)Mjvm::malloc(sizeof(MjvmClassBundle));
+        try {
+            new (bundle)MjvmClassBundle(fileName);
+        }
+        catch(const char *msg) {
+            Mjvm::free(bundle);
+            throw msg;
+        }
+        catch(MjvmOutOfMemoryError *err) {
+            Mjvm::free(bundle);
+            throw err;
+        }
+        classBundle = bundle;
+    }
+    catch(const char *msg) {
+        Mjvm::unlock();
+        throw msg;
+    }
+    catch(MjvmOutOfMemoryError *err) {
+        Mjvm::unlock();
+        throw err;
+    }
+    Mjvm::unlock();
+}
+
+void Mjvm::registerNativeClass(const NativeClass &nativeClass) {
+    /* the table keeps a reference to nativeClass, it must stay valid as long as the VM runs */
+    Mjvm::lock();
+    try {
+        NativeMethodTable::registerClass(nativeClass);
+    }
+    catch(MjvmOutOfMemoryError *err) {
+        Mjvm::unlock();
+        throw err;
+    }
+    Mjvm::unlock();
+}
+
+void Mjvm::preloadClasses(const char *mainClass, uint16_t workerCount) {
+    MjvmClassPreloader preloader(*this, workerCount);
+    preloader.preload(mainClass);
+}
+
+void Mjvm::preloadClassList(const char *fileName, uint16_t workerCount) {
+    MjvmClassPreloader preloader(*this, workerCount);
+    preloader.preloadList(fileName);
+}
+
+void Mjvm::saveClassList(const char *fileName) {
+    void *file = MjvmSystem_FileOpen(fileName, (MjvmSys_FileMode)(MJVM_FILE_WRITE | MJVM_FILE_CREATE_ALWAYS));
+    if(file == 0)
+        throw "can not open file";
+    Mjvm::lock();
+    uint32_t count = 0;
+    for(ClassData *node = classDataList; node != 0; node = node->next)
+        count++;
+    ClassData **list = 0;
+    try {
+        if(count)
+            list = (ClassData **)Mjvm::malloc(count * sizeof(ClassData *));
+        /* the newest class is at the head of the list, write them in loading order */
+        uint32_t index = count;
+        for(ClassData *node = classDataList; node != 0; node = node->next)
+            list[--index] = node;
+        for(uint32_t i = 0; i < count; i++) {
+            MjvmConstUtf8 &name = list[i]->getThisClass();
+            uint32_t temp;
+            if(
+                (MjvmSystem_FileWrite(file, (void *)name.text, name.length, &temp) != FILE_RESULT_OK) ||
+                (MjvmSystem_FileWrite(file, (void *)"\n", 1, &temp) != FILE_RESULT_OK)
+            ) {
+                throw "write file error";
+            }
+        }
+    }
+    catch(const char *msg) {
+        if(list)
+            Mjvm::free(list);
+        Mjvm::unlock();
+        MjvmSystem_FileClose(file);
+        throw msg;
+    }
+    catch(MjvmOutOfMemoryError *err) {
+        Mjvm::unlock();
+        MjvmSystem_FileClose(file);
+        throw err;
+    }
+    if(list)
+        Mjvm::free(list);
+    Mjvm::unlock();
+    MjvmSystem_FileClose(file);
+}
+
+void Mjvm::saveSnapshot(const char *fileName) {
+    Mjvm::lock();
+    try {
+        MjvmSnapshot snapshot(*this);
+        snapshot.save(fileName);
+    }
+    catch(const char *msg) {
+        Mjvm::unlock();
+        throw msg;
+    }
+    catch(MjvmOutOfMemoryError *err) {
+        Mjvm::unlock();
+        throw err;
+    }
+    Mjvm::unlock();
+}
+
+void Mjvm::restoreSnapshot(const char *fileName) {
+    Mjvm::lock();
+    if(snapshotUtf8 || classDataList) {
+        Mjvm::unlock();
+        throw "snapshot must be restored before any class is loaded";
+    }
+    try {
+        MjvmSnapshot snapshot(*this);
+        snapshot.restore(fileName);
+    }
+    catch(const char *msg) {
+        Mjvm::unlock();
+        throw msg;
+    }
+    catch(MjvmOutOfMemoryError *err) {
+        Mjvm::unlock();
+        throw err;
+    }
+    catch(MjvmLoadFileError *err) {
+        Mjvm::unlock();
+        throw err;
+    }
+    Mjvm::unlock();
+}
+
 void Mjvm::runToMain(const char *mainClass) {
     newExecution().run(load(mainClass).getMainMethodInfo());
 }
@@ -642,15 +1437,41 @@ void Mjvm::runToMain(const char *mainClass, uint32_t stackSize) {
 }
 
 void Mjvm::terminateAll(void) {
+    for(MjvmTaskPool *pool = taskPoolList; pool != 0;) {
+        MjvmTaskPool *next = pool->next;
+        pool->terminate();
+        /* the last worker signals the termination under the lock, wait until it has left before freeing */
+        lock();
+        pool->~MjvmTaskPool();
+        Mjvm::free(pool);
+        unlock();
+        pool = next;
+    }
+    taskPoolList = 0;
+    lock();
     MjvmExecutionNode *list = executionList;
     executionList = 0;
-    for(MjvmExecutionNode *node = list; node != 0; node = node->next)
+    for(MjvmExecutionNode *node = list; node != 0; node = node->next) {
+        node->isReleaseRequested = false;
         node->terminateRequest();
+    }
+    unlock();
     for(MjvmExecutionNode *node = list; node != 0;) {
         MjvmExecutionNode *next = node->next;
-        while(node->isRunning());
+        node->join();
+        /* the worker gives the completion under the lock, wait until it has left before freeing */
+        lock();
+        node->~MjvmExecution();
+        Mjvm::free(node);
+        unlock();
+        node = next;
+    }
+    for(MjvmExecutionNode *node = freeExecutionList; node != 0;) {
+        MjvmExecutionNode *next = node->next;
         node->~MjvmExecution();
         Mjvm::free(node);
         node = next;
     }
+    freeExecutionList = 0;
+    freeExecutionCount = 0;
 }
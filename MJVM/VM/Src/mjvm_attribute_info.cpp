@@ -47,18 +47,20 @@ startPc(startPc), endPc(endPc), handlerPc(handlerPc), catchType(catchType) {
 
 MjvmCodeAttribute::MjvmCodeAttribute(uint16_t maxStack, uint16_t maxLocals) :
 MjvmAttribute(ATTRIBUTE_CODE), maxStack(maxStack), maxLocals(maxLocals), codeLength(0),
-exceptionTableLength(0), code(0), exceptionTable(0), attributes(0) {
+exceptionTableLength(0), code(0), exceptionTable(0), attributes(0), isCodeInImage(false), isExceptionTableInImage(false) {
 
 }
 
-void MjvmCodeAttribute::setCode(uint8_t *code, uint32_t length) {
+void MjvmCodeAttribute::setCode(uint8_t *code, uint32_t length, bool isInImage) {
     this->code = code;
     *(uint32_t *)&codeLength = length;
+    isCodeInImage = isInImage;
 }
 
-void MjvmCodeAttribute::setExceptionTable(MjvmExceptionTable *exceptionTable, uint16_t length) {
+void MjvmCodeAttribute::setExceptionTable(MjvmExceptionTable *exceptionTable, uint16_t length, bool isInImage) {
     this->exceptionTable = exceptionTable;
     *(uint16_t *)&exceptionTableLength = length;
+    isExceptionTableInImage = isInImage;
 }
 
 void MjvmCodeAttribute::addAttribute(MjvmAttribute *attribute) {
@@ -73,9 +75,9 @@ MjvmExceptionTable &MjvmCodeAttribute::getException(uint16_t index) const {
 }
 
 MjvmCodeAttribute::~MjvmCodeAttribute(void) {
-    if(code)
+    if(code && !isCodeInImage)
         Mjvm::free((void *)code);
-    if(exceptionTable)
+    if(exceptionTable && !isExceptionTableInImage)
         Mjvm::free((void *)exceptionTable);
     for(MjvmAttribute *node = attributes; node != 0;) {
         MjvmAttribute *next = node->next;
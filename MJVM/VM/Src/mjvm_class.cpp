@@ -8,5 +8,6 @@ MjvmString &MjvmClass::getName(void) const {
 }
 
 MjvmConstClass::MjvmConstClass(MjvmClass &mjvmClass) : mjvmClass(mjvmClass) {
-
+    next = 0;
+    hashNext = 0;
 }
@@ -0,0 +1,154 @@
+
+#include <string.h>
+#include "mjvm.h"
+#include "mjvm_opcodes.h"
+#include "mjvm_system_api.h"
+#include "mjvm_class_archive.h"
+
+MjvmClassArchive::MjvmClassArchive(const char *fileName) {
+    void *file = MjvmSystem_FileOpen(fileName, MJVM_FILE_READ);
+    if(file == 0)
+        throw "can not open file";
+    data = (uint8_t *)MjvmSystem_FileMap(file, &size);
+    isMapped = (data != 0);
+    if(!isMapped) {
+        try {
+            size = MjvmSystem_FileSize(file);
+            data = (uint8_t *)Mjvm::malloc(size);
+            uint32_t temp;
+            MjvmSys_FileResult ret = MjvmSystem_FileRead(file, data, size, &temp);
+            if((ret != FILE_RESULT_OK) || (temp != size)) {
+                Mjvm::free(data);
+                throw "read file error";
+            }
+        }
+        catch(const char *excp) {
+            MjvmSystem_FileClose(file);
+            throw excp;
+        }
+        catch(MjvmOutOfMemoryError *err) {
+            MjvmSystem_FileClose(file);
+            throw err;
+        }
+    }
+    MjvmSystem_FileClose(file);
+
+    const MjvmArchiveHeader *header = (const MjvmArchiveHeader *)data;
+    if(
+        (size < sizeof(MjvmArchiveHeader)) ||
+        (header->magic != CLASS_ARCHIVE_MAGIC) ||
+        (header->version != CLASS_ARCHIVE_VERSION) ||
+        (header->bucketCount & (header->bucketCount - 1)) ||
+        (header->bucketCount > (size / sizeof(uint32_t))) ||
+        !isValidRange(header->bucketsOffset, header->bucketCount * sizeof(uint32_t), sizeof(uint32_t))
+    ) {
+        if(isMapped)
+            MjvmSystem_FileUnmap(data, size);
+        else
+            Mjvm::free(data);
+        throw "invalid class archive";
+    }
+}
+
+uint32_t MjvmClassArchive::calcHash(const char *text, uint16_t length) {
+    /* FNV-1a, the archive tool uses the same function to build the index */
+    uint32_t hash = 0x811C9DC5;
+    for(uint16_t i = 0; i < length; i++) {
+        hash ^= (uint8_t)text[i];
+        hash *= 0x01000193;
+    }
+    return hash;
+}
+
+bool MjvmClassArchive::isValidRange(uint32_t offset, uint32_t length, uint32_t alignment) const {
+    return ((offset & (alignment - 1)) == 0) && (offset <= size) && (length <= (size - offset));
+}
+
+bool MjvmClassArchive::isValidUtf8(uint32_t offset) const {
+    if(!isValidRange(offset, sizeof(MjvmConstUtf8), sizeof(uint32_t)))
+        return false;
+    const MjvmConstUtf8 &utf8 = *(const MjvmConstUtf8 *)&data[offset];
+    return isValidRange(offset + sizeof(MjvmConstUtf8), utf8.length + 1) && (utf8.text[utf8.length] == 0);
+}
+
+/* every offset and count of a class is checked against the archive size before the class loader uses it */
+bool MjvmClassArchive::isValidClass(const MjvmArchiveClass &archiveClass) const {
+    if(!isValidRange(archiveClass.poolOffset, archiveClass.poolCount * sizeof(MjvmConstPool), sizeof(uint32_t)))
+        return false;
+    const MjvmConstPool *pool = (const MjvmConstPool *)&data[archiveClass.poolOffset];
+    for(uint32_t i = 0; i < archiveClass.poolCount; i++) {
+        if(pool[i].tag == CONST_UTF8 && !isValidUtf8(pool[i].value))
+            return false;
+    }
+    if(archiveClass.interfacesCount && !isValidRange(archiveClass.interfacesOffset, archiveClass.interfacesCount * sizeof(uint16_t), sizeof(uint16_t)))
+        return false;
+    if(archiveClass.fieldsCount && !isValidRange(archiveClass.fieldsOffset, archiveClass.fieldsCount * sizeof(MjvmArchiveField), sizeof(uint16_t)))
+        return false;
+    if(archiveClass.methodsCount) {
+        if(!isValidRange(archiveClass.methodsOffset, archiveClass.methodsCount * sizeof(MjvmArchiveMethod), sizeof(uint32_t)))
+            return false;
+        const MjvmArchiveMethod *methods = (const MjvmArchiveMethod *)&data[archiveClass.methodsOffset];
+        for(uint16_t i = 0; i < archiveClass.methodsCount; i++) {
+            const MjvmArchiveMethod &method = methods[i];
+            if(method.codeOffset == 0)
+                continue;
+            /* the code is followed by the OP_EXIT the tool appends */
+            if(method.codeLength >= size || !isValidRange(method.codeOffset, method.codeLength + 1) || data[method.codeOffset + method.codeLength] != OP_EXIT)
+                return false;
+            if(method.exceptionTableLength && !isValidRange(method.exceptionTableOffset, method.exceptionTableLength * sizeof(MjvmExceptionTable), sizeof(uint16_t)))
+                return false;
+        }
+    }
+    if(archiveClass.bootstrapMethodsOffset) {
+        uint32_t offset = archiveClass.bootstrapMethodsOffset;
+        if(!isValidRange(offset, sizeof(uint16_t), sizeof(uint16_t)))
+            return false;
+        uint16_t numBootstrapMethods = *(const uint16_t *)&data[offset];
+        offset += sizeof(uint16_t);
+        for(uint16_t i = 0; i < numBootstrapMethods; i++) {
+            if(!isValidRange(offset, 2 * sizeof(uint16_t)))
+                return false;
+            uint16_t numBootstrapArguments = ((const uint16_t *)&data[offset])[1];
+            offset += 2 * sizeof(uint16_t);
+            if(!isValidRange(offset, numBootstrapArguments * sizeof(uint16_t)))
+                return false;
+            offset += numBootstrapArguments * sizeof(uint16_t);
+        }
+    }
+    return true;
+}
+
+const MjvmArchiveClass *MjvmClassArchive::findClass(const char *className, uint16_t length) const {
+    const MjvmArchiveHeader *header = (const MjvmArchiveHeader *)data;
+    const uint32_t *buckets = (const uint32_t *)&data[header->bucketsOffset];
+    uint32_t mask = header->bucketCount - 1;
+    uint32_t index = calcHash(className, length) & mask;
+    for(uint32_t i = 0; i < header->bucketCount; i++, index = (index + 1) & mask) {
+        uint32_t offset = buckets[index];
+        if(offset == 0)
+            return 0;
+        if(!isValidRange(offset, sizeof(MjvmArchiveClass), sizeof(uint32_t)))
+            throw "invalid class archive";
+        const MjvmArchiveClass *archiveClass = (const MjvmArchiveClass *)&data[offset];
+        if(!isValidUtf8(archiveClass->nameOffset))
+            throw "invalid class archive";
+        const MjvmConstUtf8 &name = *(const MjvmConstUtf8 *)&data[archiveClass->nameOffset];
+        if(name.length == length && strncmp(name.text, className, length) == 0) {
+            if(!isValidClass(*archiveClass))
+                throw "invalid class archive";
+            return archiveClass;
+        }
+    }
+    return 0;
+}
+
+void *MjvmClassArchive::getData(uint32_t offset) const {
+    return &data[offset];
+}
+
+MjvmClassArchive::~MjvmClassArchive(void) {
+    if(isMapped)
+        MjvmSystem_FileUnmap(data, size);
+    else
+        Mjvm::free(data);
+}
@@ -0,0 +1,243 @@
+
+#include <string.h>
+#include "mjvm.h"
+#include "mjvm_system_api.h"
+#include "mjvm_class_bundle.h"
+
+#define ZIP_LOCAL_HEADER_SIGNATURE      0x04034B50
+#define ZIP_CENTRAL_HEADER_SIGNATURE    0x02014B50
+#define ZIP_END_OF_DIR_SIGNATURE        0x06054B50
+
+#define ZIP_LOCAL_HEADER_SIZE           30
+#define ZIP_CENTRAL_HEADER_SIZE         46
+#define ZIP_END_OF_DIR_SIZE             22
+#define ZIP_MAX_COMMENT_SIZE            0xFFFF
+
+#define ZIP_METHOD_STORED               0
+
+static uint16_t ClassBundle_ReadUInt16(const uint8_t *data) {
+    return data[0] | (data[1] << 8);
+}
+
+static uint32_t ClassBundle_ReadUInt32(const uint8_t *data) {
+    return data[0] | (data[1] << 8) | (data[2] << 16) | (data[3] << 24);
+}
+
+MjvmClassBundle::MjvmClassBundle(const char *fileName) {
+    names = 0;
+    buckets = 0;
+    bucketCount = 0;
+    file = MjvmSystem_FileOpen(fileName, MJVM_FILE_READ);
+    if(file == 0)
+        throw "can not open file";
+    data = (uint8_t *)MjvmSystem_FileMap(file, &size);
+    isMapped = (data != 0);
+    if(isMapped) {
+        MjvmSystem_FileClose(file);
+        file = 0;
+    }
+    else
+        size = MjvmSystem_FileSize(file);
+    try {
+        loadIndex();
+    }
+    catch(const char *excp) {
+        this->~MjvmClassBundle();
+        throw excp;
+    }
+    catch(MjvmOutOfMemoryError *err) {
+        this->~MjvmClassBundle();
+        throw err;
+    }
+}
+
+void MjvmClassBundle::read(uint32_t offset, void *buff, uint32_t size) const {
+    if(offset > this->size || size > (this->size - offset))
+        throw "invalid class bundle";
+    if(isMapped) {
+        memcpy(buff, &data[offset], size);
+        return;
+    }
+    /* classes can be loaded from several threads while preloading, the seek and the read go together */
+    uint32_t temp;
+    Mjvm::lock();
+    MjvmSys_FileResult ret = MjvmSystem_FileSeek(file, offset);
+    if(ret == FILE_RESULT_OK)
+        ret = MjvmSystem_FileRead(file, buff, size, &temp);
+    Mjvm::unlock();
+    if((ret != FILE_RESULT_OK) || (temp != size))
+        throw "read file error";
+}
+
+void MjvmClassBundle::loadIndex(void) {
+    if(size < ZIP_END_OF_DIR_SIZE)
+        throw "invalid class bundle";
+
+    /* the end of central directory record is followed by a comment of up to 64KB */
+    uint32_t tailSize = (size < (ZIP_END_OF_DIR_SIZE + ZIP_MAX_COMMENT_SIZE)) ? size : (ZIP_END_OF_DIR_SIZE + ZIP_MAX_COMMENT_SIZE);
+    uint8_t *tail = isMapped ? &data[size - tailSize] : (uint8_t *)Mjvm::malloc(tailSize);
+    uint32_t dirOffset = 0;
+    uint32_t dirSize = 0;
+    uint32_t entryCount = 0;
+    bool isFound = false;
+    try {
+        if(!isMapped)
+            read(size - tailSize, tail, tailSize);
+        for(int32_t i = tailSize - ZIP_END_OF_DIR_SIZE; i >= 0; i--) {
+            if(ClassBundle_ReadUInt32(&tail[i]) == ZIP_END_OF_DIR_SIGNATURE) {
+                entryCount = ClassBundle_ReadUInt16(&tail[i + 10]);
+                dirSize = ClassBundle_ReadUInt32(&tail[i + 12]);
+                dirOffset = ClassBundle_ReadUInt32(&tail[i + 16]);
+                isFound = true;
+                break;
+            }
+        }
+    }
+    catch(const char *excp) {
+        if(!isMapped)
+            Mjvm::free(tail);
+        throw excp;
+    }
+    if(!isMapped)
+        Mjvm::free(tail);
+    if(!isFound || dirOffset > size || dirSize > (size - dirOffset))
+        throw "invalid class bundle";
+
+    uint8_t *dir = isMapped ? &data[dirOffset] : (uint8_t *)Mjvm::malloc(dirSize);
+    try {
+        if(!isMapped)
+            read(dirOffset, dir, dirSize);
+
+        /* first pass counts the stored classes and the space needed for their names */
+        uint32_t classCount = 0;
+        uint32_t namesSize = 0;
+        for(uint32_t i = 0, pos = 0; i < entryCount; i++) {
+            if((pos + ZIP_CENTRAL_HEADER_SIZE) > dirSize || ClassBundle_ReadUInt32(&dir[pos]) != ZIP_CENTRAL_HEADER_SIGNATURE)
+                throw "invalid class bundle";
+            uint16_t method = ClassBundle_ReadUInt16(&dir[pos + 10]);
+            uint16_t nameLength = ClassBundle_ReadUInt16(&dir[pos + 28]);
+            const char *name = (const char *)&dir[pos + ZIP_CENTRAL_HEADER_SIZE];
+            pos += ZIP_CENTRAL_HEADER_SIZE + nameLength + ClassBundle_ReadUInt16(&dir[pos + 30]) + ClassBundle_ReadUInt16(&dir[pos + 32]);
+            if(pos > dirSize)
+                throw "invalid class bundle";
+            if(method == ZIP_METHOD_STORED && nameLength > 6 && strncmp(&name[nameLength - 6], ".class", 6) == 0) {
+                classCount++;
+                namesSize += nameLength - 6;
+            }
+        }
+
+        bucketCount = 2;
+        while(bucketCount < classCount * 2)
+            bucketCount <<= 1;
+        buckets = (MjvmBundleEntry *)Mjvm::malloc(bucketCount * sizeof(MjvmBundleEntry));
+        memset((void *)buckets, 0, bucketCount * sizeof(MjvmBundleEntry));
+        if(namesSize)
+            names = (char *)Mjvm::malloc(namesSize);
+
+        uint32_t namesOffset = 0;
+        for(uint32_t i = 0, pos = 0; i < entryCount; i++) {
+            uint16_t method = ClassBundle_ReadUInt16(&dir[pos + 10]);
+            uint32_t entrySize = ClassBundle_ReadUInt32(&dir[pos + 24]);
+            uint16_t nameLength = ClassBundle_ReadUInt16(&dir[pos + 28]);
+            uint16_t extraLength = ClassBundle_ReadUInt16(&dir[pos + 30]);
+            uint32_t offset = ClassBundle_ReadUInt32(&dir[pos + 42]);
+            const char *name = (const char *)&dir[pos + ZIP_CENTRAL_HEADER_SIZE];
+            pos += ZIP_CENTRAL_HEADER_SIZE + nameLength + extraLength + ClassBundle_ReadUInt16(&dir[pos + 32]);
+            if(method != ZIP_METHOD_STORED || nameLength <= 6 || strncmp(&name[nameLength - 6], ".class", 6) != 0)
+                continue;
+
+            uint16_t length = nameLength - 6;
+            uint32_t hash = MjvmClassArchive::calcHash(name, length);
+            uint32_t mask = bucketCount - 1;
+            uint32_t index = hash & mask;
+            while(buckets[index].name) {
+                /* keep the first entry like a class path does */
+                if(buckets[index].hash == hash && buckets[index].nameLength == length && strncmp(buckets[index].name, name, length) == 0)
+                    break;
+                index = (index + 1) & mask;
+            }
+            if(buckets[index].name)
+                continue;
+            memcpy(&names[namesOffset], name, length);
+            buckets[index].name = &names[namesOffset];
+            buckets[index].nameLength = length;
+            buckets[index].headerSize = ZIP_LOCAL_HEADER_SIZE + nameLength + extraLength;
+            buckets[index].hash = hash;
+            buckets[index].offset = offset;
+            buckets[index].size = entrySize;
+            namesOffset += length;
+        }
+    }
+    catch(const char *excp) {
+        if(!isMapped)
+            Mjvm::free(dir);
+        throw excp;
+    }
+    catch(MjvmOutOfMemoryError *err) {
+        if(!isMapped)
+            Mjvm::free(dir);
+        throw err;
+    }
+    if(!isMapped)
+        Mjvm::free(dir);
+}
+
+const MjvmBundleEntry *MjvmClassBundle::findClass(const char *className, uint16_t length) const {
+    uint32_t hash = MjvmClassArchive::calcHash(className, length);
+    uint32_t mask = bucketCount - 1;
+    for(uint32_t index = hash & mask;; index = (index + 1) & mask) {
+        const MjvmBundleEntry &entry = buckets[index];
+        if(entry.name == 0)
+            return 0;
+        if(entry.hash == hash && entry.nameLength == length && strncmp(entry.name, className, length) == 0)
+            return &entry;
+    }
+}
+
+uint8_t *MjvmClassBundle::readClass(const MjvmBundleEntry &entry) const {
+    if(isMapped) {
+        if(entry.offset > size || (size - entry.offset) < ZIP_LOCAL_HEADER_SIZE)
+            throw "invalid class bundle";
+        const uint8_t *header = &data[entry.offset];
+        if(ClassBundle_ReadUInt32(header) != ZIP_LOCAL_HEADER_SIGNATURE)
+            throw "invalid class bundle";
+        uint32_t headerSize = ZIP_LOCAL_HEADER_SIZE + ClassBundle_ReadUInt16(&header[26]) + ClassBundle_ReadUInt16(&header[28]);
+        if(headerSize > (size - entry.offset) || entry.size > (size - entry.offset - headerSize))
+            throw "invalid class bundle";
+        return &data[entry.offset + headerSize];
+    }
+
+    /* the local header usually has the same size as in the central directory, read it together with the class */
+    uint32_t readSize = entry.headerSize + entry.size;
+    uint8_t *buff = (uint8_t *)Mjvm::malloc(readSize);
+    try {
+        read(entry.offset, buff, readSize);
+        if(ClassBundle_ReadUInt32(buff) != ZIP_LOCAL_HEADER_SIGNATURE)
+            throw "invalid class bundle";
+        uint32_t headerSize = ZIP_LOCAL_HEADER_SIZE + ClassBundle_ReadUInt16(&buff[26]) + ClassBundle_ReadUInt16(&buff[28]);
+        if(headerSize <= entry.headerSize)
+            memmove(buff, &buff[headerSize], entry.size);
+        else
+            read(entry.offset + headerSize, buff, entry.size);
+    }
+    catch(const char *excp) {
+        Mjvm::free(buff);
+        throw excp;
+    }
+    return buff;
+}
+
+bool MjvmClassBundle::isClassMapped(void) const {
+    return isMapped;
+}
+
+MjvmClassBundle::~MjvmClassBundle(void) {
+    if(buckets)
+        Mjvm::free(buckets);
+    if(names)
+        Mjvm::free(names);
+    if(isMapped)
+        MjvmSystem_FileUnmap(data, size);
+    else
+        MjvmSystem_FileClose(file);
+}
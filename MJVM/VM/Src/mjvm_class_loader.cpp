@@ -14,8 +14,19 @@
 typedef struct {
     MjvmConstUtf8 *constUtf8Class;
     MjvmClass *constClass;
+    MjvmClassLoader *classLoader;
 } ConstClassValue;
 
+/* file is 0 when the data comes from a class bundle, isShared is set when the data belongs to a mapped bundle */
+typedef struct {
+    void *file;
+    uint8_t *data;
+    uint32_t size;
+    uint32_t pos;
+    bool isMapped;
+    bool isShared;
+} ClassFileBuffer;
+
 static void *ClassLoader_Open(const char *fileName) {
     char buff[FILE_NAME_BUFF_SIZE];
     uint32_t i = 0;
@@ -58,11 +69,99 @@ static void *ClassLoader_Open(const char *fileName, uint32_t length) {
     return file;
 }
 
+static void ClassLoader_Load(void *file, ClassFileBuffer &fileBuff) {
+    fileBuff.file = file;
+    fileBuff.pos = 0;
+    fileBuff.isShared = false;
+    /* map the whole class file if the system supports it, otherwise read it with a single call */
+    fileBuff.data = (uint8_t *)MjvmSystem_FileMap(file, &fileBuff.size);
+    fileBuff.isMapped = (fileBuff.data != 0);
+    if(fileBuff.isMapped)
+        return;
+    uint8_t *data = 0;
+    try {
+        fileBuff.size = MjvmSystem_FileSize(file);
+        data = (uint8_t *)Mjvm::malloc(fileBuff.size);
+        uint32_t temp;
+        MjvmSys_FileResult ret = MjvmSystem_FileRead(file, data, fileBuff.size, &temp);
+        if((ret != FILE_RESULT_OK) || (temp != fileBuff.size))
+            throw "read file error";
+    }
+    catch(const char *excp) {
+        if(data)
+            Mjvm::free(data);
+        MjvmSystem_FileClose(file);
+        throw excp;
+    }
+    catch(MjvmOutOfMemoryError *err) {
+        MjvmSystem_FileClose(file);
+        throw err;
+    }
+    fileBuff.data = data;
+}
+
+static void ClassLoader_Release(ClassFileBuffer &fileBuff) {
+    if(!fileBuff.isMapped)
+        Mjvm::free(fileBuff.data);
+    else if(fileBuff.file)
+        MjvmSystem_FileUnmap(fileBuff.data, fileBuff.size);
+    /* a mapped class bundle stays mapped as long as it is opened */
+    if(fileBuff.file)
+        MjvmSystem_FileClose(fileBuff.file);
+}
+
+#if KEEP_CLASS_IMAGE
+static uint32_t ClassLoader_GetUtf8PoolSize(void *file, uint16_t poolCount) {
+    ClassFileBuffer &fileBuff = *(ClassFileBuffer *)file;
+    uint32_t size = 0;
+    uint32_t pos = fileBuff.pos;
+    for(uint32_t i = 0; i < poolCount; i++) {
+        if((pos + 3) > fileBuff.size)
+            throw "read file error";
+        switch(fileBuff.data[pos]) {
+            case CONST_UTF8: {
+                uint16_t length = (fileBuff.data[pos + 1] << 8) | fileBuff.data[pos + 2];
+                /* keep each entry word aligned, CONST_UTF8_HASH reads the header as a uint32_t */
+                size += (sizeof(MjvmConstUtf8) + length + 4) & ~0x03;
+                pos += 3 + length;
+                break;
+            }
+            case CONST_INTEGER:
+            case CONST_FLOAT:
+            case CONST_FIELD:
+            case CONST_METHOD:
+            case CONST_INTERFACE_METHOD:
+            case CONST_NAME_AND_TYPE:
+            case CONST_INVOKE_DYNAMIC:
+                pos += 5;
+                break;
+            case CONST_LONG:
+            case CONST_DOUBLE:
+                pos += 9;
+                i++;
+                break;
+            case CONST_CLASS:
+            case CONST_STRING:
+            case CONST_METHOD_TYPE:
+                pos += 3;
+                break;
+            case CONST_METHOD_HANDLE:
+                pos += 4;
+                break;
+            default:
+                throw "uknow pool type";
+        }
+    }
+    return size;
+}
+#endif
+
 static void ClassLoader_Read(void *file, void *buff, uint32_t size) {
-    uint32_t temp;
-    MjvmSys_FileResult ret = MjvmSystem_FileRead(file, buff, size, &temp);
-    if((ret != FILE_RESULT_OK) || (temp != size))
+    ClassFileBuffer &fileBuff = *(ClassFileBuffer *)file;
+    if(size > (fileBuff.size - fileBuff.pos))
         throw "read file error";
+    memcpy(buff, &fileBuff.data[fileBuff.pos], size);
+    fileBuff.pos += size;
 }
 
 static uint8_t ClassLoader_ReadUInt8(void *file) {
@@ -90,8 +189,10 @@ static uint64_t ClassLoader_ReadUInt64(void *file) {
 }
 
 static void ClassLoader_Seek(void *file, int32_t offset) {
-    if(MjvmSystem_FileSeek(file, MjvmSystem_FileTell(file) + offset) != FILE_RESULT_OK)
+    ClassFileBuffer &fileBuff = *(ClassFileBuffer *)file;
+    if((uint32_t)offset > (fileBuff.size - fileBuff.pos))
         throw "read file error";
+    fileBuff.pos += offset;
 }
 
 MjvmClassLoader::MjvmClassLoader(const char *fileName) {
@@ -100,42 +201,175 @@ MjvmClassLoader::MjvmClassLoader(const char *fileName) {
     fieldsCount = 0;
     methodsCount = 0;
     attributesCount = 0;
+    classImage = 0;
+    classImageSize = 0;
+    isImageMapped = false;
+    isImageShared = false;
+    isArchived = false;
+    utf8Pool = 0;
+
+    loadFile(ClassLoader_Open(fileName));
+}
 
-    void *file = ClassLoader_Open(fileName);
+MjvmClassLoader::MjvmClassLoader(const char *fileName, uint16_t length) {
+    poolCount = 0;
+    interfacesCount = 0;
+    fieldsCount = 0;
+    methodsCount = 0;
+    attributesCount = 0;
+    classImage = 0;
+    classImageSize = 0;
+    isImageMapped = false;
+    isImageShared = false;
+    isArchived = false;
+    utf8Pool = 0;
+
+    loadFile(ClassLoader_Open(fileName, length));
+}
 
-    try {
-        readFile(file);
+MjvmClassLoader::MjvmClassLoader(const MjvmConstUtf8 &fileName) : MjvmClassLoader(fileName.text, fileName.length) {
+
+}
+
+MjvmClassLoader::MjvmClassLoader(const MjvmClassArchive &archive, const MjvmArchiveClass &archiveClass) {
+    magic = 0xCAFEBABE;
+    minorVersion = archiveClass.minorVersion;
+    majorVersion = archiveClass.majorVersion;
+    poolCount = 0;
+    accessFlags = archiveClass.accessFlags;
+    thisClass = archiveClass.thisClass;
+    superClass = archiveClass.superClass;
+    interfacesCount = 0;
+    fieldsCount = 0;
+    methodsCount = 0;
+    attributesCount = 0;
+    classImage = 0;
+    classImageSize = 0;
+    isImageMapped = false;
+    isImageShared = false;
+    isArchived = true;
+    utf8Pool = 0;
+
+    /* the const pool is already decoded, only the utf8 references need to be relocated */
+    poolTable = (MjvmConstPool *)Mjvm::malloc(archiveClass.poolCount * sizeof(MjvmConstPool));
+    memcpy((void *)poolTable, archive.getData(archiveClass.poolOffset), archiveClass.poolCount * sizeof(MjvmConstPool));
+    poolCount = archiveClass.poolCount;
+    for(uint32_t i = 0; i < poolCount; i++) {
+        if(poolTable[i].tag == CONST_UTF8)
+            *(uint32_t *)&poolTable[i].value = (uint32_t)archive.getData(poolTable[i].value);
     }
-    catch(const char *excp) {
-        MjvmSystem_FileClose(file);
-        throw excp;
+    interfacesCount = archiveClass.interfacesCount;
+    if(interfacesCount)
+        interfaces = (uint16_t *)archive.getData(archiveClass.interfacesOffset);
+    if(archiveClass.fieldsCount) {
+        const MjvmArchiveField *archiveFields = (const MjvmArchiveField *)archive.getData(archiveClass.fieldsOffset);
+        fields = (MjvmFieldInfo *)Mjvm::malloc(archiveClass.fieldsCount * sizeof(MjvmFieldInfo));
+        for(uint16_t i = 0; i < archiveClass.fieldsCount; i++) {
+            const MjvmArchiveField &field = archiveFields[i];
+            MjvmFieldAccessFlag flag = (MjvmFieldAccessFlag)field.accessFlag;
+            new (&fields[i])MjvmFieldInfo(*this, flag, getConstUtf8(field.nameIndex), getConstUtf8(field.descriptorIndex));
+        }
+        fieldsCount = archiveClass.fieldsCount;
+    }
+    if(archiveClass.methodsCount) {
+        const MjvmArchiveMethod *archiveMethods = (const MjvmArchiveMethod *)archive.getData(archiveClass.methodsOffset);
+        methods = (MjvmMethodInfo *)Mjvm::malloc(archiveClass.methodsCount * sizeof(MjvmMethodInfo));
+        for(uint16_t i = 0; i < archiveClass.methodsCount; i++) {
+            const MjvmArchiveMethod &method = archiveMethods[i];
+            MjvmMethodAccessFlag flag = (MjvmMethodAccessFlag)method.accessFlag;
+            new (&methods[i])MjvmMethodInfo(*this, flag, getConstUtf8(method.nameIndex), getConstUtf8(method.descriptorIndex));
+            methodsCount = i + 1;
+            if((flag & METHOD_NATIVE) == METHOD_NATIVE) {
+                MjvmNativeAttribute *attrNative = (MjvmNativeAttribute *)Mjvm::malloc(sizeof(MjvmNativeAttribute));
+                new (attrNative)MjvmNativeAttribute(0);
+                methods[i].addAttribute(attrNative);
+            }
+            else if(method.codeOffset) {
+                /* the code and the exception table are used in place, the archive stays loaded */
+                MjvmCodeAttribute *attribute = (MjvmCodeAttribute *)Mjvm::malloc(sizeof(MjvmCodeAttribute));
+                new (attribute)MjvmCodeAttribute(method.maxStack, method.maxLocals);
+                attribute->setCode((uint8_t *)archive.getData(method.codeOffset), method.codeLength, true);
+                if(method.exceptionTableLength) {
+                    MjvmExceptionTable *exceptionTable = (MjvmExceptionTable *)archive.getData(method.exceptionTableOffset);
+                    attribute->setExceptionTable(exceptionTable, method.exceptionTableLength, true);
+                }
+                methods[i].addAttribute(attribute);
+            }
+        }
+    }
+    if(archiveClass.bootstrapMethodsOffset) {
+        const uint16_t *data = (const uint16_t *)archive.getData(archiveClass.bootstrapMethodsOffset);
+        uint16_t numBootstrapMethods = *data++;
+        AttributeBootstrapMethods *attribute = (AttributeBootstrapMethods *)Mjvm::malloc(sizeof(AttributeBootstrapMethods));
+        new (attribute)AttributeBootstrapMethods(numBootstrapMethods);
+        addAttribute(attribute);
+        for(uint16_t i = 0; i < numBootstrapMethods; i++) {
+            uint16_t bootstrapMethodRef = *data++;
+            uint16_t numBootstrapArguments = *data++;
+            MjvmBootstrapMethod *bootstrapMethod = (MjvmBootstrapMethod *)Mjvm::malloc(sizeof(MjvmBootstrapMethod) + numBootstrapArguments * sizeof(uint16_t));
+            new (bootstrapMethod)MjvmBootstrapMethod(bootstrapMethodRef, numBootstrapArguments);
+            memcpy(((uint8_t *)bootstrapMethod) + sizeof(MjvmBootstrapMethod), data, numBootstrapArguments * sizeof(uint16_t));
+            data += numBootstrapArguments;
+            attribute->setBootstrapMethod(i, *bootstrapMethod);
+        }
     }
-
-    MjvmSystem_FileClose(file);
 }
 
-MjvmClassLoader::MjvmClassLoader(const char *fileName, uint16_t length) {
+MjvmClassLoader::MjvmClassLoader(const MjvmClassBundle &bundle, const MjvmBundleEntry &entry) {
     poolCount = 0;
     interfacesCount = 0;
     fieldsCount = 0;
     methodsCount = 0;
     attributesCount = 0;
+    classImage = 0;
+    classImageSize = 0;
+    isImageMapped = false;
+    isImageShared = false;
+    isArchived = false;
+    utf8Pool = 0;
+
+    ClassFileBuffer fileBuff;
+    fileBuff.file = 0;
+    fileBuff.data = bundle.readClass(entry);
+    fileBuff.size = entry.size;
+    fileBuff.pos = 0;
+    fileBuff.isMapped = bundle.isClassMapped();
+    fileBuff.isShared = fileBuff.isMapped;
+    loadBuffer(&fileBuff);
+}
 
-    void *file = ClassLoader_Open(fileName, length);
+void MjvmClassLoader::loadFile(void *file) {
+    ClassFileBuffer fileBuff;
+    ClassLoader_Load(file, fileBuff);
+    loadBuffer(&fileBuff);
+}
 
+void MjvmClassLoader::loadBuffer(void *buff) {
+    ClassFileBuffer &fileBuff = *(ClassFileBuffer *)buff;
     try {
-        readFile(file);
+        readFile(&fileBuff);
     }
     catch(const char *excp) {
-        MjvmSystem_FileClose(file);
+        ClassLoader_Release(fileBuff);
         throw excp;
     }
+    catch(MjvmOutOfMemoryError *err) {
+        ClassLoader_Release(fileBuff);
+        throw err;
+    }
 
-    MjvmSystem_FileClose(file);
-}
-
-MjvmClassLoader::MjvmClassLoader(const MjvmConstUtf8 &fileName) : MjvmClassLoader(fileName.text, fileName.length) {
-
+#if KEEP_CLASS_IMAGE
+    /* the code and the exception tables reference the image, keep it for the lifetime of the class */
+    classImage = fileBuff.data;
+    classImageSize = fileBuff.size;
+    isImageMapped = fileBuff.isMapped;
+    /* a mapped class bundle owns the image */
+    isImageShared = fileBuff.isShared;
+    if(fileBuff.file)
+        MjvmSystem_FileClose(fileBuff.file);
+#else
+    ClassLoader_Release(fileBuff);
+#endif
 }
 
 void MjvmClassLoader::readFile(void *file) {
@@ -144,12 +378,24 @@ void MjvmClassLoader::readFile(void *file) {
     majorVersion = ClassLoader_ReadUInt16(file);
     poolCount = ClassLoader_ReadUInt16(file) - 1;
     poolTable = (MjvmConstPool *)Mjvm::malloc(poolCount * sizeof(MjvmConstPool));
+#if KEEP_CLASS_IMAGE
+    /* all utf8 constants of the class share a single allocation */
+    uint32_t utf8PoolSize = ClassLoader_GetUtf8PoolSize(file, poolCount);
+    uint32_t utf8PoolOffset = 0;
+    if(utf8PoolSize)
+        utf8Pool = (uint8_t *)Mjvm::malloc(utf8PoolSize);
+#endif
     for(uint32_t i = 0; i < poolCount; i++) {
         *(MjvmConstPoolTag *)&poolTable[i].tag = (MjvmConstPoolTag)ClassLoader_ReadUInt8(file);
         switch(poolTable[i].tag) {
             case CONST_UTF8: {
                 uint16_t length = ClassLoader_ReadUInt16(file);
+#if KEEP_CLASS_IMAGE
+                *(uint32_t *)&poolTable[i].value = (uint32_t)&utf8Pool[utf8PoolOffset];
+                utf8PoolOffset += (sizeof(MjvmConstUtf8) + length + 4) & ~0x03;
+#else
                 *(uint32_t *)&poolTable[i].value = (uint32_t)Mjvm::malloc(sizeof(MjvmConstUtf8) + length + 1);
+#endif
                 *(uint16_t *)&((MjvmConstUtf8 *)poolTable[i].value)->length = length;
                 char *textBuff = (char *)((MjvmConstUtf8 *)poolTable[i].value)->text;
                 ClassLoader_Read(file, textBuff, length);
@@ -200,7 +446,8 @@ void MjvmClassLoader::readFile(void *file) {
     interfacesCount = ClassLoader_ReadUInt16(file);
     if(interfacesCount) {
         interfaces = (uint16_t *)Mjvm::malloc(interfacesCount * sizeof(uint16_t));
-        ClassLoader_Read(file, interfaces, interfacesCount * sizeof(uint16_t));
+        for(uint16_t i = 0; i < interfacesCount; i++)
+            interfaces[i] = ClassLoader_ReadUInt16(file);
     }
     fieldsCount = ClassLoader_ReadUInt16(file);
     if(fieldsCount) {
@@ -255,9 +502,18 @@ void MjvmClassLoader::readFile(void *file) {
                     methods[loadedCount].addAttribute(attrNative);
                 }
                 while(methodAttributesCount--) {
+#if LAZY_METHOD_CODE
+                    /* only remember where the code is, it is parsed from the image on the first call */
+                    uint16_t nameIndex = ClassLoader_ReadUInt16(file);
+                    uint32_t length = ClassLoader_ReadUInt32(file);
+                    if(MjvmAttribute::parseAttributeType(getConstUtf8(nameIndex)) == ATTRIBUTE_CODE)
+                        methods[loadedCount].codeOffset = ((ClassFileBuffer *)file)->pos;
+                    ClassLoader_Seek(file, length);
+#else
                     MjvmAttribute *attr = readAttribute(file);
                     if(attr != 0)
                         methods[loadedCount].addAttribute(attr);
+#endif
                 }
                 loadedCount++;
             }
@@ -309,15 +565,43 @@ MjvmAttribute *MjvmClassLoader::readAttributeCode(void *file) {
     uint16_t maxStack = ClassLoader_ReadUInt16(file);
     uint16_t maxLocals = ClassLoader_ReadUInt16(file);
     uint32_t codeLength = ClassLoader_ReadUInt32(file);
-    uint8_t *code = (uint8_t *)Mjvm::malloc(codeLength + 1);
     new (attribute)MjvmCodeAttribute(maxStack, maxLocals);
-    ClassLoader_Read(file, code, codeLength);
-    code[codeLength] = OP_EXIT;
-    attribute->setCode(code, codeLength);
-    uint16_t exceptionTableLength = ClassLoader_ReadUInt16(file);
+    uint16_t exceptionTableLength;
+#if KEEP_CLASS_IMAGE
+    ClassFileBuffer &fileBuff = *(ClassFileBuffer *)file;
+    /* a shared image can be parsed again after the class is unloaded, so it is only read and never modified */
+    bool isInPlace = !fileBuff.isShared;
+    if(isInPlace) {
+        uint8_t *code = &fileBuff.data[fileBuff.pos];
+        ClassLoader_Seek(file, codeLength);
+        exceptionTableLength = ClassLoader_ReadUInt16(file);
+        /* the exit opcode takes the place of exception_table_length which has already been read */
+        code[codeLength] = OP_EXIT;
+        attribute->setCode(code, codeLength, true);
+    }
+    else
+#endif
+    {
+        uint8_t *code = (uint8_t *)Mjvm::malloc(codeLength + 1);
+        ClassLoader_Read(file, code, codeLength);
+        code[codeLength] = OP_EXIT;
+        attribute->setCode(code, codeLength);
+        exceptionTableLength = ClassLoader_ReadUInt16(file);
+    }
     if(exceptionTableLength) {
-        MjvmExceptionTable *exceptionTable = (MjvmExceptionTable *)Mjvm::malloc(exceptionTableLength * sizeof(MjvmExceptionTable));
-        attribute->setExceptionTable(exceptionTable, exceptionTableLength);
+        MjvmExceptionTable *exceptionTable;
+#if KEEP_CLASS_IMAGE
+        /* the entries are converted in place when the image is private and aligned well enough */
+        if(isInPlace && ((uint32_t)&fileBuff.data[fileBuff.pos] & 0x01) == 0) {
+            exceptionTable = (MjvmExceptionTable *)&fileBuff.data[fileBuff.pos];
+            attribute->setExceptionTable(exceptionTable, exceptionTableLength, true);
+        }
+        else
+#endif
+        {
+            exceptionTable = (MjvmExceptionTable *)Mjvm::malloc(exceptionTableLength * sizeof(MjvmExceptionTable));
+            attribute->setExceptionTable(exceptionTable, exceptionTableLength);
+        }
         for(uint16_t i = 0; i < exceptionTableLength; i++) {
             uint16_t startPc = ClassLoader_ReadUInt16(file);
             uint16_t endPc = ClassLoader_ReadUInt16(file);
@@ -345,12 +629,45 @@ MjvmAttribute *MjvmClassLoader::readAttributeBootstrapMethods(void *file) {
         MjvmBootstrapMethod *bootstrapMethod = (MjvmBootstrapMethod *)Mjvm::malloc(sizeof(MjvmBootstrapMethod) + numBootstrapArguments * sizeof(uint16_t));
         new (bootstrapMethod)MjvmBootstrapMethod(bootstrapMethodRef, numBootstrapArguments);
         uint16_t *bootstrapArguments = (uint16_t *)(((uint8_t *)bootstrapMethod) + sizeof(MjvmBootstrapMethod));
-        ClassLoader_Read(file, bootstrapArguments, numBootstrapArguments * sizeof(uint16_t));
+        for(uint16_t j = 0; j < numBootstrapArguments; j++)
+            bootstrapArguments[j] = ClassLoader_ReadUInt16(file);
         attribute->setBootstrapMethod(i, *bootstrapMethod);
     }
     return attribute;
 }
 
+MjvmCodeAttribute &MjvmClassLoader::loadCode(MjvmMethodInfo &methodInfo) {
+    Mjvm::lock();
+    try {
+        /* another thread may have loaded it while this one was waiting for the lock */
+        for(MjvmAttribute *node = methodInfo.attributes; node != 0; node = node->next) {
+            if(node->attributeType == ATTRIBUTE_CODE) {
+                Mjvm::unlock();
+                return *(MjvmCodeAttribute *)node;
+            }
+        }
+        ClassFileBuffer fileBuff;
+        fileBuff.file = 0;
+        fileBuff.data = classImage;
+        fileBuff.size = classImageSize;
+        fileBuff.pos = methodInfo.codeOffset;
+        fileBuff.isMapped = isImageMapped;
+        fileBuff.isShared = isImageShared;
+        MjvmAttribute *attribute = readAttributeCode(&fileBuff);
+        methodInfo.addAttribute(attribute);
+        Mjvm::unlock();
+        return *(MjvmCodeAttribute *)attribute;
+    }
+    catch(const char *excp) {
+        Mjvm::unlock();
+        throw excp;
+    }
+    catch(MjvmOutOfMemoryError *err) {
+        Mjvm::unlock();
+        throw err;
+    }
+}
+
 uint32_t MjvmClassLoader::getMagic(void) const {
     return magic;
 }
@@ -363,6 +680,10 @@ uint16_t MjvmClassLoader::getMajorversion(void) const {
     return majorVersion;
 }
 
+uint16_t MjvmClassLoader::getConstPoolCount(void) const {
+    return poolCount;
+}
+
 MjvmConstPool &MjvmClassLoader::getConstPool(uint16_t poolIndex) const {
     poolIndex--;
     if(poolIndex < poolCount)
@@ -466,43 +787,63 @@ MjvmConstUtf8 &MjvmClassLoader::getConstUtf8Class(MjvmConstPool &constPool) cons
     throw "const pool tag is not class tag";
 }
 
-MjvmClass &MjvmClassLoader::getConstClass(Mjvm &mjvm, uint16_t poolIndex) {
-    poolIndex--;
-    if(poolIndex < poolCount && (poolTable[poolIndex].tag & 0x7F) == CONST_CLASS) {
-        if(poolTable[poolIndex].tag & 0x80) {
+void *MjvmClassLoader::getConstClassValue(MjvmConstPool &constPool) {
+    if((constPool.tag & 0x7F) == CONST_CLASS) {
+        if(constPool.tag & 0x80) {
             Mjvm::lock();
-            if(poolTable[poolIndex].tag & 0x80) {
-                MjvmConstUtf8 &constUtf8Class = getConstUtf8(poolTable[poolIndex].value);
-                ConstClassValue *constClassValue = (ConstClassValue *)Mjvm::malloc(sizeof(ConstClassValue));
-                constClassValue->constUtf8Class = &constUtf8Class;
-                constClassValue->constClass = mjvm.getConstClass(constUtf8Class.text, constUtf8Class.length);
-                *(uint32_t *)&poolTable[poolIndex].value = (uint32_t)constClassValue;
-                *(MjvmConstPoolTag *)&poolTable[poolIndex].tag = CONST_CLASS;
+            if(constPool.tag & 0x80) {
+                try {
+                    ConstClassValue *constClassValue = (ConstClassValue *)Mjvm::malloc(sizeof(ConstClassValue));
+                    constClassValue->constUtf8Class = &getConstUtf8(constPool.value);
+                    constClassValue->constClass = 0;
+                    constClassValue->classLoader = 0;
+                    *(uint32_t *)&constPool.value = (uint32_t)constClassValue;
+                    *(MjvmConstPoolTag *)&constPool.tag = CONST_CLASS;
+                }
+                catch(MjvmOutOfMemoryError *err) {
+                    Mjvm::unlock();
+                    throw err;
+                }
             }
             Mjvm::unlock();
         }
-        return *((ConstClassValue *)poolTable[poolIndex].value)->constClass;
+        return (void *)constPool.value;
     }
+    throw "const pool tag is not class tag";
+}
+
+MjvmClass &MjvmClassLoader::getConstClass(Mjvm &mjvm, uint16_t poolIndex) {
+    poolIndex--;
+    if(poolIndex < poolCount)
+        return getConstClass(mjvm, poolTable[poolIndex]);
     throw "index for const class is invalid";
 }
 
 MjvmClass &MjvmClassLoader::getConstClass(Mjvm &mjvm, MjvmConstPool &constPool) {
-    if((constPool.tag & 0x7F) == CONST_CLASS) {
-        if(constPool.tag & 0x80) {
-            Mjvm::lock();
-            if(constPool.tag & 0x80) {
-                MjvmConstUtf8 &constUtf8Class = getConstUtf8(constPool.value);
-                ConstClassValue *constClassValue = (ConstClassValue *)Mjvm::malloc(sizeof(ConstClassValue));
-                constClassValue->constUtf8Class = &constUtf8Class;
-                constClassValue->constClass = mjvm.getConstClass(constUtf8Class.text, constUtf8Class.length);
-                *(uint32_t *)&constPool.value = (uint32_t)constClassValue;
-                *(MjvmConstPoolTag *)&constPool.tag = CONST_CLASS;
-            }
-            Mjvm::unlock();
-        }
-        return *((ConstClassValue *)constPool.value)->constClass;
+    ConstClassValue *constClassValue = (ConstClassValue *)getConstClassValue(constPool);
+    if(constClassValue->constClass == 0) {
+        MjvmConstUtf8 &constUtf8Class = *constClassValue->constUtf8Class;
+        MjvmClass *constClass = mjvm.getConstClass(constUtf8Class.text, constUtf8Class.length);
+        Mjvm::lock();
+        if(constClassValue->constClass == 0)
+            constClassValue->constClass = constClass;
+        Mjvm::unlock();
     }
-    throw "const pool tag is not class tag";
+    return *constClassValue->constClass;
+}
+
+MjvmClassLoader &MjvmClassLoader::getConstClassLoader(Mjvm &mjvm, uint16_t poolIndex) {
+    poolIndex--;
+    if(poolIndex < poolCount)
+        return getConstClassLoader(mjvm, poolTable[poolIndex]);
+    throw "index for const class is invalid";
+}
+
+MjvmClassLoader &MjvmClassLoader::getConstClassLoader(Mjvm &mjvm, MjvmConstPool &constPool) {
+    ConstClassValue *constClassValue = (ConstClassValue *)getConstClassValue(constPool);
+    if(constClassValue->classLoader == 0)
+        constClassValue->classLoader = &mjvm.load(*constClassValue->constUtf8Class);
+    return *constClassValue->classLoader;
 }
 
 MjvmString &MjvmClassLoader::getConstString(Mjvm &mjvm, uint16_t poolIndex) {
@@ -542,13 +883,13 @@ MjvmString &MjvmClassLoader::getConstString(Mjvm &mjvm, MjvmConstPool &constPool
 
 MjvmConstUtf8 &MjvmClassLoader::getConstMethodType(uint16_t poolIndex) const {
     poolIndex--;
-    if(poolIndex < poolCount && poolTable[poolIndex].tag == CONST_METHOD)
+    if(poolIndex < poolCount && poolTable[poolIndex].tag == CONST_METHOD_TYPE)
         return getConstUtf8(poolTable[poolIndex].value);
     throw "index for const method type is invalid";
 }
 
 MjvmConstUtf8 &MjvmClassLoader::getConstMethodType(MjvmConstPool &constPool) const {
-    if(constPool.tag == CONST_METHOD)
+    if(constPool.tag == CONST_METHOD_TYPE)
         return getConstUtf8(constPool.value);
     throw "const pool tag is not method type tag";
 }
@@ -645,6 +986,60 @@ MjvmConstInterfaceMethod &MjvmClassLoader::getConstInterfaceMethod(MjvmConstPool
     return getConstInterfaceMethod((uint16_t)(&constPool - poolTable) + 1);
 }
 
+MjvmConstMethodHandle &MjvmClassLoader::getConstMethodHandle(uint16_t poolIndex) {
+    poolIndex--;
+    if(poolIndex < poolCount && (poolTable[poolIndex].tag & 0x7F) == CONST_METHOD_HANDLE) {
+        if(poolTable[poolIndex].tag & 0x80) {
+            Mjvm::lock();
+            if(poolTable[poolIndex].tag & 0x80) {
+                MjvmReferenceKind referenceKind = (MjvmReferenceKind)((uint8_t *)&poolTable[poolIndex].value)[0];
+                uint16_t referenceIndex = ((uint16_t *)&poolTable[poolIndex].value)[1];
+                /* field, method and interface method references all start with the class name and the name and type */
+                MjvmConstField *reference;
+                if(referenceKind <= REF_PUT_STATIC)
+                    reference = &getConstField(referenceIndex);
+                else if((poolTable[referenceIndex - 1].tag & 0x7F) == CONST_INTERFACE_METHOD)
+                    reference = (MjvmConstField *)&getConstInterfaceMethod(referenceIndex);
+                else
+                    reference = (MjvmConstField *)&getConstMethod(referenceIndex);
+                *(MjvmConstPoolTag *)&poolTable[poolIndex].tag = CONST_METHOD_HANDLE;
+                *(uint32_t *)&poolTable[poolIndex].value = (uint32_t)Mjvm::malloc(sizeof(MjvmConstMethodHandle));
+                new ((MjvmConstMethodHandle *)poolTable[poolIndex].value)MjvmConstMethodHandle(referenceKind, reference->className, reference->nameAndType);
+            }
+            Mjvm::unlock();
+        }
+        return *(MjvmConstMethodHandle *)poolTable[poolIndex].value;
+    }
+    throw "index for const method handle is invalid";
+}
+
+MjvmConstMethodHandle &MjvmClassLoader::getConstMethodHandle(MjvmConstPool &constPool) {
+    return getConstMethodHandle((uint16_t)(&constPool - poolTable) + 1);
+}
+
+MjvmConstInvokeDynamic &MjvmClassLoader::getConstInvokeDynamic(uint16_t poolIndex) {
+    poolIndex--;
+    if(poolIndex < poolCount && (poolTable[poolIndex].tag & 0x7F) == CONST_INVOKE_DYNAMIC) {
+        if(poolTable[poolIndex].tag & 0x80) {
+            Mjvm::lock();
+            if(poolTable[poolIndex].tag & 0x80) {
+                uint16_t bootstrapMethodAttrIndex = ((uint16_t *)&poolTable[poolIndex].value)[0];
+                uint16_t nameAndTypeIndex = ((uint16_t *)&poolTable[poolIndex].value)[1];
+                *(MjvmConstPoolTag *)&poolTable[poolIndex].tag = CONST_INVOKE_DYNAMIC;
+                *(uint32_t *)&poolTable[poolIndex].value = (uint32_t)Mjvm::malloc(sizeof(MjvmConstInvokeDynamic));
+                new ((MjvmConstInvokeDynamic *)poolTable[poolIndex].value)MjvmConstInvokeDynamic(bootstrapMethodAttrIndex, getConstNameAndType(nameAndTypeIndex));
+            }
+            Mjvm::unlock();
+        }
+        return *(MjvmConstInvokeDynamic *)poolTable[poolIndex].value;
+    }
+    throw "index for const invoke dynamic is invalid";
+}
+
+MjvmConstInvokeDynamic &MjvmClassLoader::getConstInvokeDynamic(MjvmConstPool &constPool) {
+    return getConstInvokeDynamic((uint16_t)(&constPool - poolTable) + 1);
+}
+
 MjvmClassAccessFlag MjvmClassLoader::getAccessFlag(void) const {
     return (MjvmClassAccessFlag)accessFlags;
 }
@@ -749,18 +1144,125 @@ MjvmMethodInfo &MjvmClassLoader::getStaticConstructor(void) const {
     return getMethodInfo(*(MjvmConstNameAndType *)nameAndType);
 }
 
+MjvmBootstrapMethod &MjvmClassLoader::getBootstrapMethod(uint16_t index) const {
+    for(MjvmAttribute *node = attributes; node != 0; node = node->next) {
+        if(node->attributeType == ATTRIBUTE_BOOTSTRAP_METHODS)
+            return ((AttributeBootstrapMethods *)node)->getBootstrapMethod(index);
+    }
+    throw "the class has no BootstrapMethods attribute";
+}
+
+uint32_t MjvmClassLoader::getAttributesSize(MjvmAttribute *attributes) {
+    uint32_t size = 0;
+    for(MjvmAttribute *node = attributes; node != 0; node = node->next) {
+        switch(node->attributeType) {
+            case ATTRIBUTE_CODE: {
+                MjvmCodeAttribute *code = (MjvmCodeAttribute *)node;
+                size += sizeof(MjvmCodeAttribute) + getAttributesSize(code->attributes);
+                if(code->code && !code->isCodeInImage)
+                    size += code->codeLength + 1;
+                if(code->exceptionTable && !code->isExceptionTableInImage)
+                    size += code->exceptionTableLength * sizeof(MjvmExceptionTable);
+                break;
+            }
+            case ATTRIBUTE_BOOTSTRAP_METHODS: {
+                AttributeBootstrapMethods *bootstrapMethods = (AttributeBootstrapMethods *)node;
+                size += sizeof(AttributeBootstrapMethods) + bootstrapMethods->numBootstrapMethods * sizeof(MjvmBootstrapMethod *);
+                for(uint16_t i = 0; i < bootstrapMethods->numBootstrapMethods; i++) {
+                    MjvmBootstrapMethod *bootstrapMethod = bootstrapMethods->bootstrapMethods[i];
+                    if(bootstrapMethod)
+                        size += sizeof(MjvmBootstrapMethod) + bootstrapMethod->numBootstrapArguments * sizeof(uint16_t);
+                }
+                break;
+            }
+            case ATTRIBUTE_NATIVE:
+                size += sizeof(MjvmNativeAttribute);
+                break;
+            default:
+                break;
+        }
+    }
+    return size;
+}
+
+/*
+ * The code of an archived class is used in place in the archive, which outlives the class.
+ * Its opcodes stay quickened after an unload and a reloaded class would run them against a fresh const pool.
+ * The other classes own their code, the code of a shared image is copied out of it.
+ */
+bool MjvmClassLoader::isUnloadable(void) const {
+    return !isArchived;
+}
+
+uint32_t MjvmClassLoader::getMemoryUsage(void) const {
+    /* only the heap owned by the class is counted, a mapped image or the archive data is not */
+    uint32_t size = poolCount * sizeof(MjvmConstPool);
+    for(uint32_t i = 0; i < poolCount; i++) {
+        switch(poolTable[i].tag) {
+            case CONST_UTF8: {
+                uint16_t length = ((MjvmConstUtf8 *)poolTable[i].value)->length;
+                if(utf8Pool)
+                    size += (sizeof(MjvmConstUtf8) + length + 4) & ~0x03;
+                else if(!isArchived)
+                    size += sizeof(MjvmConstUtf8) + length + 1;
+                break;
+            }
+            case CONST_FIELD:
+                size += sizeof(MjvmConstField);
+                break;
+            case CONST_METHOD:
+            case CONST_INTERFACE_METHOD:
+                size += sizeof(MjvmConstMethod);
+                break;
+            case CONST_NAME_AND_TYPE:
+                size += sizeof(MjvmConstNameAndType);
+                break;
+            case CONST_CLASS:
+                size += sizeof(ConstClassValue);
+                break;
+            case CONST_LONG:
+            case CONST_DOUBLE:
+                i++;
+                break;
+            default:
+                break;
+        }
+    }
+    if(!isArchived)
+        size += interfacesCount * sizeof(uint16_t);
+    size += fieldsCount * sizeof(MjvmFieldInfo);
+    size += methodsCount * sizeof(MjvmMethodInfo);
+    for(uint32_t i = 0; i < methodsCount; i++)
+        size += getAttributesSize(methods[i].attributes);
+    size += getAttributesSize(attributes);
+    if(classImage && !isImageShared && !isImageMapped)
+        size += classImageSize;
+    return size;
+}
+
 MjvmClassLoader::~MjvmClassLoader(void) {
     if(poolCount) {
         for(uint32_t i = 0; i < poolCount; i++) {
             switch (poolTable[i].tag) {
                 case CONST_UTF8:
+                    if(utf8Pool == 0 && !isArchived)
+                        Mjvm::free((void *)poolTable[i].value);
+                    break;
                 case CONST_FIELD:
                 case CONST_METHOD:
                 case CONST_INTERFACE_METHOD:
                 case CONST_NAME_AND_TYPE:
-                case CONST_INVOKE_DYNAMIC:
                     Mjvm::free((void *)poolTable[i].value);
                     break;
+                case CONST_INVOKE_DYNAMIC: {
+                    MjvmConstInvokeDynamic *constInvokeDynamic = (MjvmConstInvokeDynamic *)poolTable[i].value;
+                    if(constInvokeDynamic->lambda)
+                        Mjvm::free(constInvokeDynamic->lambda);
+                    if(constInvokeDynamic->stringConcat)
+                        Mjvm::free(constInvokeDynamic->stringConcat);
+                    Mjvm::free(constInvokeDynamic);
+                    break;
+                }
                 case CONST_LONG:
                 case CONST_DOUBLE:
                     i++;
@@ -775,7 +1277,7 @@ MjvmClassLoader::~MjvmClassLoader(void) {
         }
         Mjvm::free(poolTable);
     }
-    if(interfacesCount)
+    if(interfacesCount && !isArchived)
         Mjvm::free(interfaces);
     if(fieldsCount) {
         for(uint32_t i = 0; i < fieldsCount; i++)
@@ -793,5 +1295,12 @@ MjvmClassLoader::~MjvmClassLoader(void) {
         Mjvm::free(node);
         node = next;
     }
-    Mjvm::free(attributes);
+    if(utf8Pool)
+        Mjvm::free(utf8Pool);
+    if(classImage && !isImageShared) {
+        if(isImageMapped)
+            MjvmSystem_FileUnmap(classImage, classImageSize);
+        else
+            Mjvm::free(classImage);
+    }
 }
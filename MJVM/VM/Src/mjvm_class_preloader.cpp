@@ -0,0 +1,163 @@
+
+#include <string.h>
+#include "mjvm.h"
+#include "mjvm_common.h"
+#include "mjvm_system_api.h"
+#include "mjvm_class_preloader.h"
+
+MjvmClassPreloader::MjvmClassPreloader(Mjvm &mjvm, uint16_t workerCount) : mjvm(mjvm), workerCount(workerCount) {
+    classes = 0;
+    count = 0;
+    capacity = 0;
+    nextIndex = 0;
+    endIndex = 0;
+    classList = 0;
+    doneSemaphore = 0;
+}
+
+void MjvmClassPreloader::addClass(const char *text, uint16_t length) {
+    /* only the element class of an array needs to be loaded */
+    if(length && text[0] == '[') {
+        while(length && text[0] == '[') {
+            text++;
+            length--;
+        }
+        if(length < 3 || text[0] != 'L' || text[length - 1] != ';')
+            return;
+        text++;
+        length -= 2;
+    }
+    if(length == 0)
+        return;
+    uint32_t hash = MjvmClassArchive::calcHash(text, length);
+    for(uint32_t i = 0; i < count; i++) {
+        if(classes[i].hash == hash && classes[i].length == length && strncmp(classes[i].text, text, length) == 0)
+            return;
+    }
+    if(count == capacity) {
+        uint32_t newCapacity = capacity ? (capacity << 1) : 64;
+        classes = (MjvmPreloadClass *)Mjvm::realloc(classes, newCapacity * sizeof(MjvmPreloadClass));
+        capacity = newCapacity;
+    }
+    classes[count].text = text;
+    classes[count].length = length;
+    classes[count].hash = hash;
+    classes[count].classData = 0;
+    count++;
+}
+
+void MjvmClassPreloader::addReferences(const MjvmClassLoader &classLoader) {
+    /* the super class and the interfaces are referenced from the const pool as well */
+    uint16_t poolCount = classLoader.getConstPoolCount();
+    for(uint16_t i = 1; i <= poolCount; i++) {
+        MjvmConstPool &constPool = classLoader.getConstPool(i);
+        if((constPool.tag & 0x7F) == CONST_CLASS) {
+            MjvmConstUtf8 &className = classLoader.getConstUtf8Class(constPool);
+            addClass(className.text, className.length);
+        }
+        else if(constPool.tag == CONST_LONG || constPool.tag == CONST_DOUBLE)
+            i++;
+    }
+}
+
+void MjvmClassPreloader::workerTask(MjvmClassPreloader *preloader) {
+    for(;;) {
+        int32_t index = Mjvm_GetAndAdd32(&preloader->nextIndex, 1);
+        if(index >= preloader->endIndex)
+            break;
+        MjvmPreloadClass &preloadClass = preloader->classes[index];
+        try {
+            preloadClass.classData = preloader->mjvm.preload(preloadClass.text, preloadClass.length);
+        }
+        catch(const char *excp) {
+            /* preloading is speculative, the class will fail again when it is really used */
+        }
+        catch(MjvmOutOfMemoryError *err) {
+
+        }
+    }
+}
+
+void MjvmClassPreloader::loadClasses(uint32_t start) {
+    nextIndex = start;
+    endIndex = count;
+    uint32_t threadCount = count - start - 1;
+    if(threadCount > workerCount)
+        threadCount = workerCount;
+    if(threadCount && doneSemaphore == 0)
+        doneSemaphore = MjvmSystem_SemaphoreCreate(0, workerCount);
+
+    uint32_t createdCount = 0;
+    for(uint32_t i = 0; i < threadCount; i++) {
+        if(MjvmSystem_ThreadCreate((void (*)(void *))threadTask, (void *)this) != 0)
+            createdCount++;
+    }
+    /* the calling thread takes part in the work so preloading also works without any worker */
+    workerTask(this);
+    while(createdCount--)
+        MjvmSystem_SemaphoreTake(doneSemaphore, MJVM_WAIT_FOREVER);
+}
+
+void MjvmClassPreloader::threadTask(MjvmClassPreloader *preloader) {
+    workerTask(preloader);
+    MjvmSystem_SemaphoreGive(preloader->doneSemaphore);
+}
+
+void MjvmClassPreloader::preload(const char *mainClass) {
+    addClass(mainClass, strlen(mainClass));
+    /* each round loads the classes found in the previous one in parallel, then follows their references */
+    for(uint32_t start = 0; start < count;) {
+        uint32_t end = count;
+        loadClasses(start);
+        for(uint32_t i = start; i < end; i++) {
+            if(classes[i].classData)
+                addReferences(*classes[i].classData);
+        }
+        start = end;
+    }
+}
+
+void MjvmClassPreloader::preloadList(const char *fileName) {
+    void *file = MjvmSystem_FileOpen(fileName, MJVM_FILE_READ);
+    if(file == 0)
+        throw "can not open file";
+    uint32_t size;
+    try {
+        size = MjvmSystem_FileSize(file);
+        classList = (char *)Mjvm::malloc(size + 1);
+        uint32_t temp;
+        MjvmSys_FileResult ret = MjvmSystem_FileRead(file, classList, size, &temp);
+        if((ret != FILE_RESULT_OK) || (temp != size))
+            throw "read file error";
+    }
+    catch(const char *excp) {
+        MjvmSystem_FileClose(file);
+        throw excp;
+    }
+    catch(MjvmOutOfMemoryError *err) {
+        MjvmSystem_FileClose(file);
+        throw err;
+    }
+    MjvmSystem_FileClose(file);
+
+    /* one class name per line, in the order they were loaded when the list was recorded */
+    for(uint32_t pos = 0; pos < size;) {
+        uint32_t start = pos;
+        while(pos < size && classList[pos] != '\n' && classList[pos] != '\r')
+            pos++;
+        if(pos > start)
+            addClass(&classList[start], pos - start);
+        pos++;
+    }
+    if(count)
+        loadClasses(0);
+}
+
+MjvmClassPreloader::~MjvmClassPreloader(void) {
+    if(classes)
+        Mjvm::free(classes);
+    if(classList)
+        Mjvm::free(classList);
+    if(doneSemaphore)
+        MjvmSystem_SemaphoreDelete(doneSemaphore);
+}
@@ -1,4 +1,5 @@
 
+#include "mjvm.h"
 #include "mjvm_common.h"
 
 uint16_t Mjvm_Swap16(uint16_t value) {
@@ -33,3 +34,85 @@ uint16_t Mjvm_CalcCrc(const uint8_t *data, uint32_t length) {
         ret += data[i];
     return ret;
 }
+
+bool Mjvm_CompareAndSwap32(volatile int32_t *target, int32_t expected, int32_t value) {
+    return __atomic_compare_exchange_n(target, &expected, value, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+/*
+ * The 64-bit atomics need the __atomic_*_8 library calls on 32-bit targets such as Cortex-M, where libatomic is not linked.
+ * Without native 64-bit compare and swap, they are done under the VM lock instead.
+ */
+bool Mjvm_CompareAndSwap64(volatile int64_t *target, int64_t expected, int64_t value) {
+#if defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_8)
+    return __atomic_compare_exchange_n(target, &expected, value, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#else
+    Mjvm::lock();
+    bool ret = (*target == expected);
+    if(ret)
+        *target = value;
+    Mjvm::unlock();
+    return ret;
+#endif
+}
+
+int32_t Mjvm_GetAndAdd32(volatile int32_t *target, int32_t delta) {
+    return __atomic_fetch_add(target, delta, __ATOMIC_SEQ_CST);
+}
+
+int64_t Mjvm_GetAndAdd64(volatile int64_t *target, int64_t delta) {
+#if defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_8)
+    return __atomic_fetch_add(target, delta, __ATOMIC_SEQ_CST);
+#else
+    Mjvm::lock();
+    int64_t ret = *target;
+    *target = ret + delta;
+    Mjvm::unlock();
+    return ret;
+#endif
+}
+
+int32_t Mjvm_GetAndSet32(volatile int32_t *target, int32_t value) {
+    return __atomic_exchange_n(target, value, __ATOMIC_SEQ_CST);
+}
+
+int64_t Mjvm_GetAndSet64(volatile int64_t *target, int64_t value) {
+#if defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_8)
+    return __atomic_exchange_n(target, value, __ATOMIC_SEQ_CST);
+#else
+    Mjvm::lock();
+    int64_t ret = *target;
+    *target = value;
+    Mjvm::unlock();
+    return ret;
+#endif
+}
+
+int32_t Mjvm_AtomicLoad32(volatile int32_t *target) {
+    return __atomic_load_n(target, __ATOMIC_SEQ_CST);
+}
+
+int64_t Mjvm_AtomicLoad64(volatile int64_t *target) {
+#if defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_8)
+    return __atomic_load_n(target, __ATOMIC_SEQ_CST);
+#else
+    Mjvm::lock();
+    int64_t ret = *target;
+    Mjvm::unlock();
+    return ret;
+#endif
+}
+
+void Mjvm_AtomicStore32(volatile int32_t *target, int32_t value) {
+    __atomic_store_n(target, value, __ATOMIC_SEQ_CST);
+}
+
+void Mjvm_AtomicStore64(volatile int64_t *target, int64_t value) {
+#if defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_8)
+    __atomic_store_n(target, value, __ATOMIC_SEQ_CST);
+#else
+    Mjvm::lock();
+    *target = value;
+    Mjvm::unlock();
+#endif
+}
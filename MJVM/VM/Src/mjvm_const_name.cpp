@@ -27,11 +27,26 @@ const uint32_t stringCoderFieldName[] = {
     (uint32_t)"\x01\x00\x42\x00""B"                     /* field type */
 };
 
+const uint32_t stringHashFieldName[] = {
+    (uint32_t)"\x04\x00\xA4\x01""hash",                 /* field name */
+    (uint32_t)"\x01\x00\x49\x00""I"                     /* field type */
+};
+
 const uint32_t exceptionDetailMessageFieldName[] = {
     (uint32_t)"\x0D\x00\x38\x05""detailMessage",        /* field name */
     (uint32_t)"\x12\x00\xA0\x06""Ljava/lang/String;"    /* field type */
 };
 
+const uint32_t runnableRunMethodName[] = {
+    (uint32_t)"\x03\x00\x55\x01""run",                  /* method name */
+    (uint32_t)"\x03\x00\xA7\x00""()V"                   /* method type */
+};
+
+const uint32_t toStringMethodName[] = {
+    (uint32_t)"\x08\x00\x5A\x03""toString",             /* method name */
+    (uint32_t)"\x14\x00\xF1\x06""()Ljava/lang/String;"  /* method type */
+};
+
 const MjvmConstUtf8 &mathClassName = *(const MjvmConstUtf8 *)"\x0E\x00\x2C\x05""java/lang/Math";
 const MjvmConstUtf8 &classClassName = *(const MjvmConstUtf8 *)"\x0F\x00\x98\x05""java/lang/Class";
 const MjvmConstUtf8 &floatClassName = *(const MjvmConstUtf8 *)"\x0F\x00\x98\x05""java/lang/Float";
@@ -39,12 +54,29 @@ const MjvmConstUtf8 &doubleClassName = *(const MjvmConstUtf8 *)"\x10\x00\xFD\x05
 const MjvmConstUtf8 &objectClassName = *(const MjvmConstUtf8 *)"\x10\x00\xF9\x05""java/lang/Object";
 const MjvmConstUtf8 &systemClassName = *(const MjvmConstUtf8 *)"\x10\x00\x27\x06""java/lang/System";
 const MjvmConstUtf8 &stringClassName = *(const MjvmConstUtf8 *)"\x10\x00\x19\x06""java/lang/String";
+const MjvmConstUtf8 &stringLatin1ClassName = *(const MjvmConstUtf8 *)"\x16\x00\x42\x08""java/lang/StringLatin1";
+const MjvmConstUtf8 &stringUtf16ClassName = *(const MjvmConstUtf8 *)"\x15\x00\x6F\x07""java/lang/StringUTF16";
+const MjvmConstUtf8 &abstractStringBuilderClassName = *(const MjvmConstUtf8 *)"\x1F\x00\x14\x0C""java/lang/AbstractStringBuilder";
+const MjvmConstUtf8 &stringConcatFactoryClassName = *(const MjvmConstUtf8 *)"\x24\x00\x04\x0E""java/lang/invoke/StringConcatFactory";
+const MjvmConstUtf8 &lambdaMetafactoryClassName = *(const MjvmConstUtf8 *)"\x22\x00\x1D\x0D""java/lang/invoke/LambdaMetafactory";
 const MjvmConstUtf8 &characterClassName = *(const MjvmConstUtf8 *)"\x13\x00\x2F\x07""java/lang/Character";
 const MjvmConstUtf8 &throwableClassName = *(const MjvmConstUtf8 *)"\x13\x00\x4A\x07""java/lang/Throwable";
 const MjvmConstUtf8 &printStreamClassName = *(const MjvmConstUtf8 *)"\x13\x00\x51\x07""java/io/PrintStream";
+const MjvmConstUtf8 &unsafeClassName = *(const MjvmConstUtf8 *)"\x18\x00\x31\x09""jdk/internal/misc/Unsafe";
+const MjvmConstUtf8 &atomicLongClassName = *(const MjvmConstUtf8 *)"\x26\x00\xC9\x0E""java/util/concurrent/atomic/AtomicLong";
+const MjvmConstUtf8 &forkJoinPoolClassName = *(const MjvmConstUtf8 *)"\x21\x00\xEC\x0C""java/util/concurrent/ForkJoinPool";
+const MjvmConstUtf8 &atomicIntegerClassName = *(const MjvmConstUtf8 *)"\x29\x00\x07\x10""java/util/concurrent/atomic/AtomicInteger";
+const MjvmConstUtf8 &atomicReferenceClassName = *(const MjvmConstUtf8 *)"\x2B\x00\xC8\x10""java/util/concurrent/atomic/AtomicReference";
+const MjvmConstUtf8 &arraysClassName = *(const MjvmConstUtf8 *)"\x10\x00\x30\x06""java/util/Arrays";
+const MjvmConstUtf8 &hashMapClassName = *(const MjvmConstUtf8 *)"\x11\x00\x60\x06""java/util/HashMap";
+const MjvmConstUtf8 &intIntHashMapClassName = *(const MjvmConstUtf8 *)"\x17\x00\xB6\x08""java/util/IntIntHashMap";
+const MjvmConstUtf8 &integerClassName = *(const MjvmConstUtf8 *)"\x11\x00\x70\x06""java/lang/Integer";
+const MjvmConstUtf8 &longClassName = *(const MjvmConstUtf8 *)"\x0E\x00\x32\x05""java/lang/Long";
 const MjvmConstUtf8 &nullPtrExcpClassName = *(const MjvmConstUtf8 *)"\x1E\x00\xCD\x0B""java/lang/NullPointerException";
+const MjvmConstUtf8 &noClassDefFoundErrorClassName = *(const MjvmConstUtf8 *)"\x1E\x00\x6A\x0B""java/lang/NoClassDefFoundError";
 const MjvmConstUtf8 &arrayStoreExceptionClassName = *(const MjvmConstUtf8 *)"\x1D\x00\x5D\x0B""java/lang/ArrayStoreException";
 const MjvmConstUtf8 &arithmeticExceptionClassName = *(const MjvmConstUtf8 *)"\x1D\x00\x5B\x0B""java/lang/ArithmeticException";
+const MjvmConstUtf8 &numberFormatExceptionClassName = *(const MjvmConstUtf8 *)"\x1F\x00\x23\x0C""java/lang/NumberFormatException";
 const MjvmConstUtf8 &classNotFoundExceptionClassName = *(const MjvmConstUtf8 *)"\x20\x00\x74\x0C""java/lang/ClassNotFoundException";
 const MjvmConstUtf8 &cloneNotSupportedExceptionClassName = *(const MjvmConstUtf8 *)"\x24\x00\x39\x0E""java/lang/CloneNotSupportedException";
 const MjvmConstUtf8 &negativeArraySizeExceptionClassName = *(const MjvmConstUtf8 *)"\x24\x00\x1E\x0E""java/lang/NegativeArraySizeException";
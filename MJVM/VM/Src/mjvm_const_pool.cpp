@@ -59,24 +59,37 @@ name(name), descriptor(descriptor) {
 
 MjvmConstField::MjvmConstField(MjvmConstUtf8 &className, MjvmConstNameAndType &nameAndType) :
 className(className), nameAndType(nameAndType) {
-
+    staticFieldData = 0;
 }
 
 MjvmConstMethod::MjvmConstMethod(MjvmConstUtf8 &className, MjvmConstNameAndType &nameAndType) :
 className(className), nameAndType(nameAndType) {
     paramInfo = parseParamInfo(nameAndType.descriptor);
+    methodInfo = 0;
 }
 
 MjvmConstMethod::MjvmConstMethod(MjvmConstUtf8 &className, MjvmConstNameAndType &nameAndType, uint8_t argc, uint8_t retType) :
 className(className), nameAndType(nameAndType) {
     paramInfo.argc = argc;
     paramInfo.retType = retType;
+    methodInfo = 0;
 }
 
 const MjvmParamInfo &MjvmConstMethod::getParmInfo() {
     return paramInfo;
 }
 
+MjvmConstMethodHandle::MjvmConstMethodHandle(MjvmReferenceKind referenceKind, MjvmConstUtf8 &className, MjvmConstNameAndType &nameAndType) :
+referenceKind(referenceKind), className(className), nameAndType(nameAndType) {
+
+}
+
+MjvmConstInvokeDynamic::MjvmConstInvokeDynamic(uint16_t bootstrapMethodAttrIndex, MjvmConstNameAndType &nameAndType) :
+bootstrapMethodAttrIndex(bootstrapMethodAttrIndex), nameAndType(nameAndType) {
+    lambda = 0;
+    stringConcat = 0;
+}
+
 bool MjvmConstNameAndType::operator==(const MjvmConstNameAndType &another) const {
     if(
         (CONST_UTF8_HASH(name) == CONST_UTF8_HASH(another.name)) &&
@@ -5,7 +5,9 @@
 #include "mjvm_opcodes.h"
 #include "mjvm_execution.h"
 #include "mjvm_const_name.h"
+#include "mjvm_lambda.h"
 #include "mjvm_system_api.h"
+#include "mjvm_string_concat.h"
 
 #if __has_include("mjvm_conf.h")
 #include "mjvm_conf.h"
@@ -20,24 +22,36 @@
 
 static const void **opcodeLabelsExit = 0;
 
-MjvmExecution::MjvmExecution(Mjvm &mjvm) : mjvm(mjvm), stackLength(DEFAULT_STACK_SIZE / sizeof(int32_t)) {
-    opcodes = 0;
-    lr = -1;
-    sp = -1;
-    startSp = sp;
-    peakSp = sp;
-    stack = (int32_t *)Mjvm::malloc(DEFAULT_STACK_SIZE);
-    stackType = (uint8_t *)Mjvm::malloc(DEFAULT_STACK_SIZE / sizeof(int32_t) / 8);
+static bool isClassReady(ClassData &classData, MjvmExecution *execution) {
+    if(classData.initState == CLASS_INITIALIZED)
+        return true;
+    /* the static constructor of the class is running in this execution */
+    return (classData.initState == CLASS_INITIALIZING) && (classData.initOwnId == (uint32_t)execution);
+}
+
+static void quickenOpcode(const uint8_t *code, uint8_t opcode) {
+    __atomic_store_n((uint8_t *)code, opcode, __ATOMIC_RELEASE);
 }
 
-MjvmExecution::MjvmExecution(Mjvm &mjvm, uint32_t size) : mjvm(mjvm), stackLength(size / sizeof(int32_t)) {
+MjvmExecution::MjvmExecution(Mjvm &mjvm) : MjvmExecution(mjvm, DEFAULT_STACK_SIZE) {
+
+}
+
+MjvmExecution::MjvmExecution(Mjvm &mjvm, uint32_t size) : mjvm(mjvm), maxStackLength(size / sizeof(int32_t)) {
     opcodes = 0;
     lr = -1;
     sp = -1;
     startSp = sp;
     peakSp = sp;
-    stack = (int32_t *)Mjvm::malloc(size);
-    stackType = (uint8_t *)Mjvm::malloc(size / sizeof(int32_t) / 8);
+    concatSp = sp;
+    stackLength = ((size < INITIAL_STACK_SIZE) ? size : INITIAL_STACK_SIZE) / sizeof(int32_t);
+    stack = (int32_t *)Mjvm::malloc(stackLength * sizeof(int32_t));
+    stackType = (uint8_t *)Mjvm::malloc((stackLength + 7) / 8);
+    locals = stack;
+    /* the completion semaphore holds its signal while the execution is not running */
+    completion = MjvmSystem_SemaphoreCreate(1, 1);
+    isFinished = true;
+    isReleaseRequested = false;
 }
 
 MjvmStackType MjvmExecution::getStackType(uint32_t index) {
@@ -185,6 +199,42 @@ bool MjvmExecution::readLocal(uint32_t stackIndex, uint32_t localIndex, uint64_t
     return true;
 }
 
+void MjvmExecution::stackEnsureLength(uint32_t length) {
+    if(length <= stackLength)
+        return;
+    if(length > maxStackLength)
+        throw "stack overflow";
+    uint32_t newLength = stackLength * 2;
+    if(newLength < length)
+        newLength = length;
+    if(newLength > maxStackLength)
+        newLength = maxStackLength;
+    /* the garbage collector may scan this stack from another thread while it is moved */
+    Mjvm::lock();
+    try {
+        int32_t *newStack = (int32_t *)Mjvm::realloc(stack, newLength * sizeof(int32_t));
+        locals = &newStack[locals - stack];
+        stack = newStack;
+        stackType = (uint8_t *)Mjvm::realloc(stackType, (newLength + 7) / 8);
+    }
+    catch(MjvmOutOfMemoryError *err) {
+        Mjvm::unlock();
+        throw err;
+    }
+    stackLength = newLength;
+    Mjvm::unlock();
+}
+
+void MjvmExecution::stackShrink(void) {
+    uint32_t length = ((maxStackLength * sizeof(int32_t)) < INITIAL_STACK_SIZE) ? maxStackLength : (INITIAL_STACK_SIZE / sizeof(int32_t));
+    if(peakSp >= 0 || stackLength <= length)
+        return;
+    /* shrinking a block in place never fails */
+    stack = (int32_t *)Mjvm::realloc(stack, length * sizeof(int32_t));
+    stackType = (uint8_t *)Mjvm::realloc(stackType, (length + 7) / 8);
+    stackLength = length;
+}
+
 void MjvmExecution::stackInitExitPoint(uint32_t exitPc) {
     stack[++sp] = (int32_t)method;              /* method */
     stackType[sp / 8] &= ~(1 << (sp % 8));
@@ -198,6 +248,12 @@ void MjvmExecution::stackInitExitPoint(uint32_t exitPc) {
 }
 
 void MjvmExecution::stackRestoreContext(void) {
+    if((method->accessFlag & METHOD_STATIC) == METHOD_STATIC) {
+        ClassData &classData = *(ClassData *)&method->classLoader;
+        /* the static constructor is unwound by an exception */
+        if(classData.initSp == startSp && classData.initOwnId == (uint32_t)this)
+            mjvm.finishClassInit(classData, false);
+    }
     if((method->accessFlag & METHOD_SYNCHRONIZED) == METHOD_SYNCHRONIZED) {
         Mjvm::lock();
         if((method->accessFlag & METHOD_STATIC) != METHOD_STATIC) {
@@ -221,8 +277,7 @@ void MjvmExecution::stackRestoreContext(void) {
 
 void MjvmExecution::initNewContext(MjvmMethodInfo &methodInfo, uint16_t argc) {
     MjvmCodeAttribute &attributeCode = methodInfo.getAttributeCode();
-    if((sp + attributeCode.maxLocals + attributeCode.maxStack) >= stackLength)
-        throw "stack overflow";
+    stackEnsureLength(sp + attributeCode.maxLocals + attributeCode.maxStack + 1);
     method = &methodInfo;
     code = attributeCode.code;
     pc = 0;
@@ -237,6 +292,9 @@ void MjvmExecution::initNewContext(MjvmMethodInfo &methodInfo, uint16_t argc) {
 
 bool MjvmExecution::invoke(MjvmMethodInfo &methodInfo, uint8_t argc) {
     if((methodInfo.accessFlag & METHOD_NATIVE) != METHOD_NATIVE) {
+        /* room for the saved context, the locals and the operand stack of the new frame */
+        MjvmCodeAttribute &attributeCode = methodInfo.getAttributeCode();
+        stackEnsureLength(sp + 4 + attributeCode.maxLocals + attributeCode.maxStack + 1);
         peakSp = sp + 4;
         for(uint32_t i = 0; i < argc; i++) {
             MjvmStackValue stackValue = getStackValue(sp - i);
@@ -269,9 +327,7 @@ bool MjvmExecution::invoke(MjvmMethodInfo &methodInfo, uint8_t argc) {
     }
 }
 
-bool MjvmExecution::invokeStatic(MjvmConstMethod &constMethod) {
-    uint8_t argc = constMethod.getParmInfo().argc;
-    MjvmMethodInfo &methodInfo = mjvm.findMethod(constMethod);
+bool MjvmExecution::invokeStatic(MjvmMethodInfo &methodInfo, uint8_t argc) {
     if((methodInfo.accessFlag & METHOD_STATIC) == METHOD_STATIC) {
         if((methodInfo.accessFlag & METHOD_SYNCHRONIZED) == METHOD_SYNCHRONIZED) {
             ClassData &classData = *(ClassData *)&methodInfo.classLoader;
@@ -337,7 +393,7 @@ bool MjvmExecution::invokeVirtual(MjvmConstMethod &constMethod) {
         stackPushObject(excpObj);
         return false;
     }
-    MjvmConstUtf8 &type = MjvmObject::isPrimType(obj->type) ? *(MjvmConstUtf8 *)&objectClassName : obj->type;
+    MjvmConstUtf8 &type = (obj->dimensions || MjvmObject::isPrimType(obj->type)) ? *(MjvmConstUtf8 *)&objectClassName : obj->type;
     MjvmConstMethod virtualConstMethod(type, constMethod.nameAndType, 0, 0);
     MjvmMethodInfo &methodInfo = mjvm.findMethod(virtualConstMethod);
     if((methodInfo.accessFlag & METHOD_STATIC) != METHOD_STATIC) {
@@ -375,6 +431,10 @@ bool MjvmExecution::invokeInterface(MjvmConstInterfaceMethod &interfaceMethod, u
         stackPushObject(excpObj);
         return false;
     }
+    /* the other methods of a lambda are looked up from the interface like those of an ordinary object */
+    MjvmLambda *lambda = MjvmLambda::getLambda(obj);
+    if(lambda && (argc == lambda->methodArgc + 1) && (interfaceMethod.nameAndType.name == lambda->methodName))
+        return invokeLambda(*lambda, argc);
     MjvmConstUtf8 &type = MjvmObject::isPrimType(obj->type) ? *(MjvmConstUtf8 *)&objectClassName : obj->type;
     MjvmConstMethod interfaceConstMethod(type, interfaceMethod.nameAndType, 0, 0);
     MjvmMethodInfo &methodInfo = mjvm.findMethod(interfaceConstMethod);
@@ -403,7 +463,109 @@ bool MjvmExecution::invokeInterface(MjvmConstInterfaceMethod &interfaceMethod, u
         throw "invoke interface to static method";
 }
 
-void MjvmExecution::run(void) {
+bool MjvmExecution::invokeLambda(MjvmLambda &lambda, uint8_t argc) {
+    int32_t base = sp - argc + 1;
+    const int32_t *args = MjvmLambda::getArgs((MjvmObject *)stack[base]);
+    MjvmReferenceKind referenceKind = lambda.methodHandle.referenceKind;
+    MjvmMethodInfo *methodInfo = lambda.implMethod;
+    MjvmObject *obj = 0;
+    if(referenceKind == REF_NEW_INVOKE_SPECIAL) {
+        ClassData &classData = *(ClassData *)&methodInfo->classLoader;
+        obj = mjvm.newObject(sizeof(MjvmFieldsData), classData.getThisClass());
+        new ((MjvmFieldsData *)obj->data)MjvmFieldsData(mjvm, classData, false);
+    }
+    else if(referenceKind != REF_INVOKE_STATIC) {
+        /* the receiver is the first captured argument or the first argument of the interface method */
+        obj = (MjvmObject *)(lambda.capturedArgc ? args[0] : stack[base + 1]);
+        if(obj == 0) {
+            const char *msg[] = {"Cannot invoke ", lambda.methodHandle.className.text, ".", lambda.methodHandle.nameAndType.name.text, " by null object"};
+            MjvmString *strObj = mjvm.newString(msg, LENGTH(msg));
+            MjvmThrowable *excpObj = mjvm.newNullPointerException(strObj);
+            stackPushObject(excpObj);
+            return false;
+        }
+        if(methodInfo == 0) {
+            MjvmConstUtf8 &type = (obj->dimensions || MjvmObject::isPrimType(obj->type)) ? *(MjvmConstUtf8 *)&objectClassName : obj->type;
+            MjvmConstMethod virtualConstMethod(type, lambda.methodHandle.nameAndType, 0, 0);
+            methodInfo = &mjvm.findMethod(virtualConstMethod);
+        }
+    }
+    /* the monitor is taken before the stack is changed so that a busy one only makes the instruction run again */
+    if((methodInfo->accessFlag & METHOD_SYNCHRONIZED) == METHOD_SYNCHRONIZED) {
+        Mjvm::lock();
+        if((methodInfo->accessFlag & METHOD_STATIC) == METHOD_STATIC) {
+            ClassData &classData = *(ClassData *)&methodInfo->classLoader;
+            if(classData.monitorCount == 0 || classData.ownId == (int32_t)this) {
+                classData.ownId = (int32_t)this;
+                if(classData.monitorCount < 0x7FFFFFFF)
+                    classData.monitorCount++;
+                else {
+                    Mjvm::unlock();
+                    throw "monitorCount limit has been reached";
+                }
+            }
+            else {
+                Mjvm::unlock();
+                return true;
+            }
+        }
+        else {
+            if(obj->monitorCount == 0 || obj->ownId == (int32_t)this) {
+                obj->ownId = (int32_t)this;
+                if(obj->monitorCount < 0xFFFFFF)
+                    obj->monitorCount++;
+                else {
+                    Mjvm::unlock();
+                    throw "monitorCount limit has been reached";
+                }
+            }
+            else {
+                Mjvm::unlock();
+                return true;
+            }
+        }
+        Mjvm::unlock();
+    }
+
+    /* the lambda object is replaced by its captured arguments, a constructor also gets the new object twice unless the result is void */
+    uint8_t newCount = 0;
+    if(referenceKind == REF_NEW_INVOKE_SPECIAL)
+        newCount = lambda.isVoidMethod ? 1 : 2;
+    int32_t shift = lambda.capturedArgc + newCount - 1;
+    if(shift > 0) {
+        stackEnsureLength(sp + shift + 1);
+        for(int32_t i = sp; i > base; i--) {
+            MjvmStackValue stackValue = getStackValue(i);
+            setStackValue(i + shift, stackValue);
+        }
+    }
+    else if(shift < 0) {
+        for(int32_t i = base + 1; i <= sp; i++) {
+            MjvmStackValue stackValue = getStackValue(i);
+            setStackValue(i + shift, stackValue);
+        }
+    }
+    sp = peakSp = sp + shift;
+    int32_t index = base;
+    for(uint8_t i = 0; i < newCount; i++) {
+        stack[index] = (int32_t)obj;
+        stackType[index / 8] |= (1 << (index % 8));
+        index++;
+    }
+    if(newCount && (obj->getProtected() & 0x02))
+        mjvm.clearProtectObjectNew(obj);
+    for(uint8_t i = 0; i < lambda.capturedArgc; i++) {
+        stack[index] = args[i];
+        if(lambda.isObjectArg(i))
+            stackType[index / 8] |= (1 << (index % 8));
+        else
+            stackType[index / 8] &= ~(1 << (index % 8));
+        index++;
+    }
+    return invoke(*methodInfo, argc - 1 + lambda.capturedArgc + (newCount ? 1 : 0));
+}
+
+void MjvmExecution::run(MjvmObject *thisObj) {
     static const void *opcodeLabels[256] = {
         &&op_nop, &&op_aconst_null, &&op_iconst_m1, &&op_iconst_0, &&op_iconst_1, &&op_iconst_2, &&op_iconst_3, &&op_iconst_4, &&op_iconst_5,
         &&op_lconst_0, &&op_lconst_1, &&op_fconst_0, &&op_fconst_1, &&op_fconst_2, &&op_dconst_0, &&op_dconst_1, &&op_bipush, &&op_sipush,
@@ -425,8 +587,9 @@ void MjvmExecution::run(void) {
         &&op_dreturn, &&op_areturn, &&op_return, &&op_getstatic, &&op_putstatic, &&op_getfield, &&op_putfield, &&op_invokevirtual,
         &&op_invokespecial, &&op_invokestatic, &&op_invokeinterface, &&op_invokedynamic, &&op_new, &&op_newarray, &&op_anewarray,
         &&op_arraylength, &&op_athrow, &&op_checkcast, &&op_instanceof, &&op_monitorenter, &&op_monitorexit, &&op_wide, &&op_multianewarray,
-        &&op_ifnull, &&op_ifnonnull, &&op_goto_w, &&op_jsrw, &&op_breakpoint, &&op_unknow, &&op_unknow, &&op_unknow, &&op_unknow, &&op_unknow,
-        &&op_unknow, &&op_unknow, &&op_unknow, &&op_unknow, &&op_unknow, &&op_unknow, &&op_unknow, &&op_unknow, &&op_unknow, &&op_unknow,
+        &&op_ifnull, &&op_ifnonnull, &&op_goto_w, &&op_jsrw, &&op_breakpoint, &&op_getstatic_quick_32, &&op_getstatic_quick_64,
+        &&op_getstatic_quick_obj, &&op_putstatic_quick_8, &&op_putstatic_quick_16, &&op_putstatic_quick_32, &&op_putstatic_quick_64,
+        &&op_putstatic_quick_obj, &&op_invokestatic_quick, &&op_new_quick, &&op_unknow, &&op_unknow, &&op_unknow, &&op_unknow, &&op_unknow,
         &&op_unknow, &&op_unknow, &&op_unknow, &&op_unknow, &&op_unknow, &&op_unknow, &&op_unknow, &&op_unknow, &&op_unknow, &&op_unknow,
         &&op_unknow, &&op_unknow, &&op_unknow, &&op_unknow, &&op_unknow, &&op_unknow, &&op_unknow, &&op_unknow, &&op_unknow, &&op_unknow,
         &&op_unknow, &&op_unknow, &&op_unknow, &&op_unknow, &&op_unknow, &&op_unknow, &&op_unknow, &&op_unknow, &&op_unknow, &&op_unknow,
@@ -496,19 +659,21 @@ void MjvmExecution::run(void) {
     opcodes = dbg ? opcodeLabelsDebug : opcodeLabels;
 
     MjvmLoadFileError *fileNotFound = 0;
+    ClassData *classDataToInit = 0;
+    bool isInitClaimed = false;
 
     stackInitExitPoint(method->getAttributeCode().codeLength);
 
-    initNewContext(*method);
+    if(thisObj) {
+        stack[sp + 1] = (int32_t)thisObj;
+        stackType[(sp + 1) / 8] |= (1 << ((sp + 1) % 8));
+        initNewContext(*method, 1);
+    }
+    else
+        initNewContext(*method);
 
-    if((int32_t)&method->classLoader.getStaticConstructor() != 0) {
-        try {
-            stackPushInt32((int32_t)(ClassData *)&method->classLoader);
-        }
-        catch(MjvmLoadFileError *file) {
-            fileNotFound = file;
-            goto file_not_found_excp;
-        }
+    if(!isClassReady(*(ClassData *)&method->classLoader, this)) {
+        classDataToInit = (ClassData *)&method->classLoader;
         goto init_static_field;
     }
 
@@ -1625,13 +1790,6 @@ void MjvmExecution::run(void) {
     op_ireturn:
     op_freturn: {
         int32_t retVal = stackPopInt32();
-        if((method->accessFlag & METHOD_STATIC) == METHOD_STATIC) {
-            ClassData &classData = *(ClassData *)&method->classLoader;
-            if(classData.isInitializing) {
-                classData.isInitializing = 0;
-                Mjvm::unlock();
-            }
-        }
         stackRestoreContext();
         stackPushInt32(retVal);
         pc = lr;
@@ -1640,13 +1798,6 @@ void MjvmExecution::run(void) {
     op_lreturn:
     op_dreturn: {
         int64_t retVal = stackPopInt64();
-        if((method->accessFlag & METHOD_STATIC) == METHOD_STATIC) {
-            ClassData &classData = *(ClassData *)&method->classLoader;
-            if(classData.isInitializing) {
-                classData.isInitializing = 0;
-                Mjvm::unlock();
-            }
-        }
         stackRestoreContext();
         stackPushInt64(retVal);
         pc = lr;
@@ -1654,13 +1805,6 @@ void MjvmExecution::run(void) {
     }
     op_areturn: {
         int32_t retVal = (int32_t)stackPopObject();
-        if((method->accessFlag & METHOD_STATIC) == METHOD_STATIC) {
-            ClassData &classData = *(ClassData *)&method->classLoader;
-            if(classData.isInitializing) {
-                classData.isInitializing = 0;
-                Mjvm::unlock();
-            }
-        }
         stackRestoreContext();
         stackPushObject((MjvmObject *)retVal);
         pc = lr;
@@ -1669,10 +1813,8 @@ void MjvmExecution::run(void) {
     op_return: {
         if((method->accessFlag & METHOD_STATIC) == METHOD_STATIC) {
             ClassData &classData = *(ClassData *)&method->classLoader;
-            if(classData.isInitializing) {
-                classData.isInitializing = 0;
-                Mjvm::unlock();
-            }
+            if(classData.initSp == startSp && classData.initOwnId == (uint32_t)this)
+                mjvm.finishClassInit(classData, true);
         }
         stackRestoreContext();
         peakSp = sp;
@@ -1681,75 +1823,107 @@ void MjvmExecution::run(void) {
     }
     op_getstatic: {
         MjvmConstField &constField = method->classLoader.getConstField(ARRAY_TO_INT16(&code[pc + 1]));
-        MjvmFieldsData &fields = mjvm.getStaticFields(constField.className);
-        if((int32_t)&fields == 0) {
-            try {
-                stackPushInt32((int32_t)(ClassData *)&mjvm.load(constField.className));
-            }
-            catch(MjvmLoadFileError *file) {
-                fileNotFound = file;
-                goto file_not_found_excp;
-            }
+        ClassData *classData;
+        try {
+            classData = (ClassData *)&mjvm.load(constField.className);
+        }
+        catch(MjvmLoadFileError *file) {
+            fileNotFound = file;
+            goto file_not_found_excp;
+        }
+        if(!isClassReady(*classData, this)) {
+            classDataToInit = classData;
             goto init_static_field;
         }
+        MjvmFieldsData &fields = *classData->staticFiledsData;
+        /* the opcode is only quickened once the class is fully initialized */
+        bool isQuickenable = (classData->initState == CLASS_INITIALIZED);
         switch(constField.nameAndType.descriptor.text[0]) {
             case 'J':
             case 'D': {
-                stackPushInt64(fields.getFieldData64(constField.nameAndType).value);
-                pc += 3;
-                goto *opcodes[code[pc]];
+                MjvmFieldData64 &fieldData = fields.getFieldData64(constField.nameAndType);
+                if((fieldData.fieldInfo.accessFlag & FIELD_VOLATILE) == FIELD_VOLATILE) {
+                    stackPushInt64(Mjvm_AtomicLoad64(&fieldData.value));
+                    pc += 3;
+                    goto *opcodes[code[pc]];
+                }
+                constField.staticFieldData = &fieldData;
+                if(isQuickenable)
+                    quickenOpcode(&code[pc], OP_GETSTATIC_QUICK_64);
+                goto op_getstatic_quick_64;
             }
             case 'L':
             case '[': {
-                stackPushObject(fields.getFieldObject(constField.nameAndType).object);
-                pc += 3;
-                goto *opcodes[code[pc]];
+                constField.staticFieldData = &fields.getFieldObject(constField.nameAndType);
+                if(isQuickenable)
+                    quickenOpcode(&code[pc], OP_GETSTATIC_QUICK_OBJ);
+                goto op_getstatic_quick_obj;
             }
             default: {
-                stackPushInt32(fields.getFieldData32(constField.nameAndType).value);
-                pc += 3;
-                goto *opcodes[code[pc]];
+                constField.staticFieldData = &fields.getFieldData32(constField.nameAndType);
+                if(isQuickenable)
+                    quickenOpcode(&code[pc], OP_GETSTATIC_QUICK_32);
+                goto op_getstatic_quick_32;
             }
         }
     }
     op_putstatic: {
         MjvmConstField &constField = method->classLoader.getConstField(ARRAY_TO_INT16(&code[pc + 1]));
-        MjvmFieldsData &fields = mjvm.getStaticFields(constField.className);
-        if((int32_t)&fields == 0) {
-            try {
-                stackPushInt32((int32_t)(ClassData *)&mjvm.load(constField.className));
-            }
-            catch(MjvmLoadFileError *file) {
-                fileNotFound = file;
-                goto file_not_found_excp;
-            }
+        ClassData *classData;
+        try {
+            classData = (ClassData *)&mjvm.load(constField.className);
+        }
+        catch(MjvmLoadFileError *file) {
+            fileNotFound = file;
+            goto file_not_found_excp;
+        }
+        if(!isClassReady(*classData, this)) {
+            classDataToInit = classData;
             goto init_static_field;
         }
-        pc += 3;
+        MjvmFieldsData &fields = *classData->staticFiledsData;
+        /* the opcode is only quickened once the class is fully initialized */
+        bool isQuickenable = (classData->initState == CLASS_INITIALIZED);
         switch(constField.nameAndType.descriptor.text[0]) {
             case 'Z':
             case 'B': {
-                fields.getFieldData32(constField.nameAndType).value = (int8_t)stackPopInt32();
-                goto *opcodes[code[pc]];
+                constField.staticFieldData = &fields.getFieldData32(constField.nameAndType);
+                if(isQuickenable)
+                    quickenOpcode(&code[pc], OP_PUTSTATIC_QUICK_8);
+                goto op_putstatic_quick_8;
             }
             case 'C':
             case 'S': {
-                fields.getFieldData32(constField.nameAndType).value = (int16_t)stackPopInt32();
-                goto *opcodes[code[pc]];
+                constField.staticFieldData = &fields.getFieldData32(constField.nameAndType);
+                if(isQuickenable)
+                    quickenOpcode(&code[pc], OP_PUTSTATIC_QUICK_16);
+                goto op_putstatic_quick_16;
             }
             case 'J':
             case 'D': {
-                fields.getFieldData64(constField.nameAndType).value = stackPopInt64();
-                goto *opcodes[code[pc]];
+                MjvmFieldData64 &fieldData = fields.getFieldData64(constField.nameAndType);
+                if((fieldData.fieldInfo.accessFlag & FIELD_VOLATILE) == FIELD_VOLATILE) {
+                    Mjvm_AtomicStore64(&fieldData.value, stackPopInt64());
+                    pc += 3;
+                    goto *opcodes[code[pc]];
+                }
+                constField.staticFieldData = &fieldData;
+                if(isQuickenable)
+                    quickenOpcode(&code[pc], OP_PUTSTATIC_QUICK_64);
+                goto op_putstatic_quick_64;
             }
             case 'L':
             case '[': {
-                fields.getFieldObject(constField.nameAndType).object = stackPopObject();
-                goto *opcodes[code[pc]];
+                constField.staticFieldData = &fields.getFieldObject(constField.nameAndType);
+                if(isQuickenable)
+                    quickenOpcode(&code[pc], OP_PUTSTATIC_QUICK_OBJ);
+                goto op_putstatic_quick_obj;
             }
             default: {
-                fields.getFieldData32(constField.nameAndType).value = stackPopInt32();
-                goto *opcodes[code[pc]];
+                constField.staticFieldData = &fields.getFieldData32(constField.nameAndType);
+                if(isQuickenable)
+                    quickenOpcode(&code[pc], OP_PUTSTATIC_QUICK_32);
+                goto op_putstatic_quick_32;
             }
         }
     }
@@ -1763,7 +1937,11 @@ void MjvmExecution::run(void) {
                 if(obj == 0)
                     goto getfield_null_excp;
                 MjvmFieldsData &fields = *(MjvmFieldsData *)obj->data;
-                stackPushInt64(fields.getFieldData64(constField.nameAndType).value);
+                MjvmFieldData64 &fieldData = fields.getFieldData64(constField.nameAndType);
+                if((fieldData.fieldInfo.accessFlag & FIELD_VOLATILE) == FIELD_VOLATILE)
+                    stackPushInt64(Mjvm_AtomicLoad64(&fieldData.value));
+                else
+                    stackPushInt64(fieldData.value);
                 goto *opcodes[code[pc]];
             }
             case 'L':
@@ -1829,7 +2007,11 @@ void MjvmExecution::run(void) {
                 if(obj == 0)
                     goto putfield_null_excp;
                 MjvmFieldsData &fields = *(MjvmFieldsData *)obj->data;
-                fields.getFieldData64(constField.nameAndType).value = value;
+                MjvmFieldData64 &fieldData = fields.getFieldData64(constField.nameAndType);
+                if((fieldData.fieldInfo.accessFlag & FIELD_VOLATILE) == FIELD_VOLATILE)
+                    Mjvm_AtomicStore64(&fieldData.value, value);
+                else
+                    fieldData.value = value;
                 goto *opcodes[code[pc]];
             }
             case 'L':
@@ -1894,16 +2076,23 @@ void MjvmExecution::run(void) {
     }
     op_invokestatic: {
         MjvmConstMethod &constMethod = method->classLoader.getConstMethod(ARRAY_TO_INT16(&code[pc + 1]));
-        lr = pc + 3;
+        MjvmMethodInfo *methodInfo;
         try {
-            if(!invokeStatic(constMethod))
-                goto exception_handler;
+            methodInfo = &mjvm.findMethod(constMethod);
         }
         catch(MjvmLoadFileError *file) {
             fileNotFound = file;
             goto file_not_found_excp;
         }
-        goto *opcodes[code[pc]];
+        ClassData &classData = *(ClassData *)&methodInfo->classLoader;
+        if(!isClassReady(classData, this)) {
+            classDataToInit = &classData;
+            goto init_static_field;
+        }
+        constMethod.methodInfo = methodInfo;
+        if(classData.initState == CLASS_INITIALIZED)
+            quickenOpcode(&code[pc], OP_INVOKESTATIC_QUICK);
+        goto op_invokestatic_quick;
     }
     op_invokeinterface: {
         MjvmConstInterfaceMethod &interfaceMethod = method->classLoader.getConstInterfaceMethod(ARRAY_TO_INT16(&code[pc + 1]));
@@ -1920,38 +2109,110 @@ void MjvmExecution::run(void) {
         goto *opcodes[code[pc]];
     }
     op_invokedynamic: {
-        // TODO
-        // goto *opcodes[code[pc]];
-        MjvmString *strObj = mjvm.newString(STR_AND_SIZE("Invokedynamic instructions are not supported"));
-        try {
-            MjvmThrowable *excpObj = mjvm.newUnsupportedOperationException(strObj);
-            stackPushObject(excpObj);
+        MjvmConstInvokeDynamic &constInvokeDynamic = method->classLoader.getConstInvokeDynamic(ARRAY_TO_INT16(&code[pc + 1]));
+        MjvmLambda *lambda = constInvokeDynamic.lambda;
+        MjvmStringConcat *stringConcat = constInvokeDynamic.stringConcat;
+        if(lambda == 0 && stringConcat == 0) {
+            /* only the string concatenation and the lambda bootstraps are supported, the call site is linked on the first call */
+            try {
+                stringConcat = MjvmStringConcat::link(mjvm, method->classLoader, constInvokeDynamic);
+                if(stringConcat == 0)
+                    lambda = MjvmLambda::link(mjvm, method->classLoader, constInvokeDynamic);
+            }
+            catch(MjvmLoadFileError *file) {
+                fileNotFound = file;
+                goto file_not_found_excp;
+            }
+            if(lambda == 0 && stringConcat == 0) {
+                MjvmString *strObj = mjvm.newString(STR_AND_SIZE("Invokedynamic instructions are not supported"));
+                try {
+                    MjvmThrowable *excpObj = mjvm.newUnsupportedOperationException(strObj);
+                    stackPushObject(excpObj);
+                }
+                catch(MjvmLoadFileError *file) {
+                    fileNotFound = file;
+                    goto file_not_found_excp;
+                }
+                goto exception_handler;
+            }
+            Mjvm::lock();
+            if(constInvokeDynamic.lambda == 0 && constInvokeDynamic.stringConcat == 0) {
+                constInvokeDynamic.lambda = lambda;
+                constInvokeDynamic.stringConcat = stringConcat;
+            }
+            else {
+                Mjvm::free(lambda ? (void *)lambda : (void *)stringConcat);
+                lambda = constInvokeDynamic.lambda;
+                stringConcat = constInvokeDynamic.stringConcat;
+            }
+            Mjvm::unlock();
         }
-        catch(MjvmLoadFileError *file) {
-            fileNotFound = file;
-            goto file_not_found_excp;
+        if(lambda) {
+            /* the class of a static method or a constructor is initialized before the lambda is made */
+            MjvmReferenceKind referenceKind = lambda->methodHandle.referenceKind;
+            if(referenceKind == REF_INVOKE_STATIC || referenceKind == REF_NEW_INVOKE_SPECIAL) {
+                ClassData &classData = *(ClassData *)&lambda->implMethod->classLoader;
+                if(!isClassReady(classData, this)) {
+                    classDataToInit = &classData;
+                    goto init_static_field;
+                }
+            }
+            MjvmObject *obj = lambda->newObject(mjvm, &stack[sp - lambda->capturedArgc + 1]);
+            sp -= lambda->capturedArgc;
+            stackPushObject(obj);
+            pc += 5;
+            goto *opcodes[code[pc]];
         }
-        goto exception_handler;
-    }
-    op_new: {
-        uint16_t poolIndex = ARRAY_TO_INT16(&code[pc + 1]);
-        MjvmConstUtf8 &constClass =  method->classLoader.getConstUtf8Class(poolIndex);
-        MjvmObject *obj = mjvm.newObject(sizeof(MjvmFieldsData), constClass);
-        try {
-            ClassData &classData = *(ClassData *)&mjvm.load(constClass.text);
-            new ((MjvmFieldsData *)obj->data)MjvmFieldsData(mjvm, classData, false);
+        if(sp == concatSp) {
+            /* back from the toString call of an argument, the result takes the place of the object */
+            MjvmObject *strObj = stackPopObject();
+            concatSp = stackPopInt32();
+            int32_t *args = &stack[sp - stringConcat->argc + 1];
+            args[stringConcat->findObjectArgument(args)] = (int32_t)strObj;
+        }
+        int32_t *args = &stack[sp - stringConcat->argc + 1];
+        int32_t index = stringConcat->findObjectArgument(args);
+        if(index >= 0) {
+            /* the instruction runs again when toString returns, concatSp links the pending calls on the stack */
+            MjvmObject *obj = (MjvmObject *)args[index];
+            stackEnsureLength(sp + 3);
+            stackPushInt32(concatSp);
             stackPushObject(obj);
-            pc += 3;
-            if((classData.staticFiledsData == 0) && ((int32_t)&classData.getStaticConstructor() != 0)) {
-                stackPushInt32((int32_t)&classData);
-                goto init_static_field;
+            concatSp = sp;
+            MjvmConstMethod toStringMethod(*(MjvmConstUtf8 *)&objectClassName, *(MjvmConstNameAndType *)toStringMethodName, 0, 0);
+            lr = pc;
+            try {
+                if(!invokeVirtual(toStringMethod))
+                    goto exception_handler;
+            }
+            catch(MjvmLoadFileError *file) {
+                fileNotFound = file;
+                goto file_not_found_excp;
             }
             goto *opcodes[code[pc]];
         }
+        MjvmString *strObj = stringConcat->concat(mjvm, args);
+        sp -= stringConcat->argc;
+        stackPushObject(strObj);
+        pc += 5;
+        goto *opcodes[code[pc]];
+    }
+    op_new: {
+        ClassData *classData;
+        try {
+            classData = (ClassData *)&method->classLoader.getConstClassLoader(mjvm, ARRAY_TO_INT16(&code[pc + 1]));
+        }
         catch(MjvmLoadFileError *file) {
             fileNotFound = file;
             goto file_not_found_excp;
         }
+        if(!isClassReady(*classData, this)) {
+            classDataToInit = classData;
+            goto init_static_field;
+        }
+        if(classData->initState == CLASS_INITIALIZED)
+            quickenOpcode(&code[pc], OP_NEW_QUICK);
+        goto op_new_quick;
     }
     op_newarray: {
         int32_t count = stackPopInt32();
@@ -2029,6 +2290,9 @@ void MjvmExecution::run(void) {
                         while(startSp > traceStartSp)
                             stackRestoreContext();
                         sp = startSp + method->getAttributeCode().maxLocals;
+                        /* drop the pending toString calls of string concatenation that were unwound */
+                        while(concatSp > sp)
+                            concatSp = stack[concatSp - 1];
                         stackPushObject(obj);
                         pc = exceptionTable.handlerPc;
                         goto *opcodes[code[pc]];
@@ -2220,20 +2484,195 @@ void MjvmExecution::run(void) {
     op_breakpoint:
         pc++;
         goto *opcodes[code[pc]];
+    op_getstatic_quick_32: {
+        MjvmConstField &constField = method->classLoader.getConstField(ARRAY_TO_INT16(&code[pc + 1]));
+        stackPushInt32(((MjvmFieldData32 *)constField.staticFieldData)->value);
+        pc += 3;
+        goto *opcodes[code[pc]];
+    }
+    op_getstatic_quick_64: {
+        MjvmConstField &constField = method->classLoader.getConstField(ARRAY_TO_INT16(&code[pc + 1]));
+        stackPushInt64(((MjvmFieldData64 *)constField.staticFieldData)->value);
+        pc += 3;
+        goto *opcodes[code[pc]];
+    }
+    op_getstatic_quick_obj: {
+        MjvmConstField &constField = method->classLoader.getConstField(ARRAY_TO_INT16(&code[pc + 1]));
+        stackPushObject(((MjvmFieldObject *)constField.staticFieldData)->object);
+        pc += 3;
+        goto *opcodes[code[pc]];
+    }
+    op_putstatic_quick_8: {
+        MjvmConstField &constField = method->classLoader.getConstField(ARRAY_TO_INT16(&code[pc + 1]));
+        ((MjvmFieldData32 *)constField.staticFieldData)->value = (int8_t)stackPopInt32();
+        pc += 3;
+        goto *opcodes[code[pc]];
+    }
+    op_putstatic_quick_16: {
+        MjvmConstField &constField = method->classLoader.getConstField(ARRAY_TO_INT16(&code[pc + 1]));
+        ((MjvmFieldData32 *)constField.staticFieldData)->value = (int16_t)stackPopInt32();
+        pc += 3;
+        goto *opcodes[code[pc]];
+    }
+    op_putstatic_quick_32: {
+        MjvmConstField &constField = method->classLoader.getConstField(ARRAY_TO_INT16(&code[pc + 1]));
+        ((MjvmFieldData32 *)constField.staticFieldData)->value = stackPopInt32();
+        pc += 3;
+        goto *opcodes[code[pc]];
+    }
+    op_putstatic_quick_64: {
+        MjvmConstField &constField = method->classLoader.getConstField(ARRAY_TO_INT16(&code[pc + 1]));
+        ((MjvmFieldData64 *)constField.staticFieldData)->value = stackPopInt64();
+        pc += 3;
+        goto *opcodes[code[pc]];
+    }
+    op_putstatic_quick_obj: {
+        MjvmConstField &constField = method->classLoader.getConstField(ARRAY_TO_INT16(&code[pc + 1]));
+        ((MjvmFieldObject *)constField.staticFieldData)->object = stackPopObject();
+        pc += 3;
+        goto *opcodes[code[pc]];
+    }
+    op_invokestatic_quick: {
+        MjvmConstMethod &constMethod = method->classLoader.getConstMethod(ARRAY_TO_INT16(&code[pc + 1]));
+        lr = pc + 3;
+        try {
+            if(!invokeStatic(*constMethod.methodInfo, constMethod.getParmInfo().argc))
+                goto exception_handler;
+        }
+        catch(MjvmLoadFileError *file) {
+            fileNotFound = file;
+            goto file_not_found_excp;
+        }
+        goto *opcodes[code[pc]];
+    }
+    op_new_quick: {
+        uint16_t poolIndex = ARRAY_TO_INT16(&code[pc + 1]);
+        ClassData &classData = *(ClassData *)&method->classLoader.getConstClassLoader(mjvm, poolIndex);
+        MjvmObject *obj = mjvm.newObject(sizeof(MjvmFieldsData), method->classLoader.getConstUtf8Class(poolIndex));
+        try {
+            new ((MjvmFieldsData *)obj->data)MjvmFieldsData(mjvm, classData, false);
+        }
+        catch(MjvmLoadFileError *file) {
+            fileNotFound = file;
+            goto file_not_found_excp;
+        }
+        stackPushObject(obj);
+        pc += 3;
+        goto *opcodes[code[pc]];
+    }
     op_unknow:
         throw "unknow opcode";
     init_static_field: {
-        ClassData &classDataToInit = *(ClassData *)stackPopInt32();
+        MjvmConstUtf8 &superClass = classDataToInit->getSuperClass();
+        ClassData *superData = 0;
+        if((int32_t)&superClass != 0) {
+            try {
+                superData = (ClassData *)&mjvm.load(superClass);
+            }
+            catch(MjvmLoadFileError *file) {
+                if(isInitClaimed) {
+                    isInitClaimed = false;
+                    mjvm.finishClassInit(*classDataToInit, false);
+                }
+                fileNotFound = file;
+                goto file_not_found_excp;
+            }
+            catch(MjvmOutOfMemoryError *err) {
+                if(isInitClaimed) {
+                    isInitClaimed = false;
+                    mjvm.finishClassInit(*classDataToInit, false);
+                }
+                throw err;
+            }
+        }
+        MjvmMethodInfo &ctorMethod = classDataToInit->getStaticConstructor();
         Mjvm::lock();
-        if(classDataToInit.staticFiledsData) {
+        /* a class claimed together with its subclass is already owned by this execution */
+        if(!isInitClaimed) {
+            switch(classDataToInit->initState) {
+                case CLASS_INITIALIZED:
+                    Mjvm::unlock();
+                    goto *opcodes[code[pc]];
+                case CLASS_INIT_FAILED:
+                    Mjvm::unlock();
+                    goto no_class_def_found_err;
+                case CLASS_INITIALIZING:
+                    Mjvm::unlock();
+                    if(classDataToInit->initOwnId == (uint32_t)this)
+                        goto *opcodes[code[pc]];
+                    /* another execution is initializing the class, wait for it without holding any lock */
+                    mjvm.waitClassInit(*classDataToInit);
+                    if(opcodes == opcodeLabelsExit)
+                        goto op_exit;
+                    goto init_static_field;
+                default:
+                    break;
+            }
+        }
+        MjvmClassInitState superState = CLASS_INITIALIZED;
+        if(superData && !isClassReady(*superData, this))
+            superState = superData->initState;
+        if(superState == CLASS_INITIALIZING || superState == CLASS_INIT_FAILED) {
             Mjvm::unlock();
-            goto *opcodes[code[pc]];
+            if(superState == CLASS_INITIALIZING) {
+                /* the superclass is initialized by another execution, this class is initialized after it */
+                mjvm.waitClassInit(*superData);
+                if(opcodes != opcodeLabelsExit)
+                    goto init_static_field;
+            }
+            if(isInitClaimed) {
+                isInitClaimed = false;
+                mjvm.finishClassInit(*classDataToInit, false);
+            }
+            if(opcodes == opcodeLabelsExit)
+                goto op_exit;
+            goto no_class_def_found_err;
+        }
+        isInitClaimed = false;
+        classDataToInit->initState = CLASS_INITIALIZING;
+        classDataToInit->initOwnId = (uint32_t)this;
+        ClassData *superToInit = 0;
+        if(superState == CLASS_UNINITIALIZED) {
+            /* the superclass is claimed in the same locked section so no other execution can take it in between */
+            superToInit = superData;
+            superToInit->initState = CLASS_INITIALIZING;
+            superToInit->initOwnId = (uint32_t)this;
+            /* without a static constructor, this class is finished by the superclass once it is initialized */
+            if((int32_t)&ctorMethod == 0)
+                superToInit->initSubclass = classDataToInit;
+        }
+        Mjvm::unlock();
+        try {
+            if(classDataToInit->staticFiledsData == 0)
+                mjvm.initStaticField(*classDataToInit);
+        }
+        catch(MjvmOutOfMemoryError *err) {
+            if(superToInit)
+                mjvm.cancelClassInit(*superToInit);
+            mjvm.finishClassInit(*classDataToInit, false);
+            throw err;
+        }
+        if((int32_t)&ctorMethod != 0) {
+            lr = pc;
+            try {
+                invoke(ctorMethod, 0);
+            }
+            catch(const char *msg) {
+                if(superToInit)
+                    mjvm.cancelClassInit(*superToInit);
+                mjvm.finishClassInit(*classDataToInit, false);
+                throw msg;
+            }
+            classDataToInit->initSp = startSp;
+        }
+        else if(superToInit == 0)
+            mjvm.finishClassInit(*classDataToInit, true);
+        if(superToInit) {
+            /* the frame of the super class is pushed last so its static constructor runs first */
+            classDataToInit = superToInit;
+            isInitClaimed = true;
+            goto init_static_field;
         }
-        classDataToInit.isInitializing = 1;
-        mjvm.initStaticField(classDataToInit);
-        MjvmMethodInfo &ctorMethod = classDataToInit.getStaticConstructor();
-        lr = pc;
-        invoke(ctorMethod, 0);
         goto *opcodes[code[pc]];
     }
     divided_by_zero_excp: {
@@ -2284,6 +2723,20 @@ void MjvmExecution::run(void) {
         }
         goto exception_handler;
     }
+    no_class_def_found_err: {
+        MjvmConstUtf8 &className = classDataToInit->getThisClass();
+        const char *msg[] = {"Could not initialize class ", className.text};
+        MjvmString *strObj = mjvm.newString(msg, LENGTH(msg));
+        try {
+            MjvmThrowable *excpObj = mjvm.newNoClassDefFoundError(strObj);
+            stackPushObject(excpObj);
+        }
+        catch(MjvmLoadFileError *file) {
+            fileNotFound = file;
+            goto file_not_found_excp;
+        }
+        goto exception_handler;
+    }
     file_not_found_excp: {
         const char *msg[] = {"Could not find or load class ", fileNotFound->getFileName(), ".class"};
         MjvmString *strObj = mjvm.newString(msg, LENGTH(msg));
@@ -2295,9 +2748,9 @@ void MjvmExecution::run(void) {
         return;
 }
 
-void MjvmExecution::runTask(MjvmExecution *execution) {
+void MjvmExecution::execute(MjvmObject *thisObj) {
     try {
-        execution->run();
+        run(thisObj);
     }
     catch(MjvmThrowable *ex) {
         MjvmString &str = ex->getDetailMessage();
@@ -2322,17 +2775,57 @@ void MjvmExecution::runTask(MjvmExecution *execution) {
         MjvmSystem_Write(msg, strlen(msg), 0);
         MjvmSystem_Write("\n", 1, 0);
     }
-    while(execution->startSp > 3)
-        execution->stackRestoreContext();
-    execution->peakSp = -1;
-    execution->opcodes = 0;
+    while(startSp > 3)
+        stackRestoreContext();
+    sp = -1;
+    startSp = -1;
+    peakSp = -1;
+    concatSp = -1;
+    opcodes = 0;
+}
+
+/*
+ * The execution can be released as soon as the completion is given or isFinished is seen under the lock.
+ * Both are done in the same locked section and this thread does not touch the execution after it.
+ */
+void MjvmExecution::runTask(MjvmExecution *execution) {
+    execution->execute(0);
+    Mjvm::lock();
+    execution->isFinished = true;
+    bool isRelease = execution->isReleaseRequested;
+    MjvmSystem_SemaphoreGive(execution->completion);
+    if(isRelease)
+        execution->mjvm.releaseExecutionLocked(*execution);
+    Mjvm::unlock();
 }
 
 bool MjvmExecution::run(MjvmMethodInfo &method) {
+    Mjvm::lock();
+    if(opcodes || !isFinished) {
+        Mjvm::unlock();
+        return false;
+    }
     this->method = &method;
-    if(!opcodes)
-        return (MjvmSystem_ThreadCreate((void (*)(void *))runTask, (void *)this) != 0);
-    return false;
+    isFinished = false;
+    Mjvm::unlock();
+    /* the signal is there unless a joiner holds it for a moment, so this does not block for long */
+    MjvmSystem_SemaphoreTake(completion, MJVM_WAIT_FOREVER);
+    if(MjvmSystem_ThreadCreate((void (*)(void *))runTask, (void *)this) == 0) {
+        Mjvm::lock();
+        isFinished = true;
+        MjvmSystem_SemaphoreGive(completion);
+        Mjvm::unlock();
+        return false;
+    }
+    return true;
+}
+
+bool MjvmExecution::join(uint32_t timeoutMs) {
+    if(!MjvmSystem_SemaphoreTake(completion, timeoutMs))
+        return false;
+    /* give the signal back so that other joiners are released too */
+    MjvmSystem_SemaphoreGive(completion);
+    return true;
 }
 
 bool MjvmExecution::isRunning(void) const {
@@ -2346,4 +2839,5 @@ void MjvmExecution::terminateRequest(void) {
 MjvmExecution::~MjvmExecution(void) {
     Mjvm::free(stack);
     Mjvm::free(stackType);
+    MjvmSystem_SemaphoreDelete(completion);
 }
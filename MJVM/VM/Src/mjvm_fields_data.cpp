@@ -2,6 +2,7 @@
 #include <iostream>
 #include "mjvm.h"
 #include "mjvm_fields_data.h"
+#include "mjvm_system_api.h"
 
 MjvmFieldData32::MjvmFieldData32(const MjvmFieldInfo &fieldInfo) : fieldInfo(fieldInfo), value(0) {
 
@@ -15,6 +16,12 @@ MjvmFieldObject::MjvmFieldObject(const MjvmFieldInfo &fieldInfo) : fieldInfo(fie
 
 }
 
+MjvmFieldsData::MjvmFieldsData(void) : fields32Count(0), fields64Count(0), fieldsObjCount(0) {
+    fieldsData32 = 0;
+    fieldsData64 = 0;
+    fieldsObject = 0;
+}
+
 MjvmFieldsData::MjvmFieldsData(Mjvm &mjvm, const MjvmClassLoader &classLoader, bool isStatic) :
 fields32Count(0), fields64Count(0), fieldsObjCount(0) {
     if(isStatic)
@@ -155,6 +162,16 @@ MjvmFieldData32 &MjvmFieldsData::getFieldData32(const MjvmConstNameAndType &fiel
     return *(MjvmFieldData32 *)0;
 }
 
+MjvmFieldData32 &MjvmFieldsData::getFieldData32(const MjvmFieldInfo &fieldInfo) const {
+    if(fields32Count) {
+        for(uint16_t i = 0; i < fields32Count; i++) {
+            if(&fieldsData32[i].fieldInfo == &fieldInfo)
+                return fieldsData32[i];
+        }
+    }
+    return *(MjvmFieldData32 *)0;
+}
+
 MjvmFieldData64 &MjvmFieldsData::getFieldData64(const MjvmConstUtf8 &fieldName) const {
     if(fields64Count) {
         for(uint16_t i = 0; i < fields64Count; i++) {
@@ -177,6 +194,16 @@ MjvmFieldData64 &MjvmFieldsData::getFieldData64(const MjvmConstNameAndType &fiel
     return *(MjvmFieldData64 *)0;
 }
 
+MjvmFieldData64 &MjvmFieldsData::getFieldData64(const MjvmFieldInfo &fieldInfo) const {
+    if(fields64Count) {
+        for(uint16_t i = 0; i < fields64Count; i++) {
+            if(&fieldsData64[i].fieldInfo == &fieldInfo)
+                return fieldsData64[i];
+        }
+    }
+    return *(MjvmFieldData64 *)0;
+}
+
 MjvmFieldObject &MjvmFieldsData::getFieldObject(const MjvmConstUtf8 &fieldName) const {
     if(fieldsObjCount) {
         for(uint16_t i = 0; i < fieldsObjCount; i++) {
@@ -199,6 +226,16 @@ MjvmFieldObject &MjvmFieldsData::getFieldObject(const MjvmConstNameAndType &fiel
     return *(MjvmFieldObject *)0;
 }
 
+MjvmFieldObject &MjvmFieldsData::getFieldObject(const MjvmFieldInfo &fieldInfo) const {
+    if(fieldsObjCount) {
+        for(uint16_t i = 0; i < fieldsObjCount; i++) {
+            if(&fieldsObject[i].fieldInfo == &fieldInfo)
+                return fieldsObject[i];
+        }
+    }
+    return *(MjvmFieldObject *)0;
+}
+
 MjvmFieldsData::~MjvmFieldsData(void) {
     if(fieldsData32)
         Mjvm::free(fieldsData32);
@@ -209,32 +246,96 @@ MjvmFieldsData::~MjvmFieldsData(void) {
 }
 
 ClassData::~ClassData() {
+    if(initSemaphore)
+        MjvmSystem_SemaphoreDelete(initSemaphore);
     if(staticFiledsData) {
         staticFiledsData->~MjvmFieldsData();
         Mjvm::free(staticFiledsData);
     }
 }
 
+uint32_t ClassData::getMemoryUsage(void) const {
+    uint32_t size = sizeof(ClassData) + MjvmClassLoader::getMemoryUsage();
+    if(staticFiledsData) {
+        size += sizeof(MjvmFieldsData);
+        size += staticFiledsData->fields32Count * sizeof(MjvmFieldData32);
+        size += staticFiledsData->fields64Count * sizeof(MjvmFieldData64);
+        size += staticFiledsData->fieldsObjCount * sizeof(MjvmFieldObject);
+    }
+    return size;
+}
+
 ClassData::ClassData( const char *fileName) : MjvmClassLoader(fileName) {
     ownId = 0;
     monitorCount = 0;
-    isInitializing = 0;
+    initState = CLASS_UNINITIALIZED;
+    initWaitCount = 0;
+    initOwnId = 0;
+    initSp = -1;
+    initSubclass = 0;
+    initSemaphore = 0;
     staticFiledsData = 0;
     next = 0;
+    nextMarked = 0;
+    isMarked = false;
 }
 
 ClassData::ClassData(const char *fileName, uint16_t length) : MjvmClassLoader(fileName, length) {
     ownId = 0;
     monitorCount = 0;
-    isInitializing = 0;
+    initState = CLASS_UNINITIALIZED;
+    initWaitCount = 0;
+    initOwnId = 0;
+    initSp = -1;
+    initSubclass = 0;
+    initSemaphore = 0;
     staticFiledsData = 0;
     next = 0;
+    nextMarked = 0;
+    isMarked = false;
 }
 
 ClassData::ClassData(const MjvmConstUtf8 &fileName) : MjvmClassLoader(fileName) {
     ownId = 0;
     monitorCount = 0;
-    isInitializing = 0;
+    initState = CLASS_UNINITIALIZED;
+    initWaitCount = 0;
+    initOwnId = 0;
+    initSp = -1;
+    initSubclass = 0;
+    initSemaphore = 0;
+    staticFiledsData = 0;
+    next = 0;
+    nextMarked = 0;
+    isMarked = false;
+}
+
+ClassData::ClassData(const MjvmClassArchive &archive, const MjvmArchiveClass &archiveClass) : MjvmClassLoader(archive, archiveClass) {
+    ownId = 0;
+    monitorCount = 0;
+    initState = CLASS_UNINITIALIZED;
+    initWaitCount = 0;
+    initOwnId = 0;
+    initSp = -1;
+    initSubclass = 0;
+    initSemaphore = 0;
+    staticFiledsData = 0;
+    next = 0;
+    nextMarked = 0;
+    isMarked = false;
+}
+
+ClassData::ClassData(const MjvmClassBundle &bundle, const MjvmBundleEntry &entry) : MjvmClassLoader(bundle, entry) {
+    ownId = 0;
+    monitorCount = 0;
+    initState = CLASS_UNINITIALIZED;
+    initWaitCount = 0;
+    initOwnId = 0;
+    initSp = -1;
+    initSubclass = 0;
+    initSemaphore = 0;
     staticFiledsData = 0;
     next = 0;
+    nextMarked = 0;
+    isMarked = false;
 }
@@ -0,0 +1,152 @@
+
+#include <new>
+#include <string.h>
+#include "mjvm.h"
+#include "mjvm_lambda.h"
+#include "mjvm_const_name.h"
+
+static const MjvmConstUtf8 &metafactoryName = *(const MjvmConstUtf8 *)"\x0B\x00\x9F\x04""metafactory";
+static const MjvmConstUtf8 &altMetafactoryName = *(const MjvmConstUtf8 *)"\x0E\x00\xC0\x05""altMetafactory";
+
+/*
+ * Write the type of every argument followed by the return type and return the argument count.
+ * The types that take the same stack slot are merged, 'L' for the references and 'I' for the small integers.
+ */
+static uint16_t parseDescriptor(const char *descriptor, char *types) {
+    uint16_t count = 0;
+    descriptor++;
+    while(1) {
+        bool isReturn = (*descriptor == ')');
+        if(isReturn)
+            descriptor++;
+        switch(*descriptor) {
+            case 'L':
+            case '[':
+                types[count] = 'L';
+                break;
+            case 'Z':
+            case 'B':
+            case 'C':
+            case 'S':
+                types[count] = 'I';
+                break;
+            default:
+                types[count] = *descriptor;
+                break;
+        }
+        if(isReturn)
+            return count;
+        while(*descriptor == '[')
+            descriptor++;
+        if(*descriptor == 'L') {
+            while(*descriptor != ';')
+                descriptor++;
+        }
+        descriptor++;
+        count++;
+    }
+}
+
+static uint8_t getArgSlots(const char *types, uint16_t count) {
+    uint16_t slots = 0;
+    for(uint16_t i = 0; i < count; i++)
+        slots += (types[i] == 'J' || types[i] == 'D') ? 2 : 1;
+    return slots;
+}
+
+MjvmLambda::MjvmLambda(MjvmClassLoader &classLoader, MjvmConstUtf8 &interfaceName, MjvmConstUtf8 &methodName, MjvmConstMethodHandle &methodHandle, uint8_t capturedArgc, uint8_t methodArgc, bool isVoidMethod) :
+classLoader(classLoader), interfaceName(interfaceName), methodName(methodName), methodHandle(methodHandle), capturedArgc(capturedArgc), methodArgc(methodArgc), isVoidMethod(isVoidMethod) {
+    implMethod = 0;
+}
+
+bool MjvmLambda::isObjectArg(uint8_t index) const {
+    return objectArgs[index];
+}
+
+MjvmObject *MjvmLambda::newObject(Mjvm &mjvm, const int32_t *args) {
+    MjvmObject *obj = mjvm.newObject(sizeof(MjvmFieldsData) + sizeof(MjvmLambda *) + capturedArgc * sizeof(int32_t), interfaceName);
+    new ((MjvmFieldsData *)obj->data)MjvmFieldsData();
+    *(MjvmLambda **)&obj->data[sizeof(MjvmFieldsData)] = this;
+    memcpy(&obj->data[sizeof(MjvmFieldsData) + sizeof(MjvmLambda *)], args, capturedArgc * sizeof(int32_t));
+    return obj;
+}
+
+MjvmLambda *MjvmLambda::getLambda(MjvmObject *obj) {
+    /* the other objects have nothing after their fields */
+    if(obj->dimensions || obj->size <= sizeof(MjvmFieldsData))
+        return 0;
+    return *(MjvmLambda **)&obj->data[sizeof(MjvmFieldsData)];
+}
+
+const int32_t *MjvmLambda::getArgs(MjvmObject *obj) {
+    return (const int32_t *)&obj->data[sizeof(MjvmFieldsData) + sizeof(MjvmLambda *)];
+}
+
+MjvmLambda *MjvmLambda::link(Mjvm &mjvm, MjvmClassLoader &classLoader, MjvmConstInvokeDynamic &constInvokeDynamic) {
+    MjvmBootstrapMethod &bootstrapMethod = classLoader.getBootstrapMethod(constInvokeDynamic.bootstrapMethodAttrIndex);
+    MjvmConstMethodHandle &bootstrapHandle = classLoader.getConstMethodHandle(bootstrapMethod.bootstrapMethodRef);
+    if(bootstrapHandle.referenceKind != REF_INVOKE_STATIC || bootstrapHandle.className != lambdaMetafactoryClassName)
+        return 0;
+    if(bootstrapHandle.nameAndType.name != metafactoryName && bootstrapHandle.nameAndType.name != altMetafactoryName)
+        return 0;
+    if(bootstrapMethod.numBootstrapArguments < 3)
+        throw "the bootstrap arguments of lambda are invalid";
+
+    /* the call site captures the first arguments of the implementation, the interface method passes the other ones */
+    char capturedTypes[256];
+    char methodTypes[256];
+    char implTypes[257];
+    MjvmConstUtf8 &descriptor = constInvokeDynamic.nameAndType.descriptor;
+    MjvmConstUtf8 &methodType = classLoader.getConstMethodType(bootstrapMethod.getBootstrapArgument(0));
+    MjvmConstMethodHandle &methodHandle = classLoader.getConstMethodHandle(bootstrapMethod.getBootstrapArgument(1));
+    MjvmReferenceKind referenceKind = methodHandle.referenceKind;
+    if(referenceKind < REF_INVOKE_VIRTUAL)
+        return 0;
+    uint16_t capturedCount = parseDescriptor(descriptor.text, capturedTypes);
+    uint16_t methodCount = parseDescriptor(methodType.text, methodTypes);
+    uint16_t implCount = 0;
+    if(referenceKind != REF_INVOKE_STATIC && referenceKind != REF_NEW_INVOKE_SPECIAL)
+        implTypes[implCount++] = 'L';
+    implCount += parseDescriptor(methodHandle.nameAndType.descriptor.text, &implTypes[implCount]);
+    /* a constructor gives the new object, or nothing when the interface method returns void */
+    bool isVoidMethod = (methodTypes[methodCount] == 'V');
+    if(referenceKind == REF_NEW_INVOKE_SPECIAL)
+        implTypes[implCount] = isVoidMethod ? 'V' : 'L';
+
+    /* the arguments are passed on the stack as they are, boxing or dropping the result of a method is not supported */
+    const char *interfaceText = strchr(descriptor.text, ')') + 1;
+    if(implCount != (capturedCount + methodCount) || *interfaceText != 'L')
+        return 0;
+    if(memcmp(capturedTypes, implTypes, capturedCount) != 0)
+        return 0;
+    if(memcmp(methodTypes, &implTypes[capturedCount], methodCount + 1) != 0)
+        return 0;
+
+    MjvmConstUtf8 &interfaceName = mjvm.load(&interfaceText[1], strlen(interfaceText) - 2).getThisClass();
+    MjvmMethodInfo *implMethod = 0;
+    if(referenceKind != REF_INVOKE_INTERFACE) {
+        MjvmConstMethod constMethod(methodHandle.className, methodHandle.nameAndType, 0, 0);
+        implMethod = &mjvm.findMethod(constMethod);
+        /* a private method is never overridden, the other virtual ones are looked up from the receiver on each call */
+        if(referenceKind == REF_INVOKE_VIRTUAL && (implMethod->accessFlag & METHOD_PRIVATE) != METHOD_PRIVATE)
+            implMethod = 0;
+    }
+
+    /* the interface name is copied after the argument types, the class of the interface may be unloaded before the call site */
+    uint8_t capturedArgc = getArgSlots(capturedTypes, capturedCount);
+    uint32_t nameOffset = (sizeof(MjvmLambda) + capturedArgc + 3) & ~0x03;
+    uint32_t nameSize = sizeof(MjvmConstUtf8) + interfaceName.length + 1;
+    MjvmLambda *lambda = (MjvmLambda *)Mjvm::malloc(nameOffset + nameSize);
+    uint8_t *nameBuff = (uint8_t *)lambda + nameOffset;
+    memcpy(nameBuff, &interfaceName, nameSize);
+    MjvmConstUtf8 *name = (MjvmConstUtf8 *)nameBuff;
+    new (lambda)MjvmLambda(classLoader, *name, constInvokeDynamic.nameAndType.name, methodHandle, capturedArgc, getArgSlots(methodTypes, methodCount), isVoidMethod);
+    lambda->implMethod = implMethod;
+    uint8_t slot = 0;
+    for(uint16_t i = 0; i < capturedCount; i++) {
+        if(capturedTypes[i] == 'J' || capturedTypes[i] == 'D')
+            lambda->objectArgs[slot++] = 0;
+        lambda->objectArgs[slot++] = (capturedTypes[i] == 'L');
+    }
+    return lambda;
+}
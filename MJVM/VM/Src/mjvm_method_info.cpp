@@ -5,25 +5,23 @@
 #include "mjvm_native_class.h"
 
 static MjvmNativeMethodPtr findNativeMathod(const MjvmMethodInfo &methodInfo) {
-    MjvmConstUtf8 &className = methodInfo.classLoader.getThisClass();
-    for(uint32_t i = 0; i < NATIVE_CLASS_COUNT; i++) {
-        if(NATIVE_CLASS_LIST[i]->className == className) {
-            for(uint32_t k = 0; k < NATIVE_CLASS_LIST[i]->methodCount; k++) {
-                if(
-                    NATIVE_CLASS_LIST[i]->methods[k].name == methodInfo.name &&
-                    NATIVE_CLASS_LIST[i]->methods[k].descriptor == methodInfo.descriptor
-                ) {
-                    return NATIVE_CLASS_LIST[i]->methods[k].nativeMathod;
-                }
-            }
-            break;
-        }
+    Mjvm::lock();
+    MjvmNativeMethodPtr nativeMethod;
+    try {
+        nativeMethod = NativeMethodTable::findMethod(methodInfo.classLoader.getThisClass(), methodInfo.name, methodInfo.descriptor);
+    }
+    catch(MjvmOutOfMemoryError *err) {
+        Mjvm::unlock();
+        throw err;
     }
-    throw "can't find the native method";
+    Mjvm::unlock();
+    if(nativeMethod == 0)
+        throw "can't find the native method";
+    return nativeMethod;
 }
 
 MjvmMethodInfo::MjvmMethodInfo(MjvmClassLoader &classLoader, MjvmMethodAccessFlag accessFlag, MjvmConstUtf8 &name, MjvmConstUtf8 &descriptor) :
-accessFlag(accessFlag), classLoader(classLoader), name(name), descriptor(descriptor), attributes(0) {
+accessFlag(accessFlag), classLoader(classLoader), name(name), descriptor(descriptor), attributes(0), codeOffset(0) {
 
 }
 
@@ -33,7 +31,9 @@ void MjvmMethodInfo::addAttribute(MjvmAttribute *attribute) {
 }
 
 MjvmAttribute &MjvmMethodInfo::getAttribute(MjvmAttributeType type) const {
-    for(MjvmAttribute *node = attributes; node != 0;) {
+    if(type == ATTRIBUTE_CODE)
+        return getAttributeCode();
+    for(MjvmAttribute *node = attributes; node != 0; node = node->next) {
         if(node->attributeType == type) {
             if(type != ATTRIBUTE_NATIVE)
                 return *node;
@@ -49,15 +49,17 @@ MjvmAttribute &MjvmMethodInfo::getAttribute(MjvmAttributeType type) const {
 }
 
 MjvmCodeAttribute &MjvmMethodInfo::getAttributeCode(void) const {
-    for(MjvmAttribute *node = attributes; node != 0;) {
+    for(MjvmAttribute *node = attributes; node != 0; node = node->next) {
         if(node->attributeType == ATTRIBUTE_CODE)
             return *(MjvmCodeAttribute *)node;
     }
+    if(codeOffset)
+        return classLoader.loadCode(*(MjvmMethodInfo *)this);
     throw "can't find the code attribute";
 }
 
 MjvmNativeAttribute &MjvmMethodInfo::getAttributeNative(void) const {
-    for(MjvmAttribute *node = attributes; node != 0;) {
+    for(MjvmAttribute *node = attributes; node != 0; node = node->next) {
         if(node->attributeType == ATTRIBUTE_NATIVE) {
             MjvmNativeAttribute *attrNative = (MjvmNativeAttribute *)node;
             if(attrNative->nativeMethod == 0)
@@ -0,0 +1,456 @@
+
+#include <new>
+#include <string.h>
+#include "mjvm.h"
+#include "mjvm_system_api.h"
+#include "mjvm_lambda.h"
+#include "mjvm_snapshot.h"
+
+MjvmSnapshot::MjvmSnapshot(Mjvm &mjvm) : mjvm(mjvm) {
+    memset((void *)&utf8Table, 0, sizeof(utf8Table));
+    memset((void *)&classTable, 0, sizeof(classTable));
+    memset((void *)&objectTable, 0, sizeof(objectTable));
+    memset((void *)&utf8Map, 0, sizeof(utf8Map));
+    memset((void *)&objectMap, 0, sizeof(objectMap));
+    classCount = 0;
+    image = 0;
+    imageSize = 0;
+    isImageMapped = false;
+    objects = 0;
+    objectFlags = 0;
+    objectCount = 0;
+    objectCapacity = 0;
+}
+
+void MjvmSnapshot::append(MjvmSnapshotBuffer &buff, const void *data, uint32_t size) {
+    uint32_t alignedSize = (size + 3) & ~0x03;
+    if((buff.size + alignedSize) > buff.capacity) {
+        uint32_t capacity = buff.capacity ? buff.capacity : 256;
+        while(capacity < (buff.size + alignedSize))
+            capacity <<= 1;
+        buff.data = (uint8_t *)Mjvm::realloc(buff.data, capacity);
+        buff.capacity = capacity;
+    }
+    memcpy(&buff.data[buff.size], data, size);
+    memset(&buff.data[buff.size + size], 0, alignedSize - size);
+    buff.size += alignedSize;
+}
+
+uint32_t *MjvmSnapshot::findValue(const MjvmSnapshotMap &map, const void *key) {
+    if(map.capacity == 0)
+        return 0;
+    uint32_t mask = map.capacity - 1;
+    for(uint32_t index = (((uint32_t)key >> 2) * 0x9E3779B1) & mask;; index = (index + 1) & mask) {
+        if(map.keys[index] == key)
+            return &map.values[index];
+        else if(map.keys[index] == 0)
+            return 0;
+    }
+}
+
+void MjvmSnapshot::putValue(MjvmSnapshotMap &map, const void *key, uint32_t value) {
+    if(((map.count + 1) * 4) > (map.capacity * 3)) {
+        MjvmSnapshotMap newMap;
+        newMap.count = map.count;
+        newMap.capacity = map.capacity ? (map.capacity << 1) : 64;
+        newMap.keys = (const void **)Mjvm::malloc(newMap.capacity * sizeof(void *));
+        try {
+            newMap.values = (uint32_t *)Mjvm::malloc(newMap.capacity * sizeof(uint32_t));
+        }
+        catch(MjvmOutOfMemoryError *err) {
+            Mjvm::free(newMap.keys);
+            throw err;
+        }
+        memset(newMap.keys, 0, newMap.capacity * sizeof(void *));
+        uint32_t mask = newMap.capacity - 1;
+        for(uint32_t i = 0; i < map.capacity; i++) {
+            if(map.keys[i] == 0)
+                continue;
+            uint32_t index = (((uint32_t)map.keys[i] >> 2) * 0x9E3779B1) & mask;
+            while(newMap.keys[index])
+                index = (index + 1) & mask;
+            newMap.keys[index] = map.keys[i];
+            newMap.values[index] = map.values[i];
+        }
+        if(map.capacity) {
+            Mjvm::free(map.keys);
+            Mjvm::free(map.values);
+        }
+        map = newMap;
+    }
+    uint32_t mask = map.capacity - 1;
+    uint32_t index = (((uint32_t)key >> 2) * 0x9E3779B1) & mask;
+    while(map.keys[index])
+        index = (index + 1) & mask;
+    map.keys[index] = key;
+    map.values[index] = value;
+    map.count++;
+}
+
+uint32_t MjvmSnapshot::addUtf8(const MjvmConstUtf8 &utf8) {
+    uint32_t *value = findValue(utf8Map, &utf8);
+    if(value)
+        return *value;
+    uint32_t offset = utf8Table.size;
+    append(utf8Table, &utf8, sizeof(MjvmConstUtf8) + utf8.length + 1);
+    putValue(utf8Map, &utf8, offset);
+    return offset;
+}
+
+uint32_t MjvmSnapshot::addObject(MjvmObject *obj) {
+    if(obj == 0)
+        return 0;
+    uint32_t *value = findValue(objectMap, obj);
+    if(value)
+        return *value;
+    if(objectCount == objectCapacity) {
+        uint32_t capacity = objectCapacity ? (objectCapacity << 1) : 64;
+        objects = (MjvmObject **)Mjvm::realloc(objects, capacity * sizeof(MjvmObject *));
+        objectFlags = (uint8_t *)Mjvm::realloc(objectFlags, capacity);
+        objectCapacity = capacity;
+    }
+    objects[objectCount] = obj;
+    objectFlags[objectCount] = 0;
+    objectCount++;
+    putValue(objectMap, obj, objectCount);
+    return objectCount;
+}
+
+void MjvmSnapshot::writeField(MjvmSnapshotBuffer &buff, const MjvmFieldInfo &fieldInfo, const void *value, uint8_t size) {
+    MjvmSnapshotField field;
+    field.owner = addUtf8(fieldInfo.classLoader.getThisClass());
+    field.name = addUtf8(fieldInfo.name);
+    field.descriptor = addUtf8(fieldInfo.descriptor);
+    append(buff, &field, sizeof(field));
+    append(buff, value, size);
+}
+
+void MjvmSnapshot::writeFields(MjvmSnapshotBuffer &buff, const MjvmFieldsData &fields) {
+    for(uint16_t i = 0; i < fields.fields32Count; i++)
+        writeField(buff, fields.fieldsData32[i].fieldInfo, &fields.fieldsData32[i].value, sizeof(int32_t));
+    for(uint16_t i = 0; i < fields.fields64Count; i++)
+        writeField(buff, fields.fieldsData64[i].fieldInfo, &fields.fieldsData64[i].value, sizeof(int64_t));
+    for(uint16_t i = 0; i < fields.fieldsObjCount; i++) {
+        uint32_t index = addObject(fields.fieldsObject[i].object);
+        writeField(buff, fields.fieldsObject[i].fieldInfo, &index, sizeof(uint32_t));
+    }
+}
+
+void MjvmSnapshot::writeObject(MjvmObject *obj, uint8_t flags) {
+    /* the call site of a lambda is not part of the image, it could not be restored */
+    if(MjvmLambda::getLambda(obj))
+        throw "lambda objects can not be saved in the heap snapshot";
+    MjvmSnapshotObject record;
+    record.type = addUtf8(obj->type);
+    record.dimensions = obj->dimensions;
+    record.flags = flags;
+    record.reserved = 0;
+    if(obj->dimensions == 0) {
+        MjvmFieldsData &fields = *(MjvmFieldsData *)obj->data;
+        record.size = fields.fields32Count + fields.fields64Count + fields.fieldsObjCount;
+        append(objectTable, &record, sizeof(record));
+        writeFields(objectTable, fields);
+    }
+    else if((obj->dimensions == 1) && MjvmObject::isPrimType(obj->type)) {
+        record.size = obj->size;
+        append(objectTable, &record, sizeof(record));
+        append(objectTable, obj->data, obj->size);
+    }
+    else {
+        uint32_t count = obj->size / 4;
+        record.size = count * sizeof(uint32_t);
+        append(objectTable, &record, sizeof(record));
+        for(uint32_t i = 0; i < count; i++) {
+            uint32_t index = addObject(((MjvmObject **)obj->data)[i]);
+            append(objectTable, &index, sizeof(uint32_t));
+        }
+    }
+}
+
+void MjvmSnapshot::save(const char *fileName) {
+    for(MjvmConstString *node = mjvm.constStringList; node != 0; node = node->next) {
+        uint32_t index = addObject(&node->mjvmString);
+        objectFlags[index - 1] |= SNAPSHOT_OBJECT_CONST_STRING;
+    }
+    for(MjvmConstClass *node = mjvm.constClassList; node != 0; node = node->next) {
+        uint32_t index = addObject(&node->mjvmClass);
+        objectFlags[index - 1] |= SNAPSHOT_OBJECT_CONST_CLASS;
+    }
+
+    /* classes that are not initialized yet will be loaded and initialized again after restoring */
+    for(ClassData *node = mjvm.classDataList; node != 0; node = node->next) {
+        if(node->initState != CLASS_INITIALIZED || node->staticFiledsData == 0)
+            continue;
+        MjvmFieldsData &fields = *node->staticFiledsData;
+        MjvmSnapshotClass record;
+        record.name = addUtf8(node->getThisClass());
+        record.fieldsCount = fields.fields32Count + fields.fields64Count + fields.fieldsObjCount;
+        append(classTable, &record, sizeof(record));
+        writeFields(classTable, fields);
+        classCount++;
+    }
+
+    /* objects found while writing an object are appended to the table and written by this loop as well */
+    for(uint32_t i = 0; i < objectCount; i++)
+        writeObject(objects[i], objectFlags[i]);
+
+    MjvmSnapshotHeader header;
+    header.magic = HEAP_SNAPSHOT_MAGIC;
+    header.version = HEAP_SNAPSHOT_VERSION;
+    header.reserved = 0;
+    header.utf8Offset = sizeof(MjvmSnapshotHeader);
+    header.utf8Size = utf8Table.size;
+    header.classCount = classCount;
+    header.classesOffset = header.utf8Offset + utf8Table.size;
+    header.objectCount = objectCount;
+    header.objectsOffset = header.classesOffset + classTable.size;
+    header.size = header.objectsOffset + objectTable.size;
+
+    void *file = MjvmSystem_FileOpen(fileName, (MjvmSys_FileMode)(MJVM_FILE_WRITE | MJVM_FILE_CREATE_ALWAYS));
+    if(file == 0)
+        throw "can not open file";
+    const void *buffs[] = {&header, utf8Table.data, classTable.data, objectTable.data};
+    const uint32_t sizes[] = {sizeof(MjvmSnapshotHeader), utf8Table.size, classTable.size, objectTable.size};
+    for(uint8_t i = 0; i < LENGTH(buffs); i++) {
+        if(sizes[i] == 0)
+            continue;
+        uint32_t temp;
+        MjvmSys_FileResult ret = MjvmSystem_FileWrite(file, (void *)buffs[i], sizes[i], &temp);
+        if((ret != FILE_RESULT_OK) || (temp != sizes[i])) {
+            MjvmSystem_FileClose(file);
+            throw "write file error";
+        }
+    }
+    MjvmSystem_FileClose(file);
+}
+
+const void *MjvmSnapshot::read(uint32_t &offset, uint32_t size) const {
+    if((offset + size) > imageSize || (offset + size) < offset)
+        throw "invalid heap snapshot";
+    const void *ret = &image[offset];
+    offset += (size + 3) & ~0x03;
+    return ret;
+}
+
+MjvmConstUtf8 &MjvmSnapshot::getUtf8(uint32_t offset) const {
+    const MjvmSnapshotHeader *header = (const MjvmSnapshotHeader *)image;
+    if((offset & 0x03) || (offset + sizeof(MjvmConstUtf8)) >= header->utf8Size)
+        throw "invalid heap snapshot";
+    MjvmConstUtf8 &utf8 = *(MjvmConstUtf8 *)&mjvm.snapshotUtf8[offset];
+    if((offset + sizeof(MjvmConstUtf8) + utf8.length) >= header->utf8Size)
+        throw "invalid heap snapshot";
+    return utf8;
+}
+
+MjvmObject *MjvmSnapshot::getObject(uint32_t index) const {
+    if(index == 0)
+        return 0;
+    else if(index > objectCount)
+        throw "invalid heap snapshot";
+    return objects[index - 1];
+}
+
+bool MjvmSnapshot::isSameField(const MjvmFieldInfo &fieldInfo, const MjvmSnapshotField &field) const {
+    return (
+        (fieldInfo.name == getUtf8(field.name)) &&
+        (fieldInfo.descriptor == getUtf8(field.descriptor)) &&
+        (fieldInfo.classLoader.getThisClass() == getUtf8(field.owner))
+    );
+}
+
+uint32_t MjvmSnapshot::readFields(uint32_t offset, uint32_t fieldsCount, MjvmFieldsData *fields) const {
+    for(uint32_t i = 0; i < fieldsCount; i++) {
+        const MjvmSnapshotField &field = *(const MjvmSnapshotField *)read(offset, sizeof(MjvmSnapshotField));
+        bool isFound = (fields == 0);
+        switch(getUtf8(field.descriptor).text[0]) {
+            case 'J':
+            case 'D': {
+                const void *value = read(offset, sizeof(int64_t));
+                for(uint16_t j = 0; !isFound && j < fields->fields64Count; j++) {
+                    if(isSameField(fields->fieldsData64[j].fieldInfo, field)) {
+                        memcpy(&fields->fieldsData64[j].value, value, sizeof(int64_t));
+                        isFound = true;
+                    }
+                }
+                break;
+            }
+            case 'L':
+            case '[': {
+                uint32_t index = *(const uint32_t *)read(offset, sizeof(uint32_t));
+                for(uint16_t j = 0; !isFound && j < fields->fieldsObjCount; j++) {
+                    if(isSameField(fields->fieldsObject[j].fieldInfo, field)) {
+                        fields->fieldsObject[j].object = getObject(index);
+                        isFound = true;
+                    }
+                }
+                break;
+            }
+            default: {
+                int32_t value = *(const int32_t *)read(offset, sizeof(int32_t));
+                for(uint16_t j = 0; !isFound && j < fields->fields32Count; j++) {
+                    if(isSameField(fields->fieldsData32[j].fieldInfo, field)) {
+                        fields->fieldsData32[j].value = value;
+                        isFound = true;
+                    }
+                }
+                break;
+            }
+        }
+        if(!isFound)
+            throw "heap snapshot does not match the class files";
+    }
+    return offset;
+}
+
+void MjvmSnapshot::loadImage(const char *fileName) {
+    void *file = MjvmSystem_FileOpen(fileName, MJVM_FILE_READ);
+    if(file == 0)
+        throw "can not open file";
+    image = (uint8_t *)MjvmSystem_FileMap(file, &imageSize);
+    isImageMapped = (image != 0);
+    if(!isImageMapped) {
+        try {
+            imageSize = MjvmSystem_FileSize(file);
+            image = (uint8_t *)Mjvm::malloc(imageSize);
+            uint32_t temp;
+            MjvmSys_FileResult ret = MjvmSystem_FileRead(file, image, imageSize, &temp);
+            if((ret != FILE_RESULT_OK) || (temp != imageSize))
+                throw "read file error";
+        }
+        catch(const char *excp) {
+            MjvmSystem_FileClose(file);
+            throw excp;
+        }
+        catch(MjvmOutOfMemoryError *err) {
+            MjvmSystem_FileClose(file);
+            throw err;
+        }
+    }
+    MjvmSystem_FileClose(file);
+
+    const MjvmSnapshotHeader *header = (const MjvmSnapshotHeader *)image;
+    if(
+        (imageSize < sizeof(MjvmSnapshotHeader)) ||
+        (header->magic != HEAP_SNAPSHOT_MAGIC) ||
+        (header->version != HEAP_SNAPSHOT_VERSION) ||
+        (header->size != imageSize) ||
+        ((header->utf8Offset | header->classesOffset | header->objectsOffset) & 0x03) ||
+        ((header->utf8Offset + header->utf8Size) > imageSize) ||
+        (header->classesOffset > imageSize) ||
+        (header->objectsOffset > imageSize)
+    ) {
+        throw "invalid heap snapshot";
+    }
+}
+
+void MjvmSnapshot::restore(const char *fileName) {
+    loadImage(fileName);
+    const MjvmSnapshotHeader *header = (const MjvmSnapshotHeader *)image;
+
+    /* restored objects keep referring to the names, so the utf8 table lives as long as the VM */
+    if(isImageMapped)
+        mjvm.snapshotUtf8 = &image[header->utf8Offset];
+    else {
+        mjvm.snapshotUtf8 = (uint8_t *)Mjvm::malloc(header->utf8Size);
+        memcpy(mjvm.snapshotUtf8, &image[header->utf8Offset], header->utf8Size);
+    }
+
+    objects = (MjvmObject **)Mjvm::malloc(header->objectCount * sizeof(MjvmObject *));
+    objectFlags = (uint8_t *)Mjvm::malloc(header->objectCount);
+    objectCapacity = header->objectCount;
+
+    /* create all objects first, they are protected from the garbage collector until the end of restoring */
+    uint32_t offset = header->objectsOffset;
+    for(uint32_t i = 0; i < header->objectCount; i++) {
+        const MjvmSnapshotObject *record = (const MjvmSnapshotObject *)read(offset, sizeof(MjvmSnapshotObject));
+        MjvmConstUtf8 &type = getUtf8(record->type);
+        MjvmObject *obj;
+        if(record->dimensions == 0) {
+            MjvmClassLoader &classLoader = mjvm.load(type);
+            obj = mjvm.newObject(sizeof(MjvmFieldsData), classLoader.getThisClass());
+            new ((MjvmFieldsData *)obj->data)MjvmFieldsData(mjvm, classLoader, false);
+            offset = readFields(offset, record->size, 0);
+        }
+        else {
+            obj = mjvm.newObject(record->size, type, record->dimensions);
+            const void *data = read(offset, record->size);
+            if((record->dimensions == 1) && MjvmObject::isPrimType(type))
+                memcpy(obj->data, data, record->size);
+            else
+                memset(obj->data, 0, record->size);
+        }
+        objects[i] = obj;
+        objectFlags[i] = record->flags;
+        objectCount++;
+    }
+
+    /* then link them together */
+    offset = header->objectsOffset;
+    for(uint32_t i = 0; i < objectCount; i++) {
+        const MjvmSnapshotObject *record = (const MjvmSnapshotObject *)read(offset, sizeof(MjvmSnapshotObject));
+        MjvmObject *obj = objects[i];
+        if(obj->dimensions == 0)
+            offset = readFields(offset, record->size, (MjvmFieldsData *)obj->data);
+        else {
+            const uint32_t *data = (const uint32_t *)read(offset, record->size);
+            if((obj->dimensions > 1) || !MjvmObject::isPrimType(obj->type)) {
+                uint32_t count = record->size / sizeof(uint32_t);
+                for(uint32_t j = 0; j < count; j++)
+                    ((MjvmObject **)obj->data)[j] = getObject(data[j]);
+            }
+        }
+    }
+
+    offset = header->classesOffset;
+    for(uint32_t i = 0; i < header->classCount; i++) {
+        const MjvmSnapshotClass *record = (const MjvmSnapshotClass *)read(offset, sizeof(MjvmSnapshotClass));
+        ClassData &classData = *(ClassData *)&mjvm.load(getUtf8(record->name));
+        if(classData.staticFiledsData == 0)
+            mjvm.initStaticField(classData);
+        offset = readFields(offset, record->fieldsCount, classData.staticFiledsData);
+    }
+
+    for(uint32_t i = 0; i < objectCount; i++) {
+        if(objectFlags[i] & SNAPSHOT_OBJECT_CONST_STRING)
+            mjvm.addConstString(*(MjvmString *)objects[i]);
+        if(objectFlags[i] & SNAPSHOT_OBJECT_CONST_CLASS)
+            mjvm.addConstClass(*(MjvmClass *)objects[i]);
+    }
+
+    /* mark the classes as initialized so that their <clinit> will not be run */
+    offset = header->classesOffset;
+    for(uint32_t i = 0; i < header->classCount; i++) {
+        const MjvmSnapshotClass *record = (const MjvmSnapshotClass *)read(offset, sizeof(MjvmSnapshotClass));
+        ClassData &classData = *(ClassData *)&mjvm.load(getUtf8(record->name));
+        classData.initState = CLASS_INITIALIZED;
+        offset = readFields(offset, record->fieldsCount, 0);
+    }
+}
+
+MjvmSnapshot::~MjvmSnapshot(void) {
+    if(utf8Table.data)
+        Mjvm::free(utf8Table.data);
+    if(classTable.data)
+        Mjvm::free(classTable.data);
+    if(objectTable.data)
+        Mjvm::free(objectTable.data);
+    if(utf8Map.capacity) {
+        Mjvm::free(utf8Map.keys);
+        Mjvm::free(utf8Map.values);
+    }
+    if(objectMap.capacity) {
+        Mjvm::free(objectMap.keys);
+        Mjvm::free(objectMap.values);
+    }
+    /* restored objects are released to the garbage collector, even if restoring failed */
+    if(image) {
+        for(uint32_t i = 0; i < objectCount; i++)
+            objects[i]->clearProtected();
+        if(!isImageMapped)
+            Mjvm::free(image);
+    }
+    if(objects)
+        Mjvm::free(objects);
+    if(objectFlags)
+        Mjvm::free(objectFlags);
+}
@@ -2,6 +2,7 @@
 #include "mjvm_string.h"
 #include "mjvm_const_name.h"
 #include "mjvm_fields_data.h"
+#include "mjvm_native_string_kernel.h"
 
 static const uint8_t utf8ByteCount[] = {
     2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
@@ -106,6 +107,31 @@ uint8_t MjvmString::getCoder(void) const {
     return ((MjvmFieldsData *)data)->getFieldData32(*(MjvmConstNameAndType *)stringCoderFieldName).value;
 }
 
+int32_t MjvmString::getHashCode(void) const {
+    /* the hash is cached in the hash field of the string object, 0 means it has not been calculated yet */
+    MjvmFieldsData *fields = (MjvmFieldsData *)data;
+    MjvmFieldData32 &hashField = fields->getFieldData32(*(MjvmConstNameAndType *)stringHashFieldName);
+    if(hashField.value == 0) {
+        MjvmObject *byteArray = fields->getFieldObject(*(MjvmConstNameAndType *)stringValueFieldName).object;
+        if(getCoder() == 0)
+            hashField.value = StringKernel_HashCode8(byteArray->data, byteArray->size);
+        else
+            hashField.value = StringKernel_HashCode16((const uint16_t *)byteArray->data, byteArray->size >> 1);
+    }
+    return hashField.value;
+}
+
+int32_t MjvmString::getHashCode(const MjvmConstUtf8 &utf8) {
+    uint32_t hash = 0;
+    const char *text = utf8.text;
+    const char *end = &utf8.text[utf8.length];
+    while(text < end) {
+        hash = hash * 31 + (uint16_t)utf8Decode(text);
+        text += getUtf8DecodeSize(*text);
+    }
+    return hash;
+}
+
 bool MjvmString::equals(const char *text, uint32_t length) const {
     uint8_t coder1 = getCoder();
     if((getLength() != length) || (coder1 != 0))
@@ -169,4 +195,5 @@ bool MjvmString::equals(MjvmString &str) const {
 
 MjvmConstString::MjvmConstString(MjvmString &mjvmString) : mjvmString(mjvmString) {
     next = 0;
+    hashNext = 0;
 }
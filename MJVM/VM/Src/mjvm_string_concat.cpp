@@ -0,0 +1,285 @@
+
+#include <new>
+#include <string.h>
+#include "mjvm.h"
+#include "mjvm_const_name.h"
+#include "mjvm_string_concat.h"
+#include "mjvm_native_number_format.h"
+#include "mjvm_native_string_kernel.h"
+
+static const MjvmConstUtf8 &makeConcatName = *(const MjvmConstUtf8 *)"\x0A\x00\xF6\x03""makeConcat";
+static const MjvmConstUtf8 &makeConcatWithConstantsName = *(const MjvmConstUtf8 *)"\x17\x00\x4F\x09""makeConcatWithConstants";
+
+MjvmStringConcat::MjvmStringConcat(uint16_t argc) : argc(argc) {
+    partsCount = 0;
+    constCoder = 0;
+    constLength = 0;
+}
+
+void MjvmStringConcat::addConst(const uint8_t *text, uint32_t length, uint8_t coder, uint8_t *&textBuff) {
+    if(length == 0)
+        return;
+    if(coder && StringKernel_IsLatin1((const uint16_t *)text, length)) {
+        StringKernel_Compress((const uint16_t *)text, textBuff, length);
+        coder = 0;
+    }
+    else
+        memcpy(textBuff, text, length << coder);
+    MjvmConcatPart &part = parts[partsCount++];
+    part.type = 0;
+    part.coder = coder;
+    part.slot = 0;
+    part.length = length;
+    part.text = textBuff;
+    /* keep the next text word aligned for the utf16 ones */
+    textBuff += ((length << coder) + 1) & ~0x01;
+    constLength += length;
+    constCoder |= coder;
+}
+
+MjvmStringConcat *MjvmStringConcat::link(Mjvm &mjvm, MjvmClassLoader &classLoader, MjvmConstInvokeDynamic &constInvokeDynamic) {
+    MjvmBootstrapMethod &bootstrapMethod = classLoader.getBootstrapMethod(constInvokeDynamic.bootstrapMethodAttrIndex);
+    MjvmConstMethodHandle &methodHandle = classLoader.getConstMethodHandle(bootstrapMethod.bootstrapMethodRef);
+    if(methodHandle.referenceKind != REF_INVOKE_STATIC || methodHandle.className != stringConcatFactoryClassName)
+        return 0;
+    bool hasRecipe = (methodHandle.nameAndType.name == makeConcatWithConstantsName);
+    if(!hasRecipe && methodHandle.nameAndType.name != makeConcatName)
+        return 0;
+
+    /* a method descriptor has at most 255 parameter slots */
+    uint8_t argTypes[255];
+    uint16_t argSlots[255];
+    uint16_t argCount = 0;
+    uint16_t slot = 0;
+    const char *descriptor = &constInvokeDynamic.nameAndType.descriptor.text[1];
+    while(*descriptor != ')') {
+        argSlots[argCount] = slot;
+        if(*descriptor == 'J' || *descriptor == 'D')
+            slot += 2;
+        else
+            slot++;
+        if(strncmp(descriptor, "Ljava/lang/String;", 18) == 0)
+            argTypes[argCount++] = 'T';
+        else if(*descriptor == 'L' || *descriptor == '[')
+            argTypes[argCount++] = 'L';
+        else
+            argTypes[argCount++] = *descriptor;
+        while(*descriptor == '[')
+            descriptor++;
+        if(*descriptor == 'L') {
+            while(*descriptor != ';')
+                descriptor++;
+        }
+        descriptor++;
+    }
+
+    /* makeConcat has no recipe, it is the same as a recipe made of \1 for every argument */
+    const uint8_t *recipe = 0;
+    uint32_t recipeLength = argCount;
+    uint8_t recipeCoder = 0;
+    uint32_t textSize = 0;
+    if(hasRecipe) {
+        MjvmString &recipeStr = classLoader.getConstString(mjvm, bootstrapMethod.getBootstrapArgument(0));
+        recipe = (const uint8_t *)recipeStr.getText();
+        recipeLength = recipeStr.getLength();
+        recipeCoder = recipeStr.getCoder();
+        textSize = recipeLength << recipeCoder;
+        for(uint16_t i = 1; i < bootstrapMethod.numBootstrapArguments; i++) {
+            uint16_t poolIndex = bootstrapMethod.getBootstrapArgument(i);
+            if((classLoader.getConstPool(poolIndex).tag & 0x7F) == CONST_STRING) {
+                MjvmString &str = classLoader.getConstString(mjvm, poolIndex);
+                textSize += str.getLength() << str.getCoder();
+            }
+            else
+                textSize += NUMBER_FORMAT_BUFF_SIZE;
+        }
+    }
+
+    /* every character of the recipe makes at most one part, each text is padded by at most one byte */
+    uint32_t partsSize = recipeLength * sizeof(MjvmConcatPart);
+    MjvmStringConcat *stringConcat = (MjvmStringConcat *)Mjvm::malloc(sizeof(MjvmStringConcat) + partsSize + textSize + recipeLength);
+    new (stringConcat)MjvmStringConcat(slot);
+    uint8_t *textBuff = (uint8_t *)stringConcat + sizeof(MjvmStringConcat) + partsSize;
+    try {
+        uint16_t argIndex = 0;
+        uint16_t constIndex = 1;
+        uint32_t start = 0;
+        for(uint32_t i = 0; i < recipeLength; i++) {
+            uint16_t c = (recipe == 0) ? 1 : (recipeCoder ? ((const uint16_t *)recipe)[i] : recipe[i]);
+            if(c != 1 && c != 2)
+                continue;
+            if(i > start)
+                stringConcat->addConst(&recipe[start << recipeCoder], i - start, recipeCoder, textBuff);
+            start = i + 1;
+            if(c == 1) {
+                if(argIndex >= argCount)
+                    throw "the recipe of string concatenation does not match the arguments";
+                MjvmConcatPart &part = stringConcat->parts[stringConcat->partsCount++];
+                part.type = argTypes[argIndex];
+                part.coder = 0;
+                part.slot = argSlots[argIndex];
+                part.length = 0;
+                part.text = 0;
+                argIndex++;
+            }
+            else {
+                if(constIndex >= bootstrapMethod.numBootstrapArguments)
+                    throw "the recipe of string concatenation does not match the constants";
+                uint16_t poolIndex = bootstrapMethod.getBootstrapArgument(constIndex++);
+                char buff[NUMBER_FORMAT_BUFF_SIZE];
+                uint32_t length;
+                switch(classLoader.getConstPool(poolIndex).tag & 0x7F) {
+                    case CONST_STRING: {
+                        MjvmString &str = classLoader.getConstString(mjvm, poolIndex);
+                        stringConcat->addConst((const uint8_t *)str.getText(), str.getLength(), str.getCoder(), textBuff);
+                        continue;
+                    }
+                    case CONST_INTEGER:
+                        length = NumberFormat_Int32(classLoader.getConstInteger(poolIndex), buff);
+                        break;
+                    case CONST_FLOAT:
+                        length = NumberFormat_Float(classLoader.getConstFloat(poolIndex), buff);
+                        break;
+                    case CONST_LONG:
+                        length = NumberFormat_Int64(classLoader.getConstLong(poolIndex), buff);
+                        break;
+                    case CONST_DOUBLE:
+                        length = NumberFormat_Double(classLoader.getConstDouble(poolIndex), buff);
+                        break;
+                    default:
+                        throw "the constant type of string concatenation is not supported";
+                }
+                stringConcat->addConst((const uint8_t *)buff, length, 0, textBuff);
+            }
+        }
+        if(recipeLength > start)
+            stringConcat->addConst(&recipe[start << recipeCoder], recipeLength - start, recipeCoder, textBuff);
+        if(argIndex != argCount)
+            throw "the recipe of string concatenation does not match the arguments";
+    }
+    catch(const char *msg) {
+        Mjvm::free(stringConcat);
+        throw msg;
+    }
+    catch(MjvmOutOfMemoryError *err) {
+        Mjvm::free(stringConcat);
+        throw err;
+    }
+    return stringConcat;
+}
+
+int32_t MjvmStringConcat::findObjectArgument(const int32_t *args) const {
+    /* only the arguments that are not declared as String may need the toString call */
+    for(uint16_t i = 0; i < partsCount; i++) {
+        if(parts[i].type == 'L') {
+            MjvmObject *obj = (MjvmObject *)args[parts[i].slot];
+            if(obj && (obj->dimensions || obj->type != stringClassName))
+                return parts[i].slot;
+        }
+    }
+    return -1;
+}
+
+static uint32_t formatArgument(uint8_t type, const int32_t *arg, char *buff) {
+    /* long and double take two stack slots, the low word is in the first one */
+    uint64_t value64 = ((uint64_t)(uint32_t)arg[1] << 32) | (uint32_t)arg[0];
+    switch(type) {
+        case 'J':
+            return NumberFormat_Int64((int64_t)value64, buff);
+        case 'F':
+            return NumberFormat_Float(*(const float *)arg, buff);
+        case 'D':
+            return NumberFormat_Double(*(const double *)&value64, buff);
+        default:
+            return NumberFormat_Int32(arg[0], buff);
+    }
+}
+
+static uint32_t copyText(uint8_t *data, uint8_t coder, uint32_t index, const uint8_t *text, uint8_t textCoder, uint32_t length) {
+    if(coder == 0)
+        memcpy(&data[index], text, length);
+    else if(textCoder == 0)
+        StringKernel_Inflate(text, &((uint16_t *)data)[index], length);
+    else
+        memcpy(&((uint16_t *)data)[index], text, length << 1);
+    return index + length;
+}
+
+MjvmString *MjvmStringConcat::concat(Mjvm &mjvm, const int32_t *args) const {
+    char buff[NUMBER_FORMAT_BUFF_SIZE];
+    uint32_t length = constLength;
+    uint8_t coder = constCoder;
+
+    /* the exact length and coder first so that the result is filled in place with a single allocation */
+    for(uint16_t i = 0; i < partsCount; i++) {
+        const MjvmConcatPart &part = parts[i];
+        const int32_t *arg = &args[part.slot];
+        switch(part.type) {
+            case 0:
+                break;
+            case 'T':
+            case 'L': {
+                MjvmString *str = (MjvmString *)arg[0];
+                if(str) {
+                    length += str->getLength();
+                    coder |= str->getCoder();
+                }
+                else
+                    length += 4;
+                break;
+            }
+            case 'C':
+                length++;
+                if((uint16_t)arg[0] > 0xFF)
+                    coder = 1;
+                break;
+            case 'Z':
+                length += arg[0] ? 4 : 5;
+                break;
+            default:
+                /* the number is formatted again when it is copied, that is cheaper than keeping a buffer per argument */
+                length += formatArgument(part.type, arg, buff);
+                break;
+        }
+    }
+
+    MjvmString *strObj = mjvm.newString(length, coder);
+    uint8_t *data = (uint8_t *)strObj->getText();
+    uint32_t index = 0;
+    for(uint16_t i = 0; i < partsCount; i++) {
+        const MjvmConcatPart &part = parts[i];
+        const int32_t *arg = &args[part.slot];
+        switch(part.type) {
+            case 0:
+                index = copyText(data, coder, index, part.text, part.coder, part.length);
+                break;
+            case 'T':
+            case 'L': {
+                MjvmString *str = (MjvmString *)arg[0];
+                if(str)
+                    index = copyText(data, coder, index, (const uint8_t *)str->getText(), str->getCoder(), str->getLength());
+                else
+                    index = copyText(data, coder, index, (const uint8_t *)"null", 0, 4);
+                break;
+            }
+            case 'C':
+                if(coder)
+                    ((uint16_t *)data)[index++] = (uint16_t)arg[0];
+                else
+                    data[index++] = (uint8_t)arg[0];
+                break;
+            case 'Z':
+                if(arg[0])
+                    index = copyText(data, coder, index, (const uint8_t *)"true", 0, 4);
+                else
+                    index = copyText(data, coder, index, (const uint8_t *)"false", 0, 5);
+                break;
+            default: {
+                uint32_t count = formatArgument(part.type, arg, buff);
+                index = copyText(data, coder, index, (const uint8_t *)buff, 0, count);
+                break;
+            }
+        }
+    }
+    return strObj;
+}
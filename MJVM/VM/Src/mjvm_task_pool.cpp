@@ -0,0 +1,253 @@
+
+#include <new>
+#include <string.h>
+#include "mjvm.h"
+#include "mjvm_task_pool.h"
+#include "mjvm_const_name.h"
+#include "mjvm_system_api.h"
+
+#define TASK_QUEUE_MIN_CAPACITY     8
+#define TASK_SEMAPHORE_MAX_COUNT    0x7FFFFFFF
+
+MjvmTaskWorker::MjvmTaskWorker(MjvmTaskPool &pool, MjvmExecution &execution) : pool(pool), execution(execution) {
+    currentTask = 0;
+    tasks = 0;
+    capacity = 0;
+    head = 0;
+    tail = 0;
+}
+
+uint32_t MjvmTaskWorker::getTaskCount(void) const {
+    return tail - head;
+}
+
+void MjvmTaskWorker::pushTask(MjvmObject *task) {
+    uint32_t count = tail - head;
+    if(count == capacity) {
+        /* the queue is full, double its capacity and unwrap the ring */
+        uint32_t newCapacity = capacity ? (capacity << 1) : TASK_QUEUE_MIN_CAPACITY;
+        MjvmObject **newTasks = (MjvmObject **)Mjvm::malloc(newCapacity * sizeof(MjvmObject *));
+        for(uint32_t i = 0; i < count; i++)
+            newTasks[i] = tasks[(head + i) & (capacity - 1)];
+        if(tasks)
+            Mjvm::free(tasks);
+        tasks = newTasks;
+        capacity = newCapacity;
+        head = 0;
+        tail = count;
+    }
+    tasks[tail & (capacity - 1)] = task;
+    tail++;
+}
+
+MjvmObject *MjvmTaskWorker::popTask(bool isFifo) {
+    if(head == tail)
+        return 0;
+    if(isFifo)
+        return tasks[(head++) & (capacity - 1)];
+    return tasks[(--tail) & (capacity - 1)];
+}
+
+void MjvmTaskWorker::workerTask(MjvmTaskWorker *worker) {
+    MjvmTaskPool &pool = worker->pool;
+    while(pool.state == TASK_POOL_RUNNING || pool.state == TASK_POOL_SHUTDOWN) {
+        MjvmObject *task = pool.takeTask(*worker);
+        if(task) {
+            try {
+                MjvmConstMethod constMethod(task->type, *(MjvmConstNameAndType *)runnableRunMethodName, 0, 0);
+                worker->execution.method = &pool.mjvm.findMethod(constMethod);
+                worker->execution.execute(task);
+            }
+            catch(MjvmLoadFileError *file) {
+                const char *fileName = file->getFileName();
+                MjvmSystem_Write("Could not find or load class ", 29, 0);
+                MjvmSystem_Write(fileName, strlen(fileName), 0);
+                MjvmSystem_Write("\n", 1, 0);
+            }
+            catch(const char *msg) {
+                MjvmSystem_Write(msg, strlen(msg), 0);
+                MjvmSystem_Write("\n", 1, 0);
+            }
+            Mjvm::lock();
+            worker->currentTask = 0;
+            pool.pendingCount--;
+            bool isDrained = (pool.state == TASK_POOL_SHUTDOWN && pool.pendingCount == 0);
+            Mjvm::unlock();
+            if(isDrained)
+                pool.wakeUpAllWorkers();
+        }
+        else if(pool.state == TASK_POOL_SHUTDOWN && pool.pendingCount == 0)
+            break;
+        else
+            MjvmSystem_SemaphoreTake(pool.taskSemaphore, MJVM_WAIT_FOREVER);
+    }
+    Mjvm::lock();
+    pool.activeCount--;
+    if(pool.activeCount == 0) {
+        /* the pool is only freed under the lock, it is not touched after the lock is released */
+        pool.releaseWorkers();
+        MjvmSystem_SemaphoreGive(pool.terminatedSemaphore);
+        pool.state = TASK_POOL_TERMINATED;
+    }
+    Mjvm::unlock();
+}
+
+MjvmTaskWorker::~MjvmTaskWorker(void) {
+    if(tasks)
+        Mjvm::free(tasks);
+}
+
+MjvmTaskPool::MjvmTaskPool(Mjvm &mjvm, uint16_t workerCount, bool asyncMode, MjvmObject *owner) :
+mjvm(mjvm), owner(owner), asyncMode(asyncMode), workerCount(workerCount) {
+    next = 0;
+    isOwnerCollected = false;
+    state = TASK_POOL_RUNNING;
+    activeCount = 0;
+    pendingCount = 0;
+    submitIndex = 0;
+    taskSemaphore = MjvmSystem_SemaphoreCreate(0, TASK_SEMAPHORE_MAX_COUNT);
+    terminatedSemaphore = MjvmSystem_SemaphoreCreate(0, 1);
+    workers = (MjvmTaskWorker *)Mjvm::malloc(workerCount * sizeof(MjvmTaskWorker));
+    for(uint16_t i = 0; i < workerCount; i++)
+        new (&workers[i])MjvmTaskWorker(*this, mjvm.newExecution());
+    for(uint16_t i = 0; i < workerCount; i++) {
+        activeCount++;
+        if(MjvmSystem_ThreadCreate((void (*)(void *))MjvmTaskWorker::workerTask, (void *)&workers[i]) == 0)
+            activeCount--;
+    }
+    if(activeCount == 0) {
+        Mjvm::lock();
+        releaseWorkers();
+        MjvmSystem_SemaphoreGive(terminatedSemaphore);
+        state = TASK_POOL_TERMINATED;
+        Mjvm::unlock();
+    }
+}
+
+uint16_t MjvmTaskPool::getWorkerCount(void) const {
+    return workerCount;
+}
+
+uint32_t MjvmTaskPool::getPendingCount(void) const {
+    return pendingCount;
+}
+
+MjvmObject *MjvmTaskPool::takeTask(MjvmTaskWorker &worker) {
+    Mjvm::lock();
+    /* take from the local queue first, LIFO unless the pool is in async mode */
+    MjvmObject *task = worker.popTask(asyncMode);
+    if(task == 0) {
+        /* steal the oldest task of another worker */
+        uint32_t index = &worker - workers;
+        for(uint16_t i = 1; i < workerCount; i++) {
+            task = workers[(index + i) % workerCount].popTask(true);
+            if(task)
+                break;
+        }
+    }
+    worker.currentTask = task;
+    Mjvm::unlock();
+    return task;
+}
+
+void MjvmTaskPool::wakeUpAllWorkers(void) {
+    for(uint16_t i = 0; i < workerCount; i++)
+        MjvmSystem_SemaphoreGive(taskSemaphore);
+}
+
+/* the stacks of the workers are given back to the VM when the pool terminates, the queues are empty by then and the lock is held */
+void MjvmTaskPool::releaseWorkers(void) {
+    for(uint16_t i = 0; i < workerCount; i++) {
+        MjvmTaskWorker &worker = workers[i];
+        mjvm.releaseExecutionLocked(worker.execution);
+        if(worker.tasks)
+            Mjvm::free(worker.tasks);
+        worker.tasks = 0;
+        worker.capacity = 0;
+        worker.head = 0;
+        worker.tail = 0;
+    }
+}
+
+bool MjvmTaskPool::execute(MjvmExecution &caller, MjvmObject *task) {
+    Mjvm::lock();
+    if(state != TASK_POOL_RUNNING) {
+        Mjvm::unlock();
+        return false;
+    }
+    /* tasks forked from a worker go to its own queue, the others are distributed */
+    MjvmTaskWorker *worker = 0;
+    for(uint16_t i = 0; i < workerCount; i++) {
+        if(&workers[i].execution == &caller) {
+            worker = &workers[i];
+            break;
+        }
+    }
+    if(worker == 0) {
+        worker = &workers[submitIndex];
+        submitIndex = (submitIndex + 1) % workerCount;
+    }
+    try {
+        worker->pushTask(task);
+    }
+    catch(MjvmOutOfMemoryError *err) {
+        Mjvm::unlock();
+        throw err;
+    }
+    pendingCount++;
+    Mjvm::unlock();
+    MjvmSystem_SemaphoreGive(taskSemaphore);
+    return true;
+}
+
+void MjvmTaskPool::shutdown(void) {
+    Mjvm::lock();
+    if(state == TASK_POOL_RUNNING)
+        state = TASK_POOL_SHUTDOWN;
+    Mjvm::unlock();
+    wakeUpAllWorkers();
+}
+
+bool MjvmTaskPool::isShutdown(void) const {
+    return state != TASK_POOL_RUNNING;
+}
+
+bool MjvmTaskPool::isTerminated(void) const {
+    return state == TASK_POOL_TERMINATED;
+}
+
+bool MjvmTaskPool::awaitTermination(uint32_t timeoutMs) {
+    if(state == TASK_POOL_TERMINATED)
+        return true;
+    if(!MjvmSystem_SemaphoreTake(terminatedSemaphore, timeoutMs))
+        return false;
+    /* give the signal back so that other waiters are released too */
+    MjvmSystem_SemaphoreGive(terminatedSemaphore);
+    return true;
+}
+
+void MjvmTaskPool::terminate(void) {
+    Mjvm::lock();
+    if(state == TASK_POOL_TERMINATED) {
+        Mjvm::unlock();
+        return;
+    }
+    state = TASK_POOL_SHUTDOWN;
+    for(uint16_t i = 0; i < workerCount; i++) {
+        /* drop the queued tasks, the running ones are requested to exit */
+        pendingCount -= workers[i].getTaskCount();
+        workers[i].head = workers[i].tail;
+        workers[i].execution.terminateRequest();
+    }
+    Mjvm::unlock();
+    wakeUpAllWorkers();
+    awaitTermination(MJVM_WAIT_FOREVER);
+}
+
+MjvmTaskPool::~MjvmTaskPool(void) {
+    for(uint16_t i = 0; i < workerCount; i++)
+        workers[i].~MjvmTaskWorker();
+    Mjvm::free(workers);
+    MjvmSystem_SemaphoreDelete(taskSemaphore);
+    MjvmSystem_SemaphoreDelete(terminatedSemaphore);
+}
@@ -1,9 +1,5 @@
 package java.lang;
 
-import java.io.IOException;
-import jdk.internal.math.DoubleToDecimal;
-import jdk.internal.math.FloatToDecimal;
-
 abstract sealed class AbstractStringBuilder implements Appendable, CharSequence permits StringBuilder, StringBuffer {
     byte[] value;
     boolean maybeLatin1;
@@ -75,9 +71,7 @@ abstract sealed class AbstractStringBuilder implements Appendable, CharSequence
         return append(String.valueOf(obj));
     }
 
-    public AbstractStringBuilder append(String str) {
-        return append(str, 0, str.length());
-    }
+    public native AbstractStringBuilder append(String str);
 
     public AbstractStringBuilder append(StringBuffer sb) {
         return append(sb, 0, sb.length());
@@ -201,52 +195,15 @@ abstract sealed class AbstractStringBuilder implements Appendable, CharSequence
     }
 
     @Override
-    public AbstractStringBuilder append(char c) {
-        if((coder == 0) && (c < 256)) {
-            ensureCapacityInternal(count + 1);
-            value[count++] = (byte)c;
-        }
-        else {
-            if(count != 0)
-                inflate();
-            else
-                coder = 1;
-            ensureCapacityInternal(count + 1);
-            int index = count << 1;
-            value[index] = (byte)c;
-            value[index + 1] = (byte)(c >>> 8);
-            count++;
-        }
-        return this;
-    }
+    public native AbstractStringBuilder append(char c);
 
-    public AbstractStringBuilder append(int i) {
-        return append(String.valueOf(i));
-    }
+    public native AbstractStringBuilder append(int i);
 
-    public AbstractStringBuilder append(long l) {
-        return append(String.valueOf(l));
-    }
+    public native AbstractStringBuilder append(long l);
 
-    public AbstractStringBuilder append(float f) {
-        try {
-            FloatToDecimal.appendTo(f, this);
-        }
-        catch(IOException e) {
-            throw new AssertionError(e);
-        }
-        return this;
-    }
+    public native AbstractStringBuilder append(float f);
 
-    public AbstractStringBuilder append(double d) {
-        try {
-            DoubleToDecimal.appendTo(d, this);
-        }
-        catch(IOException e) {
-            throw new AssertionError(e);
-        }
-        return this;
-    }
+    public native AbstractStringBuilder append(double d);
 
     private AbstractStringBuilder appendNull() {
         int count = this.count;
@@ -286,18 +243,7 @@ abstract sealed class AbstractStringBuilder implements Appendable, CharSequence
         return count - another.count;
     }
 
-    private void inflate() {
-        if(this.coder == 1)
-            return;
-        int count = this.count;
-        byte[] value = this.value;
-        int length = value.length;
-        byte[] buf = new byte[length << 1];
-        for(int i = 0; i < count; i++)
-            buf[i << 1] = value[i];
-        this.value = buf;
-        this.coder = 1;
-    }
+    private native void inflate();
 
     public void trimToSize() {
         int length = count << coder;
@@ -368,7 +314,7 @@ abstract sealed class AbstractStringBuilder implements Appendable, CharSequence
     }
 
     @Override
-    public abstract String toString();
+    public native String toString();
 
     public int capacity() {
         return value.length >> coder;
@@ -378,8 +324,10 @@ abstract sealed class AbstractStringBuilder implements Appendable, CharSequence
         byte coder = this.coder;
         int oldCapacity = value.length >> coder;
         if(minimumCapacity > oldCapacity) {
-            minimumCapacity += 16;
-            byte[] buff = new byte[minimumCapacity << coder];
+            int newCapacity = (oldCapacity << 1) + 2;
+            if(newCapacity < minimumCapacity)
+                newCapacity = minimumCapacity;
+            byte[] buff = new byte[newCapacity << coder];
             System.arraycopy(value, 0, buff, 0, count << coder);
             value = buff;
         }
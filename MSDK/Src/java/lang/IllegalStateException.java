@@ -0,0 +1,11 @@
+package java.lang;
+
+public class IllegalStateException extends RuntimeException {
+    public IllegalStateException() {
+        super();
+    }
+
+    public IllegalStateException(String s) {
+        super(s);
+    }
+}
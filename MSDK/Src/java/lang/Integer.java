@@ -14,35 +14,11 @@ public final class Integer extends Number implements Comparable<Integer> {
         if(0 <= i && i < 10)
             return (char)(i + '0');
         else if(10 <= i && i < Character.MAX_RADIX)
-            return (char)(i + 'a');
+            return (char)(i - 10 + 'a');
         throw new NumberFormatException("Cannot convert number " + i + " to char");
     }
 
-    public static String toString(int i, int radix) {
-        if(radix < Character.MIN_RADIX || radix > Character.MAX_RADIX)
-            radix = 10;
-
-        if(radix == 10)
-            return toString(i);
-
-        byte[] buf = new byte[33];
-        boolean negative = (i < 0);
-        int charPos = buf.length - 1;
-
-        if(!negative)
-            i = -i;
-
-        while(i <= -radix) {
-            buf[charPos--] = (byte)digitToChar(-(i % radix));
-            i = i / radix;
-        }
-        buf[charPos] = (byte)digitToChar(-i);
-
-        if(negative)
-            buf[--charPos] = '-';
-
-        return String.newString(buf, charPos, (33 - charPos), (byte)0);
-    }
+    public static native String toString(int i, int radix);
 
     public static String toUnsignedString(int i, int radix) {
         return Long.toUnsignedString(toUnsignedLong(i), radix);
@@ -78,35 +54,13 @@ public final class Integer extends Number implements Comparable<Integer> {
         } while(charPos > 0);
     }
 
-    public static String toString(int i) {
-        byte[] buffer = new byte[11];
-        int index = buffer.length - 1;
-        boolean negative;
-        if(i < 0) {
-            negative = true;
-            i = -i;
-        }
-        else
-            negative = false;
-
-        do {
-            buffer[--index] = (byte)((i % 10) + '0');
-            i /= 10;
-        } while(i > 0);
-
-        if(negative)
-            buffer[--index] = '-';
-
-        return String.newString(buffer, index, buffer.length - index, (byte)0);
-    }
+    public static native String toString(int i);
 
     public static String toUnsignedString(int i) {
         return Long.toString(toUnsignedLong(i));
     }
 
-    public static int parseInt(String s, int radix) throws NumberFormatException {
-        return parseInt(s, 0, s.length(), radix);
-    }
+    public static native int parseInt(String s, int radix) throws NumberFormatException;
 
     public static int parseInt(CharSequence s, int beginIndex, int endIndex, int radix) throws NumberFormatException {
         if(s == null)
@@ -10,31 +10,7 @@ public final class Long extends Number implements Comparable<Long> {
 
     private final long value;
 
-    public static String toString(long i, int radix) {
-        if(radix < Character.MIN_RADIX || radix > Character.MAX_RADIX)
-            radix = 10;
-
-        if(radix == 10)
-            return toString(i);
-
-        byte[] buf = new byte[65];
-        boolean negative = (i < 0);
-        int charPos = buf.length - 1;
-
-        if(!negative)
-            i = -i;
-
-        while(i <= -radix) {
-            buf[charPos--] = (byte)Integer.digitToChar((int)-(i % radix));
-            i = i / radix;
-        }
-        buf[charPos] = (byte)Integer.digitToChar((int)-i);
-
-        if(negative)
-            buf[--charPos] = '-';
-
-        return String.newString(buf, charPos, (33 - charPos), (byte)0);
-    }
+    public static native String toString(long i, int radix);
 
 
     public static String toUnsignedString(long i, int radix) {
@@ -117,35 +93,13 @@ public final class Long extends Number implements Comparable<Long> {
         return String.newString(buf, (byte)0);
     }
 
-    public static String toString(long i) {
-        byte[] buffer = new byte[21];
-        int index = buffer.length - 1;
-        boolean negative;
-        if(i < 0) {
-            negative = true;
-            i = -i;
-        }
-        else
-            negative = false;
-
-        do {
-            buffer[--index] = (byte)((i % 10) + 48);
-            i /= 10;
-        } while(i > 0);
-
-        if(negative)
-            buffer[--index] = '-';
-
-        return String.newString(buffer, index, buffer.length - index, (byte)0);
-    }
+    public static native String toString(long i);
 
     public static String toUnsignedString(long i) {
         return toUnsignedString(i, 10);
     }
 
-    public static long parseLong(String s, int radix) throws NumberFormatException {
-        return parseLong(s, 0, s.length(), radix);
-    }
+    public static native long parseLong(String s, int radix) throws NumberFormatException;
 
     public static long parseLong(CharSequence s, int beginIndex, int endIndex, int radix) throws NumberFormatException {
         if(s == null)
@@ -0,0 +1,11 @@
+package java.lang;
+
+public class NoClassDefFoundError extends LinkageError {
+    public NoClassDefFoundError() {
+        super();
+    }
+
+    public NoClassDefFoundError(String s) {
+        super(s);
+    }
+}
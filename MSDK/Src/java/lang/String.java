@@ -3,6 +3,7 @@ package java.lang;
 public final class String implements Comparable<String>, CharSequence {
     private final byte[] value;
     private final byte coder;
+    private int hash;
 
     private static boolean isLatin1(byte[] utf8Value, int offset, int count) {
         count += offset;
@@ -535,6 +536,8 @@ public final class String implements Comparable<String>, CharSequence {
         return this;
     }
 
+    public native int hashCode();
+
     public boolean equals(Object anObject) {
         if(this == anObject)
             return true;
@@ -36,7 +36,7 @@ public final class StringBuffer extends AbstractStringBuilder implements Compara
 
     @Override
     public synchronized StringBuffer append(String str) {
-        super.append(str, 0, str.length());
+        super.append(str);
         return this;
     }
 
@@ -84,13 +84,13 @@ public final class StringBuffer extends AbstractStringBuilder implements Compara
 
     @Override
     public synchronized StringBuffer append(int i) {
-        super.append(String.valueOf(i));
+        super.append(i);
         return this;
     }
 
     @Override
     public synchronized StringBuffer append(long l) {
-        super.append(String.valueOf(l));
+        super.append(l);
         return this;
     }
 
@@ -158,6 +158,6 @@ public final class StringBuffer extends AbstractStringBuilder implements Compara
 
     @Override
     public synchronized String toString() {
-        return super.substring(0, count);
+        return super.toString();
     }
 }
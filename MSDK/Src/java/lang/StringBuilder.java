@@ -31,7 +31,7 @@ public final class StringBuilder extends AbstractStringBuilder implements Compar
 
     @Override
     public StringBuilder append(String str) {
-        super.append(str, 0, str.length());
+        super.append(str);
         return this;
     }
 
@@ -79,13 +79,13 @@ public final class StringBuilder extends AbstractStringBuilder implements Compar
 
     @Override
     public StringBuilder append(int i) {
-        super.append(String.valueOf(i));
+        super.append(i);
         return this;
     }
 
     @Override
     public StringBuilder append(long l) {
-        super.append(String.valueOf(l));
+        super.append(l);
         return this;
     }
 
@@ -115,9 +115,4 @@ public final class StringBuilder extends AbstractStringBuilder implements Compar
     public int capacity() {
         return value.length >> coder;
     }
-
-    @Override
-    public String toString() {
-        return substring(0, count);
-    }
 }
@@ -18,156 +18,19 @@ final class StringUTF16 {
         value[index + 1] = 0;
     }
 
-    public static int indexOf(byte[] value, int ch, int fromIndex) {
-        if(ch > 65535)
-            return -1;
-        for(int i = fromIndex; i < value.length; i++) {
-            if(ch == charAt(value, i))
-                return i;
-        }
-        return -1;
-    }
+    public static native int indexOf(byte[] value, int ch, int fromIndex);
 
-    public static int indexOf(byte[] value, byte[] str, int fromIndex) {
-        if(str.length == 0)
-            return 0;
-        if(value.length == 0)
-            return -1;
-        int valueCount = value.length >>> 1;
-        int strCount = str.length >>> 1;
-        char first = charAt(str, 0);
-        int max = (valueCount - strCount);
-        for(int i = fromIndex; i <= max; i++) {
-            if(charAt(value, i) != first)
-                while(++i <= max && charAt(value, i) != first);
-            if(i <= max) {
-                int j = i + 1;
-                int end = j + strCount - 1;
-                for(int k = 1; j < end && charAt(value, j) == charAt(str, k); j++, k++);
-                if(j == end)
-                    return i;
-            }
-        }
-        return -1;
-    }
+    public static native int indexOf(byte[] value, byte[] str, int fromIndex);
 
-    public static int indexOfLatin1(byte[] value, byte[] str, int fromIndex) {
-        if(str.length == 0)
-            return 0;
-        if(value.length == 0)
-            return -1;
-        int valueCount = value.length >>> 1;
-        int strCount = str.length;
-        char first = (char)str[0];
-        int max = (valueCount - strCount);
-        for(int i = fromIndex; i <= max; i++) {
-            if(charAt(value, i) != first)
-                while(++i <= max && charAt(value, i) != first);
-            if(i <= max) {
-                int j = i + 1;
-                int end = j + strCount - 1;
-                for(int k = 1; j < end && charAt(value, j) == (char)str[k]; j++, k++);
-                if(j == end)
-                    return i;
-            }
-        }
-        return -1;
-    }
+    public static native int indexOfLatin1(byte[] value, byte[] str, int fromIndex);
 
-    public static int lastIndexOf(byte[] value, int ch, int fromIndex) {
-        if(ch > 65535)
-            return -1;
-        for(int i = fromIndex; i >= 0; i--) {
-            if(ch == charAt(value, i))
-                return i;
-        }
-        return -1;
-    }
+    public static native int lastIndexOf(byte[] value, int ch, int fromIndex);
 
-    public static int lastIndexOf(byte[] value, byte[] str, int fromIndex) {
-        if(str.length == 0)
-            return value.length - 1;
-        if(value.length < str.length)
-            return -1;
-        int strCount = str.length >>> 1;
-        for(int i = fromIndex - (strCount - 1); i >= 0; i--) {
-            if(charAt(value, i) == charAt(str, 0)) {
-                boolean found = true;
-                for(int j = 1; j < strCount; j++) {
-                    if(charAt(value, i + j) != charAt(str, j)) {
-                        found = false;
-                        break;
-                    }
-                }
-                if(found)
-                    return i;
-            }
-        }
-        return -1;
-    }
+    public static native int lastIndexOf(byte[] value, byte[] str, int fromIndex);
 
-    public static int lastIndexOfLatin1(byte[] value, byte[] str, int fromIndex) {
-        if(str.length == 0)
-            return value.length - 1;
-        if(value.length < str.length)
-            return -1;
-        int strCount = str.length >>> 1;
-        for(int i = fromIndex - (strCount - 1); i >= 0; i--) {
-            if(charAt(value, i) == str[0]) {
-                boolean found = true;
-                for(int j = 1; j < strCount; j++) {
-                    if(charAt(value, i + j) != str[j]) {
-                        found = false;
-                        break;
-                    }
-                }
-                if(found)
-                    return i;
-            }
-        }
-        return -1;
-    }
+    public static native int lastIndexOfLatin1(byte[] value, byte[] str, int fromIndex);
 
-    public static String replace(byte[] value, char oldChar, char newChar) {
-        int i = 0;
-        int len = value.length >>> 1;
-        byte[] ret = null;
-        for(; i < len; i++) {
-            char c = charAt(value, i);
-            if(c == oldChar) {
-                ret = new byte[len << 1];
-                System.arraycopy(value, 0, ret, 0, i << 1);
-                int index = i << 1;
-                ret[index] = (byte)newChar;
-                ret[index + 1] = (byte)(newChar >>> 8);
-                break;
-            }
-        }
-        for(; i < len; i++) {
-            char c = charAt(value, i);
-            int index = i << 1;
-            if(c == oldChar) {
-                ret[index] = (byte)newChar;
-                ret[index + 1] = (byte)(newChar >>> 8);
-            }
-            else {
-                ret[index] = (byte)c;
-                ret[index + 1] = (byte)(c >>> 8);
-            }
-        }
-        if(ret != null) {
-            for(i = 0; i < len; i++) {
-                int index = i << 1;
-                if(ret[index + 1] != 0)
-                    return String.newString(ret, (byte)1);
-            }
-            byte[] buff = new byte[len];
-            for(i = 0; i < len; i++)
-                buff[i] = ret[i << 1];
-            return String.newString(ret, (byte)0);
-        }
-        return null;
-    }
+    public static native String replace(byte[] value, char oldChar, char newChar);
 
     public static String[] split(byte[] value) {
         int len = value.length >> 1;
@@ -232,57 +95,9 @@ final class StringUTF16 {
         return ret;
     }
 
-    public static String toLower(byte[] value) {
-        int i;
-        int length = value.length >>> 1;
-        byte[] ret = null;
-        for(i = 0; i < length; i++) {
-            char c = charAt(value, i);
-            char lower = Character.toLower(c);
-            if(lower != c) {
-                ret = new byte[value.length];
-                int index = i << 1;
-                System.arraycopy(value, 0, ret, 0, index);
-                ret[index] = (byte)lower;
-                ret[index + 1] = (byte)(lower >>> 8);
-                i++;
-                break;
-            }
-        }
-        for(; i < length; i++) {
-            int index = i << 1;
-            char lower = Character.toLower(charAt(value, i));
-            ret[index] = (byte)lower;
-            ret[index + 1] = (byte)(lower >>> 8);
-        }
-        return (ret == null) ? null : String.newString(ret,  (byte)1);
-    }
+    public static native String toLower(byte[] value);
 
-    public static String toUpper(byte[] value) {
-        int i;
-        int length = value.length >>> 1;
-        byte[] ret = null;
-        for(i = 0; i < length; i++) {
-            char c = charAt(value, i);
-            char upper = Character.toUpper(c);
-            if(upper != c) {
-                ret = new byte[value.length];
-                int index = i << 1;
-                System.arraycopy(value, 0, ret, 0, index);
-                ret[index] = (byte)upper;
-                ret[index + 1] = (byte)(upper >>> 8);
-                i++;
-                break;
-            }
-        }
-        for(; i < length; i++) {
-            int index = i << 1;
-            char upper = Character.toUpper(charAt(value, i));
-            ret[index] = (byte)upper;
-            ret[index + 1] = (byte)(upper >>> 8);
-        }
-        return (ret == null) ? null : String.newString(ret,  (byte)1);
-    }
+    public static native String toUpper(byte[] value);
 
     public static String trim(byte[] value) {
         int len = value.length >>> 1;
@@ -304,28 +119,11 @@ final class StringUTF16 {
         return ret;
     }
 
-    public static int compareTo(byte[] value, byte[] other) {
-        int len1 = value.length >>> 1;
-        int len2 = other.length >>> 1;
-        int lim = Math.min(len1, len2);
-        for(int i = 0; i < lim; i++) {
-            char c1 = charAt(value, i);
-            char c2 = charAt(value, i);
-            if(c1 != c2)
-                return c1 - c2;
-        }
-        return len1 - len2;
-    }
+    public static native int compareTo(byte[] value, byte[] other);
 
     public static int  compareToLatin1(byte[] value, byte[] other) {
         return -StringLatin1.compareToUTF16(other, value);
     }
 
-    public static boolean equalsIgnoreCase(byte[] value, byte[] other) {
-        int len = value.length >>> 1;
-        for(int i = 0; i < len; i++)
-            if(Character.toLower(charAt(value, i)) != Character.toLower(charAt(other, i)))
-                return false;
-        return true;
-    }
+    public static native boolean equalsIgnoreCase(byte[] value, byte[] other);
 }
@@ -0,0 +1,242 @@
+package java.util;
+
+public class ArrayDeque<E> implements Deque<E> {
+    private static final int DEFAULT_CAPACITY = 16;
+
+    private Object[] elements;
+    private int head;
+    private int size;
+
+    public ArrayDeque() {
+        elements = new Object[DEFAULT_CAPACITY];
+    }
+
+    public ArrayDeque(int numElements) {
+        int capacity = DEFAULT_CAPACITY;
+        while(capacity < numElements)
+            capacity <<= 1;
+        elements = new Object[capacity];
+    }
+
+    /* the capacity is always a power of two so that the indexes wrap around with a mask */
+    private void grow() {
+        Object[] es = elements;
+        int oldCapacity = es.length;
+        Object[] newElements = new Object[oldCapacity << 1];
+        int firstPart = oldCapacity - head;
+        System.arraycopy(es, head, newElements, 0, firstPart);
+        System.arraycopy(es, 0, newElements, firstPart, head);
+        elements = newElements;
+        head = 0;
+    }
+
+    public int size() {
+        return size;
+    }
+
+    public boolean isEmpty() {
+        return size == 0;
+    }
+
+    public void addFirst(E e) {
+        if(e == null)
+            throw new NullPointerException();
+        if(size == elements.length)
+            grow();
+        head = (head - 1) & (elements.length - 1);
+        elements[head] = e;
+        size++;
+    }
+
+    public void addLast(E e) {
+        if(e == null)
+            throw new NullPointerException();
+        if(size == elements.length)
+            grow();
+        elements[(head + size) & (elements.length - 1)] = e;
+        size++;
+    }
+
+    public boolean offerFirst(E e) {
+        addFirst(e);
+        return true;
+    }
+
+    public boolean offerLast(E e) {
+        addLast(e);
+        return true;
+    }
+
+    @SuppressWarnings("unchecked")
+    public E pollFirst() {
+        if(size == 0)
+            return null;
+        Object[] es = elements;
+        E e = (E)es[head];
+        es[head] = null;
+        head = (head + 1) & (es.length - 1);
+        size--;
+        return e;
+    }
+
+    @SuppressWarnings("unchecked")
+    public E pollLast() {
+        if(size == 0)
+            return null;
+        Object[] es = elements;
+        int index = (head + size - 1) & (es.length - 1);
+        E e = (E)es[index];
+        es[index] = null;
+        size--;
+        return e;
+    }
+
+    public E removeFirst() {
+        if(size == 0)
+            throw new NoSuchElementException();
+        return pollFirst();
+    }
+
+    public E removeLast() {
+        if(size == 0)
+            throw new NoSuchElementException();
+        return pollLast();
+    }
+
+    @SuppressWarnings("unchecked")
+    public E peekFirst() {
+        return (size == 0) ? null : (E)elements[head];
+    }
+
+    @SuppressWarnings("unchecked")
+    public E peekLast() {
+        return (size == 0) ? null : (E)elements[(head + size - 1) & (elements.length - 1)];
+    }
+
+    public E getFirst() {
+        if(size == 0)
+            throw new NoSuchElementException();
+        return peekFirst();
+    }
+
+    public E getLast() {
+        if(size == 0)
+            throw new NoSuchElementException();
+        return peekLast();
+    }
+
+    public boolean add(E e) {
+        addLast(e);
+        return true;
+    }
+
+    public boolean offer(E e) {
+        addLast(e);
+        return true;
+    }
+
+    public E remove() {
+        return removeFirst();
+    }
+
+    public E poll() {
+        return pollFirst();
+    }
+
+    public E element() {
+        return getFirst();
+    }
+
+    public E peek() {
+        return peekFirst();
+    }
+
+    public void push(E e) {
+        addFirst(e);
+    }
+
+    public E pop() {
+        return removeFirst();
+    }
+
+    private int indexOf(Object o) {
+        if(o != null) {
+            Object[] es = elements;
+            int mask = es.length - 1;
+            for(int i = 0; i < size; i++) {
+                if(o.equals(es[(head + i) & mask]))
+                    return i;
+            }
+        }
+        return -1;
+    }
+
+    public boolean contains(Object o) {
+        return indexOf(o) >= 0;
+    }
+
+    /* the elements after the removed one are moved back by one, the ones before it stay in place */
+    private void delete(int i) {
+        Object[] es = elements;
+        int mask = es.length - 1;
+        for(int n = size - 1; i < n; i++)
+            es[(head + i) & mask] = es[(head + i + 1) & mask];
+        es[(head + size - 1) & mask] = null;
+        size--;
+    }
+
+    public boolean remove(Object o) {
+        int i = indexOf(o);
+        if(i < 0)
+            return false;
+        delete(i);
+        return true;
+    }
+
+    public void clear() {
+        Object[] es = elements;
+        int mask = es.length - 1;
+        for(int i = 0; i < size; i++)
+            es[(head + i) & mask] = null;
+        head = 0;
+        size = 0;
+    }
+
+    public Object[] toArray() {
+        Object[] es = elements;
+        Object[] a = new Object[size];
+        int firstPart = Math.min(size, es.length - head);
+        System.arraycopy(es, head, a, 0, firstPart);
+        System.arraycopy(es, 0, a, firstPart, size - firstPart);
+        return a;
+    }
+
+    public Iterator<E> iterator() {
+        return new DeqIterator();
+    }
+
+    private class DeqIterator implements Iterator<E> {
+        private int cursor;
+        private int lastRet = -1;
+
+        public boolean hasNext() {
+            return cursor < size;
+        }
+
+        @SuppressWarnings("unchecked")
+        public E next() {
+            if(cursor >= size)
+                throw new NoSuchElementException();
+            lastRet = cursor++;
+            return (E)elements[(head + lastRet) & (elements.length - 1)];
+        }
+
+        public void remove() {
+            if(lastRet < 0)
+                throw new IllegalStateException();
+            delete(lastRet);
+            cursor = lastRet;
+            lastRet = -1;
+        }
+    }
+}
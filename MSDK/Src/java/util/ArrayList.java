@@ -0,0 +1,214 @@
+package java.util;
+
+public class ArrayList<E> implements List<E> {
+    private static final int DEFAULT_CAPACITY = 10;
+
+    private Object[] elementData;
+    private int size;
+
+    public ArrayList() {
+        elementData = new Object[DEFAULT_CAPACITY];
+    }
+
+    public ArrayList(int initialCapacity) {
+        if(initialCapacity < 0)
+            throw new IllegalArgumentException("Illegal Capacity: " + initialCapacity);
+        elementData = new Object[initialCapacity];
+    }
+
+    public ArrayList(Collection<? extends E> c) {
+        elementData = new Object[Math.max(c.size(), DEFAULT_CAPACITY)];
+        addAll(c);
+    }
+
+    private void checkIndex(int index, int length) {
+        if(index < 0 || index >= length)
+            throw new IndexOutOfBoundsException("Index " + index + " out of bounds for length " + length);
+    }
+
+    private void grow(int minCapacity) {
+        int oldCapacity = elementData.length;
+        int newCapacity = oldCapacity + (oldCapacity >> 1) + 1;
+        if(newCapacity < minCapacity)
+            newCapacity = minCapacity;
+        elementData = Arrays.copyOf(elementData, newCapacity);
+    }
+
+    public void ensureCapacity(int minCapacity) {
+        if(minCapacity > elementData.length)
+            grow(minCapacity);
+    }
+
+    public void trimToSize() {
+        if(size < elementData.length)
+            elementData = Arrays.copyOf(elementData, size);
+    }
+
+    public int size() {
+        return size;
+    }
+
+    public boolean isEmpty() {
+        return size == 0;
+    }
+
+    public boolean contains(Object o) {
+        return indexOf(o) >= 0;
+    }
+
+    public int indexOf(Object o) {
+        Object[] es = elementData;
+        if(o == null) {
+            for(int i = 0; i < size; i++) {
+                if(es[i] == null)
+                    return i;
+            }
+        }
+        else {
+            for(int i = 0; i < size; i++) {
+                if(o.equals(es[i]))
+                    return i;
+            }
+        }
+        return -1;
+    }
+
+    public int lastIndexOf(Object o) {
+        Object[] es = elementData;
+        if(o == null) {
+            for(int i = size - 1; i >= 0; i--) {
+                if(es[i] == null)
+                    return i;
+            }
+        }
+        else {
+            for(int i = size - 1; i >= 0; i--) {
+                if(o.equals(es[i]))
+                    return i;
+            }
+        }
+        return -1;
+    }
+
+    @SuppressWarnings("unchecked")
+    public E get(int index) {
+        checkIndex(index, size);
+        return (E)elementData[index];
+    }
+
+    @SuppressWarnings("unchecked")
+    public E set(int index, E element) {
+        checkIndex(index, size);
+        E oldValue = (E)elementData[index];
+        elementData[index] = element;
+        return oldValue;
+    }
+
+    public boolean add(E e) {
+        if(size == elementData.length)
+            grow(size + 1);
+        elementData[size++] = e;
+        return true;
+    }
+
+    public void add(int index, E element) {
+        checkIndex(index, size + 1);
+        if(size == elementData.length)
+            grow(size + 1);
+        System.arraycopy(elementData, index, elementData, index + 1, size - index);
+        elementData[index] = element;
+        size++;
+    }
+
+    public boolean addAll(Collection<? extends E> c) {
+        int count = c.size();
+        if(count == 0)
+            return false;
+        if(size + count > elementData.length)
+            grow(size + count);
+        if(c instanceof ArrayList) {
+            System.arraycopy(((ArrayList<?>)c).elementData, 0, elementData, size, count);
+            size += count;
+        }
+        else {
+            for(Iterator<? extends E> it = c.iterator(); it.hasNext();)
+                elementData[size++] = it.next();
+        }
+        return true;
+    }
+
+    @SuppressWarnings("unchecked")
+    public E remove(int index) {
+        checkIndex(index, size);
+        E oldValue = (E)elementData[index];
+        fastRemove(index);
+        return oldValue;
+    }
+
+    public boolean remove(Object o) {
+        int index = indexOf(o);
+        if(index < 0)
+            return false;
+        fastRemove(index);
+        return true;
+    }
+
+    private void fastRemove(int index) {
+        int newSize = size - 1;
+        if(newSize > index)
+            System.arraycopy(elementData, index + 1, elementData, index, newSize - index);
+        elementData[size = newSize] = null;
+    }
+
+    public void clear() {
+        Object[] es = elementData;
+        for(int i = 0; i < size; i++)
+            es[i] = null;
+        size = 0;
+    }
+
+    public Object[] toArray() {
+        return Arrays.copyOf(elementData, size);
+    }
+
+    public Iterator<E> iterator() {
+        return new Itr();
+    }
+
+    public String toString() {
+        StringBuilder sb = new StringBuilder();
+        sb.append('[');
+        for(int i = 0; i < size; i++) {
+            if(i > 0)
+                sb.append(", ");
+            sb.append(String.valueOf(elementData[i]));
+        }
+        sb.append(']');
+        return sb.toString();
+    }
+
+    private class Itr implements Iterator<E> {
+        private int cursor;
+        private int lastRet = -1;
+
+        public boolean hasNext() {
+            return cursor < size;
+        }
+
+        @SuppressWarnings("unchecked")
+        public E next() {
+            if(cursor >= size)
+                throw new NoSuchElementException();
+            lastRet = cursor++;
+            return (E)elementData[lastRet];
+        }
+
+        public void remove() {
+            if(lastRet < 0)
+                throw new IllegalStateException();
+            fastRemove(lastRet);
+            cursor = lastRet;
+            lastRet = -1;
+        }
+    }
+}
@@ -0,0 +1,412 @@
+package java.util;
+
+public class Arrays {
+    private Arrays() {
+
+    }
+
+    static void rangeCheck(int arrayLength, int fromIndex, int toIndex) {
+        if(fromIndex > toIndex)
+            throw new IllegalArgumentException("fromIndex(" + fromIndex + ") > toIndex(" + toIndex + ")");
+        if(fromIndex < 0)
+            throw new ArrayIndexOutOfBoundsException(fromIndex);
+        if(toIndex > arrayLength)
+            throw new ArrayIndexOutOfBoundsException(toIndex);
+    }
+
+    private static void copyRangeCheck(int arrayLength, int from, int to) {
+        if(from > to)
+            throw new IllegalArgumentException(from + " > " + to);
+        if(from < 0 || from > arrayLength)
+            throw new ArrayIndexOutOfBoundsException(from);
+    }
+
+    private static void newLengthCheck(int newLength) {
+        if(newLength < 0)
+            throw new NegativeArraySizeException(Integer.toString(newLength));
+    }
+
+    private static native void sortRange(long[] a, int fromIndex, int toIndex);
+
+    public static void sort(long[] a) {
+        sortRange(a, 0, a.length);
+    }
+
+    public static void sort(long[] a, int fromIndex, int toIndex) {
+        rangeCheck(a.length, fromIndex, toIndex);
+        sortRange(a, fromIndex, toIndex);
+    }
+
+    private static native void sortRange(int[] a, int fromIndex, int toIndex);
+
+    public static void sort(int[] a) {
+        sortRange(a, 0, a.length);
+    }
+
+    public static void sort(int[] a, int fromIndex, int toIndex) {
+        rangeCheck(a.length, fromIndex, toIndex);
+        sortRange(a, fromIndex, toIndex);
+    }
+
+    private static native void sortRange(short[] a, int fromIndex, int toIndex);
+
+    public static void sort(short[] a) {
+        sortRange(a, 0, a.length);
+    }
+
+    public static void sort(short[] a, int fromIndex, int toIndex) {
+        rangeCheck(a.length, fromIndex, toIndex);
+        sortRange(a, fromIndex, toIndex);
+    }
+
+    private static native void sortRange(char[] a, int fromIndex, int toIndex);
+
+    public static void sort(char[] a) {
+        sortRange(a, 0, a.length);
+    }
+
+    public static void sort(char[] a, int fromIndex, int toIndex) {
+        rangeCheck(a.length, fromIndex, toIndex);
+        sortRange(a, fromIndex, toIndex);
+    }
+
+    private static native void sortRange(byte[] a, int fromIndex, int toIndex);
+
+    public static void sort(byte[] a) {
+        sortRange(a, 0, a.length);
+    }
+
+    public static void sort(byte[] a, int fromIndex, int toIndex) {
+        rangeCheck(a.length, fromIndex, toIndex);
+        sortRange(a, fromIndex, toIndex);
+    }
+
+    private static native void sortRange(float[] a, int fromIndex, int toIndex);
+
+    public static void sort(float[] a) {
+        sortRange(a, 0, a.length);
+    }
+
+    public static void sort(float[] a, int fromIndex, int toIndex) {
+        rangeCheck(a.length, fromIndex, toIndex);
+        sortRange(a, fromIndex, toIndex);
+    }
+
+    private static native void sortRange(double[] a, int fromIndex, int toIndex);
+
+    public static void sort(double[] a) {
+        sortRange(a, 0, a.length);
+    }
+
+    public static void sort(double[] a, int fromIndex, int toIndex) {
+        rangeCheck(a.length, fromIndex, toIndex);
+        sortRange(a, fromIndex, toIndex);
+    }
+
+    private static native int binarySearchRange(long[] a, int fromIndex, int toIndex, long key);
+
+    public static int binarySearch(long[] a, long key) {
+        return binarySearchRange(a, 0, a.length, key);
+    }
+
+    public static int binarySearch(long[] a, int fromIndex, int toIndex, long key) {
+        rangeCheck(a.length, fromIndex, toIndex);
+        return binarySearchRange(a, fromIndex, toIndex, key);
+    }
+
+    private static native int binarySearchRange(int[] a, int fromIndex, int toIndex, int key);
+
+    public static int binarySearch(int[] a, int key) {
+        return binarySearchRange(a, 0, a.length, key);
+    }
+
+    public static int binarySearch(int[] a, int fromIndex, int toIndex, int key) {
+        rangeCheck(a.length, fromIndex, toIndex);
+        return binarySearchRange(a, fromIndex, toIndex, key);
+    }
+
+    private static native int binarySearchRange(short[] a, int fromIndex, int toIndex, short key);
+
+    public static int binarySearch(short[] a, short key) {
+        return binarySearchRange(a, 0, a.length, key);
+    }
+
+    public static int binarySearch(short[] a, int fromIndex, int toIndex, short key) {
+        rangeCheck(a.length, fromIndex, toIndex);
+        return binarySearchRange(a, fromIndex, toIndex, key);
+    }
+
+    private static native int binarySearchRange(char[] a, int fromIndex, int toIndex, char key);
+
+    public static int binarySearch(char[] a, char key) {
+        return binarySearchRange(a, 0, a.length, key);
+    }
+
+    public static int binarySearch(char[] a, int fromIndex, int toIndex, char key) {
+        rangeCheck(a.length, fromIndex, toIndex);
+        return binarySearchRange(a, fromIndex, toIndex, key);
+    }
+
+    private static native int binarySearchRange(byte[] a, int fromIndex, int toIndex, byte key);
+
+    public static int binarySearch(byte[] a, byte key) {
+        return binarySearchRange(a, 0, a.length, key);
+    }
+
+    public static int binarySearch(byte[] a, int fromIndex, int toIndex, byte key) {
+        rangeCheck(a.length, fromIndex, toIndex);
+        return binarySearchRange(a, fromIndex, toIndex, key);
+    }
+
+    private static native int binarySearchRange(float[] a, int fromIndex, int toIndex, float key);
+
+    public static int binarySearch(float[] a, float key) {
+        return binarySearchRange(a, 0, a.length, key);
+    }
+
+    public static int binarySearch(float[] a, int fromIndex, int toIndex, float key) {
+        rangeCheck(a.length, fromIndex, toIndex);
+        return binarySearchRange(a, fromIndex, toIndex, key);
+    }
+
+    private static native int binarySearchRange(double[] a, int fromIndex, int toIndex, double key);
+
+    public static int binarySearch(double[] a, double key) {
+        return binarySearchRange(a, 0, a.length, key);
+    }
+
+    public static int binarySearch(double[] a, int fromIndex, int toIndex, double key) {
+        rangeCheck(a.length, fromIndex, toIndex);
+        return binarySearchRange(a, fromIndex, toIndex, key);
+    }
+
+    public static native boolean equals(long[] a, long[] a2);
+
+    public static native boolean equals(int[] a, int[] a2);
+
+    public static native boolean equals(short[] a, short[] a2);
+
+    public static native boolean equals(char[] a, char[] a2);
+
+    public static native boolean equals(byte[] a, byte[] a2);
+
+    public static native boolean equals(boolean[] a, boolean[] a2);
+
+    public static native boolean equals(float[] a, float[] a2);
+
+    public static native boolean equals(double[] a, double[] a2);
+
+    private static native void fillRange(long[] a, int fromIndex, int toIndex, long val);
+
+    public static void fill(long[] a, long val) {
+        fillRange(a, 0, a.length, val);
+    }
+
+    public static void fill(long[] a, int fromIndex, int toIndex, long val) {
+        rangeCheck(a.length, fromIndex, toIndex);
+        fillRange(a, fromIndex, toIndex, val);
+    }
+
+    private static native void fillRange(int[] a, int fromIndex, int toIndex, int val);
+
+    public static void fill(int[] a, int val) {
+        fillRange(a, 0, a.length, val);
+    }
+
+    public static void fill(int[] a, int fromIndex, int toIndex, int val) {
+        rangeCheck(a.length, fromIndex, toIndex);
+        fillRange(a, fromIndex, toIndex, val);
+    }
+
+    private static native void fillRange(short[] a, int fromIndex, int toIndex, short val);
+
+    public static void fill(short[] a, short val) {
+        fillRange(a, 0, a.length, val);
+    }
+
+    public static void fill(short[] a, int fromIndex, int toIndex, short val) {
+        rangeCheck(a.length, fromIndex, toIndex);
+        fillRange(a, fromIndex, toIndex, val);
+    }
+
+    private static native void fillRange(char[] a, int fromIndex, int toIndex, char val);
+
+    public static void fill(char[] a, char val) {
+        fillRange(a, 0, a.length, val);
+    }
+
+    public static void fill(char[] a, int fromIndex, int toIndex, char val) {
+        rangeCheck(a.length, fromIndex, toIndex);
+        fillRange(a, fromIndex, toIndex, val);
+    }
+
+    private static native void fillRange(byte[] a, int fromIndex, int toIndex, byte val);
+
+    public static void fill(byte[] a, byte val) {
+        fillRange(a, 0, a.length, val);
+    }
+
+    public static void fill(byte[] a, int fromIndex, int toIndex, byte val) {
+        rangeCheck(a.length, fromIndex, toIndex);
+        fillRange(a, fromIndex, toIndex, val);
+    }
+
+    private static native void fillRange(boolean[] a, int fromIndex, int toIndex, boolean val);
+
+    public static void fill(boolean[] a, boolean val) {
+        fillRange(a, 0, a.length, val);
+    }
+
+    public static void fill(boolean[] a, int fromIndex, int toIndex, boolean val) {
+        rangeCheck(a.length, fromIndex, toIndex);
+        fillRange(a, fromIndex, toIndex, val);
+    }
+
+    private static native void fillRange(float[] a, int fromIndex, int toIndex, float val);
+
+    public static void fill(float[] a, float val) {
+        fillRange(a, 0, a.length, val);
+    }
+
+    public static void fill(float[] a, int fromIndex, int toIndex, float val) {
+        rangeCheck(a.length, fromIndex, toIndex);
+        fillRange(a, fromIndex, toIndex, val);
+    }
+
+    private static native void fillRange(double[] a, int fromIndex, int toIndex, double val);
+
+    public static void fill(double[] a, double val) {
+        fillRange(a, 0, a.length, val);
+    }
+
+    public static void fill(double[] a, int fromIndex, int toIndex, double val) {
+        rangeCheck(a.length, fromIndex, toIndex);
+        fillRange(a, fromIndex, toIndex, val);
+    }
+
+    private static native long[] copyRange(long[] original, int from, int to);
+
+    public static long[] copyOf(long[] original, int newLength) {
+        newLengthCheck(newLength);
+        return copyRange(original, 0, newLength);
+    }
+
+    public static long[] copyOfRange(long[] original, int from, int to) {
+        copyRangeCheck(original.length, from, to);
+        return copyRange(original, from, to);
+    }
+
+    private static native int[] copyRange(int[] original, int from, int to);
+
+    public static int[] copyOf(int[] original, int newLength) {
+        newLengthCheck(newLength);
+        return copyRange(original, 0, newLength);
+    }
+
+    public static int[] copyOfRange(int[] original, int from, int to) {
+        copyRangeCheck(original.length, from, to);
+        return copyRange(original, from, to);
+    }
+
+    private static native short[] copyRange(short[] original, int from, int to);
+
+    public static short[] copyOf(short[] original, int newLength) {
+        newLengthCheck(newLength);
+        return copyRange(original, 0, newLength);
+    }
+
+    public static short[] copyOfRange(short[] original, int from, int to) {
+        copyRangeCheck(original.length, from, to);
+        return copyRange(original, from, to);
+    }
+
+    private static native char[] copyRange(char[] original, int from, int to);
+
+    public static char[] copyOf(char[] original, int newLength) {
+        newLengthCheck(newLength);
+        return copyRange(original, 0, newLength);
+    }
+
+    public static char[] copyOfRange(char[] original, int from, int to) {
+        copyRangeCheck(original.length, from, to);
+        return copyRange(original, from, to);
+    }
+
+    private static native byte[] copyRange(byte[] original, int from, int to);
+
+    public static byte[] copyOf(byte[] original, int newLength) {
+        newLengthCheck(newLength);
+        return copyRange(original, 0, newLength);
+    }
+
+    public static byte[] copyOfRange(byte[] original, int from, int to) {
+        copyRangeCheck(original.length, from, to);
+        return copyRange(original, from, to);
+    }
+
+    private static native boolean[] copyRange(boolean[] original, int from, int to);
+
+    public static boolean[] copyOf(boolean[] original, int newLength) {
+        newLengthCheck(newLength);
+        return copyRange(original, 0, newLength);
+    }
+
+    public static boolean[] copyOfRange(boolean[] original, int from, int to) {
+        copyRangeCheck(original.length, from, to);
+        return copyRange(original, from, to);
+    }
+
+    private static native float[] copyRange(float[] original, int from, int to);
+
+    public static float[] copyOf(float[] original, int newLength) {
+        newLengthCheck(newLength);
+        return copyRange(original, 0, newLength);
+    }
+
+    public static float[] copyOfRange(float[] original, int from, int to) {
+        copyRangeCheck(original.length, from, to);
+        return copyRange(original, from, to);
+    }
+
+    private static native double[] copyRange(double[] original, int from, int to);
+
+    public static double[] copyOf(double[] original, int newLength) {
+        newLengthCheck(newLength);
+        return copyRange(original, 0, newLength);
+    }
+
+    public static double[] copyOfRange(double[] original, int from, int to) {
+        copyRangeCheck(original.length, from, to);
+        return copyRange(original, from, to);
+    }
+
+    private static native Object[] copyRange(Object[] original, int from, int to);
+
+    @SuppressWarnings("unchecked")
+    public static <T> T[] copyOf(T[] original, int newLength) {
+        newLengthCheck(newLength);
+        return (T[])copyRange(original, 0, newLength);
+    }
+
+    @SuppressWarnings("unchecked")
+    public static <T> T[] copyOfRange(T[] original, int from, int to) {
+        copyRangeCheck(original.length, from, to);
+        return (T[])copyRange(original, from, to);
+    }
+
+    public static native int hashCode(long[] a);
+
+    public static native int hashCode(int[] a);
+
+    public static native int hashCode(short[] a);
+
+    public static native int hashCode(char[] a);
+
+    public static native int hashCode(byte[] a);
+
+    public static native int hashCode(boolean[] a);
+
+    public static native int hashCode(float[] a);
+
+    public static native int hashCode(double[] a);
+}
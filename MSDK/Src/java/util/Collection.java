@@ -0,0 +1,15 @@
+package java.util;
+
+public interface Collection<E> extends Iterable<E> {
+    public abstract int size();
+
+    public abstract boolean isEmpty();
+
+    public abstract boolean contains(Object o);
+
+    public abstract boolean add(E e);
+
+    public abstract boolean remove(Object o);
+
+    public abstract void clear();
+}
@@ -0,0 +1,384 @@
+package java.util;
+
+/*
+ * Open addressing with linear probing. Each slot keeps the spread hash of its key, 0 marks an empty slot.
+ * The probe, the resize and the removal run as natives over the hash array.
+ */
+public class HashMap<K, V> implements Map<K, V> {
+    private static final int DEFAULT_CAPACITY = 16;
+    /* from 4 slots up, the threshold always leaves at least one slot empty to stop the probe */
+    private static final int MIN_CAPACITY = 4;
+
+    private static final int KEYS = 0;
+    private static final int VALUES = 1;
+    private static final int ENTRIES = 2;
+
+    private int[] hashes;
+    private Object[] keys;
+    private Object[] values;
+    private int size;
+    private int threshold;
+
+    public HashMap() {
+        allocate(DEFAULT_CAPACITY);
+    }
+
+    public HashMap(int initialCapacity) {
+        if(initialCapacity < 0)
+            throw new IllegalArgumentException("Illegal initial capacity: " + initialCapacity);
+        int capacity = MIN_CAPACITY;
+        while((capacity - (capacity >> 2)) < initialCapacity)
+            capacity <<= 1;
+        allocate(capacity);
+    }
+
+    public HashMap(Map<? extends K, ? extends V> m) {
+        this(m.size());
+        putAll(m);
+    }
+
+    private static native int probe(int[] hashes, int hash, int index);
+
+    private static native void rehash(int[] hashes, Object[] keys, Object[] values, int[] newHashes, Object[] newKeys, Object[] newValues);
+
+    private static native void removeAt(int[] hashes, Object[] keys, Object[] values, int index);
+
+    static int hash(Object key) {
+        int h = (key == null) ? 0 : key.hashCode();
+        h ^= (h >>> 16);
+        return (h == 0) ? 1 : h;
+    }
+
+    private void allocate(int capacity) {
+        hashes = new int[capacity];
+        keys = new Object[capacity];
+        values = new Object[capacity];
+        /* the load factor is 0.75 and the capacity is at least MIN_CAPACITY, so there is always an empty slot */
+        threshold = capacity - (capacity >> 2);
+    }
+
+    private void resize() {
+        int[] oldHashes = hashes;
+        Object[] oldKeys = keys;
+        Object[] oldValues = values;
+        allocate(oldHashes.length << 1);
+        rehash(oldHashes, oldKeys, oldValues, hashes, keys, values);
+    }
+
+    private int indexOf(Object key, int hash) {
+        int[] hs = hashes;
+        int mask = hs.length - 1;
+        int index = probe(hs, hash, hash & mask);
+        while(hs[index] != 0) {
+            Object k = keys[index];
+            if(k == key || (key != null && key.equals(k)))
+                return index;
+            index = probe(hs, hash, (index + 1) & mask);
+        }
+        return -(index + 1);
+    }
+
+    public int size() {
+        return size;
+    }
+
+    public boolean isEmpty() {
+        return size == 0;
+    }
+
+    public boolean containsKey(Object key) {
+        return indexOf(key, hash(key)) >= 0;
+    }
+
+    public boolean containsValue(Object value) {
+        int[] hs = hashes;
+        Object[] vs = values;
+        for(int i = 0; i < hs.length; i++) {
+            if(hs[i] != 0) {
+                Object v = vs[i];
+                if(v == value || (value != null && value.equals(v)))
+                    return true;
+            }
+        }
+        return false;
+    }
+
+    @SuppressWarnings("unchecked")
+    public V get(Object key) {
+        int index = indexOf(key, hash(key));
+        return (index >= 0) ? (V)values[index] : null;
+    }
+
+    @SuppressWarnings("unchecked")
+    public V getOrDefault(Object key, V defaultValue) {
+        int index = indexOf(key, hash(key));
+        return (index >= 0) ? (V)values[index] : defaultValue;
+    }
+
+    @SuppressWarnings("unchecked")
+    public V put(K key, V value) {
+        int hash = hash(key);
+        int index = indexOf(key, hash);
+        if(index >= 0) {
+            V oldValue = (V)values[index];
+            values[index] = value;
+            return oldValue;
+        }
+        index = -(index + 1);
+        hashes[index] = hash;
+        keys[index] = key;
+        values[index] = value;
+        if(++size > threshold)
+            resize();
+        return null;
+    }
+
+    public void putAll(Map<? extends K, ? extends V> m) {
+        for(Iterator<? extends Map.Entry<? extends K, ? extends V>> it = m.entrySet().iterator(); it.hasNext();) {
+            Map.Entry<? extends K, ? extends V> e = it.next();
+            put(e.getKey(), e.getValue());
+        }
+    }
+
+    @SuppressWarnings("unchecked")
+    public V remove(Object key) {
+        int index = indexOf(key, hash(key));
+        if(index < 0)
+            return null;
+        V oldValue = (V)values[index];
+        removeAt(hashes, keys, values, index);
+        size--;
+        return oldValue;
+    }
+
+    public void clear() {
+        if(size > 0) {
+            allocate(hashes.length);
+            size = 0;
+        }
+    }
+
+    public Set<K> keySet() {
+        return new KeySet();
+    }
+
+    public Collection<V> values() {
+        return new Values();
+    }
+
+    public Set<Map.Entry<K, V>> entrySet() {
+        return new EntrySet();
+    }
+
+    public String toString() {
+        StringBuilder sb = new StringBuilder();
+        sb.append('{');
+        boolean isFirst = true;
+        for(int i = 0; i < hashes.length; i++) {
+            if(hashes[i] != 0) {
+                if(!isFirst)
+                    sb.append(", ");
+                sb.append(String.valueOf(keys[i]));
+                sb.append('=');
+                sb.append(String.valueOf(values[i]));
+                isFirst = false;
+            }
+        }
+        sb.append('}');
+        return sb.toString();
+    }
+
+    private final class Node implements Map.Entry<K, V> {
+        private final K key;
+        private V value;
+
+        Node(K key, V value) {
+            this.key = key;
+            this.value = value;
+        }
+
+        public K getKey() {
+            return key;
+        }
+
+        public V getValue() {
+            return value;
+        }
+
+        public V setValue(V value) {
+            V oldValue = this.value;
+            this.value = value;
+            put(key, value);
+            return oldValue;
+        }
+
+        public String toString() {
+            return key + "=" + value;
+        }
+    }
+
+    /*
+     * The iteration starts from an empty slot, so no cluster wraps around its start.
+     * A removal only shifts the entries that come later back into the removed slot, none of them is skipped or seen twice.
+     */
+    private final class HashIterator<T> implements Iterator<T> {
+        private final int type;
+        private int index;
+        private int remaining;
+        private int lastIndex = -1;
+
+        HashIterator(int type) {
+            this.type = type;
+            index = probe(hashes, 0, 0);
+            remaining = hashes.length;
+        }
+
+        public boolean hasNext() {
+            int[] hs = hashes;
+            int mask = hs.length - 1;
+            while(remaining > 0 && hs[index] == 0) {
+                index = (index + 1) & mask;
+                remaining--;
+            }
+            return remaining > 0;
+        }
+
+        @SuppressWarnings("unchecked")
+        public T next() {
+            if(!hasNext())
+                throw new NoSuchElementException();
+            lastIndex = index;
+            index = (index + 1) & (hashes.length - 1);
+            remaining--;
+            if(type == KEYS)
+                return (T)keys[lastIndex];
+            else if(type == VALUES)
+                return (T)values[lastIndex];
+            return (T)new Node((K)keys[lastIndex], (V)values[lastIndex]);
+        }
+
+        public void remove() {
+            if(lastIndex < 0)
+                throw new IllegalStateException();
+            removeAt(hashes, keys, values, lastIndex);
+            size--;
+            if(hashes[lastIndex] != 0) {
+                index = lastIndex;
+                remaining++;
+            }
+            lastIndex = -1;
+        }
+    }
+
+    private final class KeySet implements Set<K> {
+        public int size() {
+            return size;
+        }
+
+        public boolean isEmpty() {
+            return size == 0;
+        }
+
+        public boolean contains(Object o) {
+            return containsKey(o);
+        }
+
+        public boolean add(K e) {
+            throw new UnsupportedOperationException();
+        }
+
+        public boolean remove(Object o) {
+            int index = indexOf(o, hash(o));
+            if(index < 0)
+                return false;
+            removeAt(hashes, keys, values, index);
+            size--;
+            return true;
+        }
+
+        public void clear() {
+            HashMap.this.clear();
+        }
+
+        public Iterator<K> iterator() {
+            return new HashIterator<K>(KEYS);
+        }
+    }
+
+    private final class Values implements Collection<V> {
+        public int size() {
+            return size;
+        }
+
+        public boolean isEmpty() {
+            return size == 0;
+        }
+
+        public boolean contains(Object o) {
+            return containsValue(o);
+        }
+
+        public boolean add(V e) {
+            throw new UnsupportedOperationException();
+        }
+
+        public boolean remove(Object o) {
+            for(Iterator<V> it = iterator(); it.hasNext();) {
+                V v = it.next();
+                if(v == o || (o != null && o.equals(v))) {
+                    it.remove();
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        public void clear() {
+            HashMap.this.clear();
+        }
+
+        public Iterator<V> iterator() {
+            return new HashIterator<V>(VALUES);
+        }
+    }
+
+    private final class EntrySet implements Set<Map.Entry<K, V>> {
+        public int size() {
+            return size;
+        }
+
+        public boolean isEmpty() {
+            return size == 0;
+        }
+
+        public boolean contains(Object o) {
+            if(!(o instanceof Map.Entry))
+                return false;
+            Map.Entry<?, ?> e = (Map.Entry<?, ?>)o;
+            int index = indexOf(e.getKey(), hash(e.getKey()));
+            if(index < 0)
+                return false;
+            Object v = values[index];
+            return v == e.getValue() || (v != null && v.equals(e.getValue()));
+        }
+
+        public boolean add(Map.Entry<K, V> e) {
+            throw new UnsupportedOperationException();
+        }
+
+        public boolean remove(Object o) {
+            if(!contains(o))
+                return false;
+            HashMap.this.remove(((Map.Entry<?, ?>)o).getKey());
+            return true;
+        }
+
+        public void clear() {
+            HashMap.this.clear();
+        }
+
+        public Iterator<Map.Entry<K, V>> iterator() {
+            return new HashIterator<Map.Entry<K, V>>(ENTRIES);
+        }
+    }
+}
@@ -0,0 +1,69 @@
+package java.util;
+
+public class HashSet<E> implements Set<E> {
+    private static final Object PRESENT = new Object();
+
+    private final HashMap<E, Object> map;
+
+    public HashSet() {
+        map = new HashMap<>();
+    }
+
+    public HashSet(int initialCapacity) {
+        map = new HashMap<>(initialCapacity);
+    }
+
+    public HashSet(Collection<? extends E> c) {
+        map = new HashMap<>(c.size());
+        addAll(c);
+    }
+
+    public int size() {
+        return map.size();
+    }
+
+    public boolean isEmpty() {
+        return map.isEmpty();
+    }
+
+    public boolean contains(Object o) {
+        return map.containsKey(o);
+    }
+
+    public boolean add(E e) {
+        return map.put(e, PRESENT) == null;
+    }
+
+    public boolean addAll(Collection<? extends E> c) {
+        boolean isModified = false;
+        for(Iterator<? extends E> it = c.iterator(); it.hasNext();) {
+            if(add(it.next()))
+                isModified = true;
+        }
+        return isModified;
+    }
+
+    public boolean remove(Object o) {
+        return map.remove(o) == PRESENT;
+    }
+
+    public void clear() {
+        map.clear();
+    }
+
+    public Iterator<E> iterator() {
+        return map.keySet().iterator();
+    }
+
+    public String toString() {
+        StringBuilder sb = new StringBuilder();
+        sb.append('[');
+        for(Iterator<E> it = iterator(); it.hasNext();) {
+            sb.append(String.valueOf(it.next()));
+            if(it.hasNext())
+                sb.append(", ");
+        }
+        sb.append(']');
+        return sb.toString();
+    }
+}
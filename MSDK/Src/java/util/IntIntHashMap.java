@@ -0,0 +1,161 @@
+package java.util;
+
+/*
+ * A map from int to int that keeps the keys and the values in int arrays, so no Integer is allocated.
+ * Key 0 marks an empty slot in the table, the entry of key 0 is kept in its own fields.
+ */
+public class IntIntHashMap {
+    private static final int DEFAULT_CAPACITY = 16;
+    /* from 4 slots up, the threshold always leaves at least one slot empty to stop the probe */
+    private static final int MIN_CAPACITY = 4;
+
+    private int[] keys;
+    private int[] values;
+    private int size;
+    private int threshold;
+    private boolean hasZeroKey;
+    private int zeroValue;
+
+    public IntIntHashMap() {
+        allocate(DEFAULT_CAPACITY);
+    }
+
+    public IntIntHashMap(int initialCapacity) {
+        if(initialCapacity < 0)
+            throw new IllegalArgumentException("Illegal initial capacity: " + initialCapacity);
+        int capacity = MIN_CAPACITY;
+        while((capacity - (capacity >> 2)) < initialCapacity)
+            capacity <<= 1;
+        allocate(capacity);
+    }
+
+    private static native int indexOf(int[] keys, int key);
+
+    private static native int get(int[] keys, int[] values, int key, int defaultValue);
+
+    private static native void rehash(int[] keys, int[] values, int[] newKeys, int[] newValues);
+
+    private static native void removeAt(int[] keys, int[] values, int index);
+
+    private void allocate(int capacity) {
+        keys = new int[capacity];
+        values = new int[capacity];
+        threshold = capacity - (capacity >> 2);
+    }
+
+    public int size() {
+        return hasZeroKey ? (size + 1) : size;
+    }
+
+    public boolean isEmpty() {
+        return size() == 0;
+    }
+
+    public boolean containsKey(int key) {
+        if(key == 0)
+            return hasZeroKey;
+        return indexOf(keys, key) >= 0;
+    }
+
+    public int get(int key) {
+        return getOrDefault(key, 0);
+    }
+
+    public int getOrDefault(int key, int defaultValue) {
+        if(key == 0)
+            return hasZeroKey ? zeroValue : defaultValue;
+        return get(keys, values, key, defaultValue);
+    }
+
+    public int put(int key, int value) {
+        int oldValue;
+        if(key == 0) {
+            oldValue = hasZeroKey ? zeroValue : 0;
+            hasZeroKey = true;
+            zeroValue = value;
+            return oldValue;
+        }
+        int index = indexOf(keys, key);
+        if(index >= 0) {
+            oldValue = values[index];
+            values[index] = value;
+            return oldValue;
+        }
+        index = -(index + 1);
+        keys[index] = key;
+        values[index] = value;
+        if(++size > threshold) {
+            int[] oldKeys = keys;
+            int[] oldValues = values;
+            allocate(oldKeys.length << 1);
+            rehash(oldKeys, oldValues, keys, values);
+        }
+        return 0;
+    }
+
+    public int addTo(int key, int increment) {
+        int value = getOrDefault(key, 0) + increment;
+        put(key, value);
+        return value;
+    }
+
+    public int remove(int key) {
+        int oldValue;
+        if(key == 0) {
+            oldValue = hasZeroKey ? zeroValue : 0;
+            hasZeroKey = false;
+            zeroValue = 0;
+            return oldValue;
+        }
+        int index = indexOf(keys, key);
+        if(index < 0)
+            return 0;
+        oldValue = values[index];
+        removeAt(keys, values, index);
+        size--;
+        return oldValue;
+    }
+
+    public void clear() {
+        if(size > 0)
+            allocate(keys.length);
+        size = 0;
+        hasZeroKey = false;
+        zeroValue = 0;
+    }
+
+    public int[] keys() {
+        int[] ret = new int[size()];
+        int count = 0;
+        if(hasZeroKey)
+            ret[count++] = 0;
+        for(int i = 0; i < keys.length; i++) {
+            if(keys[i] != 0)
+                ret[count++] = keys[i];
+        }
+        return ret;
+    }
+
+    public String toString() {
+        StringBuilder sb = new StringBuilder();
+        sb.append('{');
+        boolean isFirst = true;
+        if(hasZeroKey) {
+            sb.append("0=");
+            sb.append(zeroValue);
+            isFirst = false;
+        }
+        for(int i = 0; i < keys.length; i++) {
+            if(keys[i] != 0) {
+                if(!isFirst)
+                    sb.append(", ");
+                sb.append(keys[i]);
+                sb.append('=');
+                sb.append(values[i]);
+                isFirst = false;
+            }
+        }
+        sb.append('}');
+        return sb.toString();
+    }
+}
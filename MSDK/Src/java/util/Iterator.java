@@ -0,0 +1,9 @@
+package java.util;
+
+public interface Iterator<E> {
+    public abstract boolean hasNext();
+
+    public abstract E next();
+
+    public abstract void remove();
+}
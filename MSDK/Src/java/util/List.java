@@ -0,0 +1,15 @@
+package java.util;
+
+public interface List<E> extends Collection<E> {
+    public abstract E get(int index);
+
+    public abstract E set(int index, E element);
+
+    public abstract void add(int index, E element);
+
+    public abstract E remove(int index);
+
+    public abstract int indexOf(Object o);
+
+    public abstract int lastIndexOf(Object o);
+}
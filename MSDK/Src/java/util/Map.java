@@ -0,0 +1,35 @@
+package java.util;
+
+public interface Map<K, V> {
+    public interface Entry<K, V> {
+        public abstract K getKey();
+
+        public abstract V getValue();
+
+        public abstract V setValue(V value);
+    }
+
+    public abstract int size();
+
+    public abstract boolean isEmpty();
+
+    public abstract boolean containsKey(Object key);
+
+    public abstract boolean containsValue(Object value);
+
+    public abstract V get(Object key);
+
+    public abstract V getOrDefault(Object key, V defaultValue);
+
+    public abstract V put(K key, V value);
+
+    public abstract V remove(Object key);
+
+    public abstract void clear();
+
+    public abstract Set<K> keySet();
+
+    public abstract Collection<V> values();
+
+    public abstract Set<Map.Entry<K, V>> entrySet();
+}
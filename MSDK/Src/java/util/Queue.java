@@ -0,0 +1,13 @@
+package java.util;
+
+public interface Queue<E> extends Collection<E> {
+    public abstract boolean offer(E e);
+
+    public abstract E remove();
+
+    public abstract E poll();
+
+    public abstract E element();
+
+    public abstract E peek();
+}
@@ -0,0 +1,5 @@
+package java.util;
+
+public interface Set<E> extends Collection<E> {
+
+}
@@ -0,0 +1,5 @@
+package java.util.concurrent;
+
+public interface Executor {
+    public abstract void execute(Runnable command);
+}
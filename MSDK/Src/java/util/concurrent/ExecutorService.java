@@ -0,0 +1,11 @@
+package java.util.concurrent;
+
+public interface ExecutorService extends Executor {
+    public abstract void shutdown();
+
+    public abstract boolean isShutdown();
+
+    public abstract boolean isTerminated();
+
+    public abstract boolean awaitTermination(long timeoutMillis);
+}
@@ -0,0 +1,15 @@
+package java.util.concurrent;
+
+public class Executors {
+    private Executors() {
+
+    }
+
+    public static ExecutorService newFixedThreadPool(int nThreads) {
+        return new ForkJoinPool(nThreads, true);
+    }
+
+    public static ExecutorService newWorkStealingPool(int parallelism) {
+        return new ForkJoinPool(parallelism, true);
+    }
+}
@@ -0,0 +1,58 @@
+package java.util.concurrent;
+
+public class ForkJoinPool implements ExecutorService {
+    private static final int MAX_CAP = 0x7FFF;
+
+    private final int handle;
+    private final int parallelism;
+
+    public ForkJoinPool(int parallelism) {
+        this(parallelism, false);
+    }
+
+    public ForkJoinPool(int parallelism, boolean asyncMode) {
+        if(parallelism <= 0 || parallelism > MAX_CAP)
+            throw new IllegalArgumentException();
+        this.parallelism = parallelism;
+        this.handle = create(this, parallelism, asyncMode);
+    }
+
+    public int getParallelism() {
+        return parallelism;
+    }
+
+    public void execute(Runnable task) {
+        if(task == null)
+            throw new NullPointerException();
+        if(!submit(handle, task))
+            throw new RejectedExecutionException("Pool has been shut down");
+    }
+
+    public void shutdown() {
+        shutdown(handle);
+    }
+
+    public boolean isShutdown() {
+        return isShutdown(handle);
+    }
+
+    public boolean isTerminated() {
+        return isTerminated(handle);
+    }
+
+    public boolean awaitTermination(long timeoutMillis) {
+        return awaitTermination(handle, timeoutMillis);
+    }
+
+    private static native int create(ForkJoinPool pool, int parallelism, boolean asyncMode);
+
+    private static native boolean submit(int handle, Runnable task);
+
+    private static native void shutdown(int handle);
+
+    private static native boolean isShutdown(int handle);
+
+    private static native boolean isTerminated(int handle);
+
+    private static native boolean awaitTermination(int handle, long timeoutMillis);
+}
@@ -0,0 +1,11 @@
+package java.util.concurrent;
+
+public class RejectedExecutionException extends RuntimeException {
+    public RejectedExecutionException() {
+        super();
+    }
+
+    public RejectedExecutionException(String message) {
+        super(message);
+    }
+}
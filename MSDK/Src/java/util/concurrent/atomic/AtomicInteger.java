@@ -0,0 +1,79 @@
+package java.util.concurrent.atomic;
+
+public class AtomicInteger extends Number {
+    private volatile int value;
+
+    public AtomicInteger() {
+
+    }
+
+    public AtomicInteger(int initialValue) {
+        value = initialValue;
+    }
+
+    public final int get() {
+        return value;
+    }
+
+    public final void set(int newValue) {
+        value = newValue;
+    }
+
+    public final void lazySet(int newValue) {
+        value = newValue;
+    }
+
+    public final native int getAndSet(int newValue);
+
+    public final native boolean compareAndSet(int expectedValue, int newValue);
+
+    public final native int getAndAdd(int delta);
+
+    public final int getAndIncrement() {
+        return getAndAdd(1);
+    }
+
+    public final int getAndDecrement() {
+        return getAndAdd(-1);
+    }
+
+    public final int incrementAndGet() {
+        return getAndAdd(1) + 1;
+    }
+
+    public final int decrementAndGet() {
+        return getAndAdd(-1) - 1;
+    }
+
+    public final int addAndGet(int delta) {
+        return getAndAdd(delta) + delta;
+    }
+
+    public String toString() {
+        return Integer.toString(get());
+    }
+
+    public int intValue() {
+        return get();
+    }
+
+    public long longValue() {
+        return (long)get();
+    }
+
+    public float floatValue() {
+        return (float)get();
+    }
+
+    public double doubleValue() {
+        return (double)get();
+    }
+
+    public byte byteValue() {
+        return (byte)get();
+    }
+
+    public short shortValue() {
+        return (short)get();
+    }
+}
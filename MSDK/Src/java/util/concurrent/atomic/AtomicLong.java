@@ -0,0 +1,75 @@
+package java.util.concurrent.atomic;
+
+public class AtomicLong extends Number {
+    private volatile long value;
+
+    public AtomicLong() {
+
+    }
+
+    public AtomicLong(long initialValue) {
+        value = initialValue;
+    }
+
+    public final native long get();
+
+    public final native void set(long newValue);
+
+    public final void lazySet(long newValue) {
+        set(newValue);
+    }
+
+    public final native long getAndSet(long newValue);
+
+    public final native boolean compareAndSet(long expectedValue, long newValue);
+
+    public final native long getAndAdd(long delta);
+
+    public final long getAndIncrement() {
+        return getAndAdd(1L);
+    }
+
+    public final long getAndDecrement() {
+        return getAndAdd(-1L);
+    }
+
+    public final long incrementAndGet() {
+        return getAndAdd(1L) + 1L;
+    }
+
+    public final long decrementAndGet() {
+        return getAndAdd(-1L) - 1L;
+    }
+
+    public final long addAndGet(long delta) {
+        return getAndAdd(delta) + delta;
+    }
+
+    public String toString() {
+        return Long.toString(get());
+    }
+
+    public int intValue() {
+        return (int)get();
+    }
+
+    public long longValue() {
+        return get();
+    }
+
+    public float floatValue() {
+        return (float)get();
+    }
+
+    public double doubleValue() {
+        return (double)get();
+    }
+
+    public byte byteValue() {
+        return (byte)get();
+    }
+
+    public short shortValue() {
+        return (short)get();
+    }
+}
@@ -0,0 +1,33 @@
+package java.util.concurrent.atomic;
+
+public class AtomicReference<V> {
+    private volatile V value;
+
+    public AtomicReference() {
+
+    }
+
+    public AtomicReference(V initialValue) {
+        value = initialValue;
+    }
+
+    public final V get() {
+        return value;
+    }
+
+    public final void set(V newValue) {
+        value = newValue;
+    }
+
+    public final void lazySet(V newValue) {
+        value = newValue;
+    }
+
+    public final native V getAndSet(V newValue);
+
+    public final native boolean compareAndSet(V expectedValue, V newValue);
+
+    public String toString() {
+        return String.valueOf(get());
+    }
+}
@@ -0,0 +1,47 @@
+package jdk.internal.misc;
+
+public final class Unsafe {
+    private static final Unsafe theUnsafe = new Unsafe();
+
+    private Unsafe() {
+
+    }
+
+    public static Unsafe getUnsafe() {
+        return theUnsafe;
+    }
+
+    public native long objectFieldOffset(Class<?> c, String name);
+
+    public native int arrayBaseOffset(Class<?> arrayClass);
+
+    public native int arrayIndexScale(Class<?> arrayClass);
+
+    public final native boolean compareAndSetInt(Object o, long offset, int expected, int x);
+
+    public final native boolean compareAndSetLong(Object o, long offset, long expected, long x);
+
+    public final native boolean compareAndSetReference(Object o, long offset, Object expected, Object x);
+
+    public final native int getAndAddInt(Object o, long offset, int delta);
+
+    public final native long getAndAddLong(Object o, long offset, long delta);
+
+    public final native int getAndSetInt(Object o, long offset, int newValue);
+
+    public final native long getAndSetLong(Object o, long offset, long newValue);
+
+    public final native Object getAndSetReference(Object o, long offset, Object newValue);
+
+    public native int getIntVolatile(Object o, long offset);
+
+    public native void putIntVolatile(Object o, long offset, int x);
+
+    public native long getLongVolatile(Object o, long offset);
+
+    public native void putLongVolatile(Object o, long offset, long x);
+
+    public native Object getReferenceVolatile(Object o, long offset);
+
+    public native void putReferenceVolatile(Object o, long offset, Object x);
+}
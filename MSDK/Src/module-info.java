@@ -4,6 +4,9 @@ module java.base {
     exports java.lang;
     exports java.math;
     exports java.util;
+    exports java.util.concurrent;
+    exports java.util.concurrent.atomic;
+    exports jdk.internal.misc;
     exports jdk.internal.math;
     exports java.lang.annotation;
 }
@@ -0,0 +1,327 @@
+#!/usr/bin/env python3
+"""
+Build a pre-parsed MJVM class archive from a set of class files.
+
+Usage:
+    mjvm_class_archive.py -o app.mca <class files or directories>...
+
+The archive is loaded at runtime with Mjvm::openClassArchive(). Its layout
+matches MJVM/VM/Inc/mjvm_class_archive.h:
+
+    header | hash buckets | utf8 table | class records
+
+UTF-8 constants are stored once for the whole archive in the MjvmConstUtf8
+layout (length, crc, text, NUL). Constant pools are stored decoded in the
+MjvmConstPool layout, and field and method tables are prebuilt. Code arrays
+already end with OP_EXIT and exception tables are stored in native order.
+"""
+
+import argparse
+import os
+import struct
+import sys
+
+ARCHIVE_MAGIC = 0x41434A4D
+ARCHIVE_VERSION = 1
+
+CONST_UTF8 = 1
+CONST_INTEGER = 3
+CONST_FLOAT = 4
+CONST_LONG = 5
+CONST_DOUBLE = 6
+CONST_CLASS = 7
+CONST_STRING = 8
+CONST_FIELD = 9
+CONST_METHOD = 10
+CONST_INTERFACE_METHOD = 11
+CONST_NAME_AND_TYPE = 12
+CONST_METHOD_HANDLE = 15
+CONST_METHOD_TYPE = 16
+CONST_INVOKE_DYNAMIC = 18
+CONST_UNKOWN = 0xFF
+
+METHOD_BRIDGE = 0x0040
+METHOD_NATIVE = 0x0100
+
+OP_EXIT = 0xFF
+
+HEADER_FORMAT = '<IHHIIIII'
+CLASS_FORMAT = '<IHHHHHHHHHHIIIII'
+FIELD_FORMAT = '<HHHH'
+METHOD_FORMAT = '<HHHHHHIII'
+
+
+class Reader:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def read(self, size):
+        if self.pos + size > len(self.data):
+            raise ValueError('unexpected end of class file')
+        value = self.data[self.pos:self.pos + size]
+        self.pos += size
+        return value
+
+    def u1(self):
+        return self.read(1)[0]
+
+    def u2(self):
+        return struct.unpack('>H', self.read(2))[0]
+
+    def u4(self):
+        return struct.unpack('>I', self.read(4))[0]
+
+
+class ClassFile:
+    def __init__(self, data):
+        reader = Reader(data)
+        if reader.u4() != 0xCAFEBABE:
+            raise ValueError('invalid magic')
+        self.minor_version = reader.u2()
+        self.major_version = reader.u2()
+        self.pool = self.read_pool(reader)
+        self.access_flags = reader.u2()
+        self.this_class = reader.u2()
+        self.super_class = reader.u2()
+        self.interfaces = b''.join(struct.pack('<H', reader.u2()) for _ in range(reader.u2()))
+        self.fields = self.read_fields(reader)
+        self.methods = self.read_methods(reader)
+        self.bootstrap_methods = None
+        for _ in range(reader.u2()):
+            name, body = self.read_attribute(reader)
+            if name == b'BootstrapMethods':
+                self.bootstrap_methods = self.parse_bootstrap_methods(body)
+
+    @staticmethod
+    def read_pool(reader):
+        count = reader.u2() - 1
+        pool = []
+        while len(pool) < count:
+            tag = reader.u1()
+            if tag == CONST_UTF8:
+                pool.append((tag, reader.read(reader.u2())))
+            elif tag in (CONST_INTEGER, CONST_FLOAT):
+                pool.append((tag, reader.u4()))
+            elif tag in (CONST_LONG, CONST_DOUBLE):
+                value = struct.unpack('>Q', reader.read(8))[0]
+                pool.append((tag, value & 0xFFFFFFFF))
+                pool.append((CONST_UNKOWN, value >> 32))
+            elif tag in (CONST_FIELD, CONST_METHOD, CONST_INTERFACE_METHOD, CONST_NAME_AND_TYPE, CONST_INVOKE_DYNAMIC):
+                first = reader.u2()
+                second = reader.u2()
+                pool.append((tag | 0x80, first | (second << 16)))
+            elif tag in (CONST_CLASS, CONST_STRING):
+                pool.append((tag | 0x80, reader.u2()))
+            elif tag == CONST_METHOD_TYPE:
+                pool.append((tag, reader.u2()))
+            elif tag == CONST_METHOD_HANDLE:
+                kind = reader.u1()
+                pool.append((tag | 0x80, kind | (reader.u2() << 16)))
+            else:
+                raise ValueError('unknown pool tag %d' % tag)
+        return pool
+
+    def utf8(self, index):
+        tag, value = self.pool[index - 1]
+        if tag != CONST_UTF8:
+            raise ValueError('pool entry %d is not utf8' % index)
+        return value
+
+    def read_attribute(self, reader):
+        name = self.utf8(reader.u2())
+        return name, reader.read(reader.u4())
+
+    def read_fields(self, reader):
+        fields = []
+        for _ in range(reader.u2()):
+            access_flags = reader.u2()
+            name_index = reader.u2()
+            descriptor_index = reader.u2()
+            has_constant_value = False
+            for _ in range(reader.u2()):
+                name, _ = self.read_attribute(reader)
+                has_constant_value |= (name == b'ConstantValue')
+            # the VM does not load fields initialized from ConstantValue
+            if not has_constant_value:
+                fields.append((access_flags, name_index, descriptor_index))
+        return fields
+
+    def read_methods(self, reader):
+        methods = []
+        for _ in range(reader.u2()):
+            access_flags = reader.u2()
+            name_index = reader.u2()
+            descriptor_index = reader.u2()
+            code = None
+            for _ in range(reader.u2()):
+                name, body = self.read_attribute(reader)
+                if name == b'Code':
+                    code = self.parse_code(body)
+            if access_flags & METHOD_BRIDGE:
+                continue
+            methods.append((access_flags, name_index, descriptor_index, code))
+        return methods
+
+    @staticmethod
+    def parse_code(body):
+        reader = Reader(body)
+        max_stack = reader.u2()
+        max_locals = reader.u2()
+        code = reader.read(reader.u4())
+        exception_table = [struct.unpack('>HHHH', reader.read(8)) for _ in range(reader.u2())]
+        return max_stack, max_locals, code, exception_table
+
+    @staticmethod
+    def parse_bootstrap_methods(body):
+        reader = Reader(body)
+        methods = []
+        for _ in range(reader.u2()):
+            method_ref = reader.u2()
+            count = reader.u2()
+            arguments = b''.join(struct.pack('<H', reader.u2()) for _ in range(count))
+            methods.append((method_ref, count, arguments))
+        return methods
+
+    @property
+    def name(self):
+        tag, value = self.pool[self.this_class - 1]
+        return self.utf8(value)
+
+
+def calc_hash(text):
+    value = 0x811C9DC5
+    for byte in text:
+        value ^= byte
+        value = (value * 0x01000193) & 0xFFFFFFFF
+    return value
+
+
+class Builder:
+    def __init__(self):
+        self.data = bytearray()
+
+    def align(self, alignment):
+        while len(self.data) % alignment:
+            self.data.append(0)
+
+    def append(self, data, alignment=1):
+        self.align(alignment)
+        offset = len(self.data)
+        self.data += data
+        return offset
+
+    def patch(self, offset, data):
+        self.data[offset:offset + len(data)] = data
+
+
+def build_archive(classes):
+    builder = Builder()
+    header_size = struct.calcsize(HEADER_FORMAT)
+    builder.append(bytes(header_size))
+
+    bucket_count = 2
+    while bucket_count < len(classes) * 2:
+        bucket_count *= 2
+    buckets_offset = builder.append(bytes(bucket_count * 4), 4)
+
+    utf8_offset = len(builder.data)
+    utf8_table = {}
+    for class_file in classes:
+        for tag, value in class_file.pool:
+            if tag == CONST_UTF8 and value not in utf8_table:
+                crc = sum(value) & 0xFFFF
+                utf8_table[value] = builder.append(struct.pack('<HH', len(value), crc) + value + b'\0', 4)
+    builder.align(4)
+    utf8_size = len(builder.data) - utf8_offset
+
+    buckets = [0] * bucket_count
+    for class_file in classes:
+        pool = bytearray()
+        for tag, value in class_file.pool:
+            if tag == CONST_UTF8:
+                value = utf8_table[value]
+            pool += struct.pack('<BxxxI', tag, value)
+        pool_offset = builder.append(pool, 4)
+        interfaces_offset = builder.append(class_file.interfaces, 2) if class_file.interfaces else 0
+
+        fields = b''.join(struct.pack(FIELD_FORMAT, flags, name, descriptor, 0) for flags, name, descriptor in class_file.fields)
+        fields_offset = builder.append(fields, 4) if fields else 0
+
+        method_records = []
+        for flags, name, descriptor, code in class_file.methods:
+            if code is None or (flags & METHOD_NATIVE):
+                method_records.append(struct.pack(METHOD_FORMAT, flags, name, descriptor, 0, 0, 0, 0, 0, 0))
+                continue
+            max_stack, max_locals, code_bytes, exception_table = code
+            code_offset = builder.append(code_bytes + bytes([OP_EXIT]), 4)
+            exception_offset = 0
+            if exception_table:
+                exception_offset = builder.append(b''.join(struct.pack('<HHHH', *entry) for entry in exception_table), 4)
+            method_records.append(struct.pack(
+                METHOD_FORMAT, flags, name, descriptor, max_stack, max_locals, len(exception_table),
+                len(code_bytes), code_offset, exception_offset
+            ))
+        methods_offset = builder.append(b''.join(method_records), 4) if method_records else 0
+
+        bootstrap_offset = 0
+        if class_file.bootstrap_methods is not None:
+            bootstrap = struct.pack('<H', len(class_file.bootstrap_methods))
+            for method_ref, count, arguments in class_file.bootstrap_methods:
+                bootstrap += struct.pack('<HH', method_ref, count) + arguments
+            bootstrap_offset = builder.append(bootstrap, 4)
+
+        record = struct.pack(
+            CLASS_FORMAT, utf8_table[class_file.name], class_file.minor_version, class_file.major_version,
+            class_file.access_flags, class_file.this_class, class_file.super_class, len(class_file.pool),
+            len(class_file.interfaces) // 2, len(class_file.fields), len(class_file.methods), 0,
+            pool_offset, interfaces_offset, fields_offset, methods_offset, bootstrap_offset
+        )
+        record_offset = builder.append(record, 4)
+
+        index = calc_hash(class_file.name) & (bucket_count - 1)
+        while buckets[index]:
+            index = (index + 1) & (bucket_count - 1)
+        buckets[index] = record_offset
+
+    builder.patch(buckets_offset, struct.pack('<%dI' % bucket_count, *buckets))
+    builder.patch(0, struct.pack(
+        HEADER_FORMAT, ARCHIVE_MAGIC, ARCHIVE_VERSION, 0, len(classes),
+        bucket_count, buckets_offset, utf8_offset, utf8_size
+    ))
+    return bytes(builder.data)
+
+
+def collect_class_files(paths):
+    for path in paths:
+        if os.path.isdir(path):
+            for root, _, files in os.walk(path):
+                for name in sorted(files):
+                    if name.endswith('.class'):
+                        yield os.path.join(root, name)
+        else:
+            yield path
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Build a pre-parsed MJVM class archive.')
+    parser.add_argument('-o', '--output', required=True, help='archive file to write')
+    parser.add_argument('inputs', nargs='+', help='class files or directories containing class files')
+    args = parser.parse_args()
+
+    classes = {}
+    for path in collect_class_files(args.inputs):
+        with open(path, 'rb') as file:
+            class_file = ClassFile(file.read())
+        if class_file.name in classes:
+            print('warning: duplicate class %s in %s is ignored' % (class_file.name.decode(), path), file=sys.stderr)
+            continue
+        classes[class_file.name] = class_file
+
+    with open(args.output, 'wb') as file:
+        file.write(build_archive(list(classes.values())))
+    print('%d classes written to %s' % (len(classes), args.output))
+
+
+if __name__ == '__main__':
+    main()
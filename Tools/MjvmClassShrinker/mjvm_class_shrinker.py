@@ -0,0 +1,500 @@
+#!/usr/bin/env python3
+"""
+Strip the classes, methods and fields an MJVM application can not reach.
+
+Usage:
+    mjvm_class_shrinker.py -m app/Main -o out <class files or directories>...
+
+The inputs are the compiled application classes and the compiled MSDK classes
+(MSDK/Src/java). Starting from main() of the main class, the code of every
+reachable method is walked for invokes, field references and class references.
+A virtual or interface call keeps the methods with the same name and descriptor
+in every reachable class, and a reachable class keeps its <clinit>, its super
+class and its interfaces. The reduced class files are written to the output
+directory, the unreachable classes are not written at all.
+
+The constant pools are kept as they are so that the code does not need to be
+rewritten. Attributes the VM does not read (line numbers, local variables,
+stack maps, signatures, annotations...) are dropped unless --keep-attributes
+is given.
+
+The classes used by the VM itself are kept whole. Classes, methods or fields
+only used through reflection must be kept with -k:
+
+    -k app/Plugin           keep the whole class
+    -k 'app/plugins/*'      keep every class whose name starts with app/plugins/
+    -k app/Plugin.start     keep the members named start
+"""
+
+import argparse
+import os
+import struct
+import sys
+
+CONST_UTF8 = 1
+CONST_INTEGER = 3
+CONST_FLOAT = 4
+CONST_LONG = 5
+CONST_DOUBLE = 6
+CONST_CLASS = 7
+CONST_STRING = 8
+CONST_FIELD = 9
+CONST_METHOD = 10
+CONST_INTERFACE_METHOD = 11
+CONST_NAME_AND_TYPE = 12
+CONST_METHOD_HANDLE = 15
+CONST_METHOD_TYPE = 16
+CONST_INVOKE_DYNAMIC = 18
+
+REF_INVOKE_VIRTUAL = 5
+REF_INVOKE_INTERFACE = 9
+
+METHOD_NATIVE = 0x0100
+
+# the attributes read by MjvmClassLoader, the other ones are skipped when a class is loaded
+VM_ATTRIBUTES = (b'Code', b'ConstantValue', b'BootstrapMethods')
+
+# classes the VM creates or accesses by name (see MJVM/VM/Src/mjvm_const_name.cpp)
+VM_CLASSES = (
+    'java/lang/Object', 'java/lang/Class', 'java/lang/String', 'java/lang/Math', 'java/lang/Float',
+    'java/lang/Double', 'java/lang/System', 'java/lang/Character', 'java/lang/Throwable',
+    'java/io/PrintStream', 'jdk/internal/misc/Unsafe', 'java/util/concurrent/atomic/AtomicInteger',
+    'java/util/concurrent/atomic/AtomicLong', 'java/util/concurrent/atomic/AtomicReference',
+    'java/util/concurrent/ForkJoinPool', 'java/lang/NullPointerException', 'java/lang/NoClassDefFoundError',
+    'java/lang/ArrayStoreException', 'java/lang/ArithmeticException', 'java/lang/ClassNotFoundException',
+    'java/lang/CloneNotSupportedException', 'java/lang/NegativeArraySizeException',
+    'java/lang/UnsupportedOperationException', 'java/lang/ArrayIndexOutOfBoundsException',
+)
+
+# methods the VM calls on objects it did not create itself (tasks and threads)
+VM_VIRTUAL_METHODS = (
+    ('run', '()V'),
+)
+
+# operand sizes of the fixed size opcodes which have operands
+OPERAND_SIZES = {
+    0x10: 1, 0x11: 2, 0x12: 1, 0x13: 2, 0x14: 2, 0x84: 2, 0xA9: 1, 0xB9: 4, 0xBA: 4,
+    0xBC: 1, 0xC5: 3, 0xC8: 4, 0xC9: 4,
+}
+OPERAND_SIZES.update((opcode, 1) for opcode in range(0x15, 0x1A))
+OPERAND_SIZES.update((opcode, 1) for opcode in range(0x36, 0x3B))
+OPERAND_SIZES.update((opcode, 2) for opcode in range(0x99, 0xA9))
+OPERAND_SIZES.update((opcode, 2) for opcode in range(0xB2, 0xB9))
+OPERAND_SIZES.update((opcode, 2) for opcode in (0xBB, 0xBD, 0xC0, 0xC1, 0xC6, 0xC7))
+
+OP_LDC = 0x12
+OP_LDC_W = 0x13
+OP_LDC2_W = 0x14
+OP_TABLESWITCH = 0xAA
+OP_LOOKUPSWITCH = 0xAB
+OP_WIDE = 0xC4
+OP_IINC = 0x84
+OP_INVOKEDYNAMIC = 0xBA
+POOL_OPCODES = (0xB2, 0xB3, 0xB4, 0xB5, 0xB6, 0xB7, 0xB8, 0xB9, 0xBB, 0xBD, 0xC0, 0xC1, 0xC5)
+VIRTUAL_OPCODES = (0xB6, 0xB9)
+
+
+class Reader:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def read(self, size):
+        if self.pos + size > len(self.data):
+            raise ValueError('unexpected end of class file')
+        value = self.data[self.pos:self.pos + size]
+        self.pos += size
+        return value
+
+    def u1(self):
+        return self.read(1)[0]
+
+    def u2(self):
+        return struct.unpack('>H', self.read(2))[0]
+
+    def u4(self):
+        return struct.unpack('>I', self.read(4))[0]
+
+
+class Member:
+    def __init__(self, class_file, reader):
+        self.access_flags = reader.u2()
+        self.name = class_file.utf8(reader.u2()).decode()
+        self.descriptor = class_file.utf8(reader.u2()).decode()
+        self.header = reader.data[reader.pos - 6:reader.pos]
+        self.attributes = [class_file.read_attribute(reader) for _ in range(reader.u2())]
+        self.code = None
+        for name, body in self.attributes:
+            if name == b'Code':
+                self.code = body
+        self.is_kept = False
+
+
+class ClassFile:
+    def __init__(self, data):
+        reader = Reader(data)
+        if reader.u4() != 0xCAFEBABE:
+            raise ValueError('invalid magic')
+        reader.read(4)
+        self.pool = self.read_pool(reader)
+        self.head = data[:reader.pos]
+        self.access_flags = reader.u2()
+        self.this_class = reader.u2()
+        self.super_class = reader.u2()
+        self.interfaces = [reader.u2() for _ in range(reader.u2())]
+        self.class_info = data[reader.pos - 8 - len(self.interfaces) * 2:reader.pos]
+        self.fields = [Member(self, reader) for _ in range(reader.u2())]
+        self.methods = [Member(self, reader) for _ in range(reader.u2())]
+        self.attributes = [self.read_attribute(reader) for _ in range(reader.u2())]
+        self.bootstrap_methods = []
+        for name, body in self.attributes:
+            if name == b'BootstrapMethods':
+                self.bootstrap_methods = self.parse_bootstrap_methods(body)
+        self.name = self.class_name(self.this_class)
+        self.super_name = self.class_name(self.super_class) if self.super_class else None
+        self.interface_names = [self.class_name(index) for index in self.interfaces]
+        self.is_reached = False
+        self.is_kept = False
+
+    @staticmethod
+    def read_pool(reader):
+        count = reader.u2() - 1
+        pool = []
+        while len(pool) < count:
+            tag = reader.u1()
+            if tag == CONST_UTF8:
+                pool.append((tag, reader.read(reader.u2())))
+            elif tag in (CONST_INTEGER, CONST_FLOAT):
+                pool.append((tag, reader.u4()))
+            elif tag in (CONST_LONG, CONST_DOUBLE):
+                pool.append((tag, reader.read(8)))
+                pool.append((None, None))
+            elif tag in (CONST_FIELD, CONST_METHOD, CONST_INTERFACE_METHOD, CONST_NAME_AND_TYPE, CONST_INVOKE_DYNAMIC):
+                pool.append((tag, (reader.u2(), reader.u2())))
+            elif tag in (CONST_CLASS, CONST_STRING, CONST_METHOD_TYPE):
+                pool.append((tag, reader.u2()))
+            elif tag == CONST_METHOD_HANDLE:
+                pool.append((tag, (reader.u1(), reader.u2())))
+            else:
+                raise ValueError('unknown pool tag %d' % tag)
+        return pool
+
+    @staticmethod
+    def parse_bootstrap_methods(body):
+        reader = Reader(body)
+        methods = []
+        for _ in range(reader.u2()):
+            method_ref = reader.u2()
+            methods.append((method_ref, [reader.u2() for _ in range(reader.u2())]))
+        return methods
+
+    def utf8(self, index):
+        tag, value = self.pool[index - 1]
+        if tag != CONST_UTF8:
+            raise ValueError('pool entry %d is not utf8' % index)
+        return value
+
+    def read_attribute(self, reader):
+        name = self.utf8(reader.u2())
+        return name, reader.read(reader.u4())
+
+    def class_name(self, index):
+        return self.utf8(self.pool[index - 1][1]).decode()
+
+    def name_and_type(self, index):
+        name_index, descriptor_index = self.pool[index - 1][1]
+        return self.utf8(name_index).decode(), self.utf8(descriptor_index).decode()
+
+    def member_ref(self, index):
+        class_index, name_and_type_index = self.pool[index - 1][1]
+        return (self.class_name(class_index),) + self.name_and_type(name_and_type_index)
+
+    def write(self, keep_attributes):
+        def attributes(items):
+            if not keep_attributes:
+                items = [(name, body) for name, body in items if name in VM_ATTRIBUTES]
+            data = struct.pack('>H', len(items))
+            for name, body in items:
+                if name == b'Code' and not keep_attributes:
+                    body = strip_code_attributes(body)
+                data += struct.pack('>HI', self.pool_index(name), len(body)) + body
+            return data
+
+        def members(items):
+            items = [member for member in items if member.is_kept]
+            return struct.pack('>H', len(items)) + b''.join(member.header + attributes(member.attributes) for member in items)
+
+        return self.head + self.class_info + members(self.fields) + members(self.methods) + attributes(self.attributes)
+
+    def pool_index(self, text):
+        for index, (tag, value) in enumerate(self.pool):
+            if tag == CONST_UTF8 and value == text:
+                return index + 1
+        raise ValueError('%s is not in the const pool' % text.decode())
+
+
+def strip_code_attributes(body):
+    reader = Reader(body)
+    reader.read(4)
+    reader.read(reader.u4())
+    reader.read(reader.u2() * 8)
+    return body[:reader.pos] + b'\0\0'
+
+
+def element_class(name):
+    """returns the class an array type needs, None for an array of primitives"""
+    name = name.lstrip('[')
+    if name.startswith('L') and name.endswith(';'):
+        return name[1:-1]
+    if len(name) == 1:
+        return None
+    return name
+
+
+class Shrinker:
+    def __init__(self, classes, keep_patterns):
+        self.classes = classes
+        self.keep_patterns = keep_patterns
+        self.virtual_methods = set(VM_VIRTUAL_METHODS)
+        self.pending = []
+        self.missing = set()
+
+    def is_kept(self, class_name, member_name=None):
+        for pattern in self.keep_patterns:
+            class_pattern, _, member_pattern = pattern.partition('.')
+            if class_pattern.endswith('*'):
+                is_class = class_name.startswith(class_pattern[:-1])
+            else:
+                is_class = (class_name == class_pattern)
+            if is_class and (not member_pattern or member_pattern == member_name):
+                return True
+        return False
+
+    def reach_class(self, name):
+        name = element_class(name)
+        if name is None:
+            return None
+        class_file = self.classes.get(name)
+        if class_file is None:
+            self.missing.add(name)
+            return None
+        if class_file.is_reached:
+            return class_file
+        class_file.is_reached = True
+        class_file.is_kept = (name in VM_CLASSES) or self.is_kept(name)
+        for member in class_file.fields:
+            if class_file.is_kept or self.is_kept(name, member.name):
+                member.is_kept = True
+        for method in class_file.methods:
+            if (class_file.is_kept or self.is_kept(name, method.name) or method.name == '<clinit>'
+                    or (method.name, method.descriptor) in self.virtual_methods):
+                self.reach_method(class_file, method)
+        if class_file.super_name:
+            self.reach_class(class_file.super_name)
+        for interface in class_file.interface_names:
+            self.reach_class(interface)
+        return class_file
+
+    def reach_method(self, class_file, method):
+        if not method.is_kept:
+            method.is_kept = True
+            self.pending.append((class_file, method))
+
+    def find_member(self, class_name, name, descriptor, is_field):
+        """returns the class which declares the member, looking at the super classes then the interfaces"""
+        class_file = self.reach_class(class_name)
+        if class_file is None:
+            return None, None
+        for member in (class_file.fields if is_field else class_file.methods):
+            if member.name == name and (is_field or member.descriptor == descriptor):
+                return class_file, member
+        for super_name in ([class_file.super_name] if class_file.super_name else []) + class_file.interface_names:
+            found = self.find_member(super_name, name, descriptor, is_field)
+            if found[1] is not None:
+                return found
+        return None, None
+
+    def reach_field(self, class_name, name, descriptor):
+        _, field = self.find_member(class_name, name, descriptor, True)
+        if field is not None:
+            field.is_kept = True
+
+    def reach_invoke(self, class_name, name, descriptor, is_virtual):
+        class_file, method = self.find_member(class_name, name, descriptor, False)
+        if method is not None:
+            self.reach_method(class_file, method)
+        if is_virtual:
+            self.reach_virtual(name, descriptor)
+
+    def reach_virtual(self, name, descriptor):
+        if (name, descriptor) in self.virtual_methods:
+            return
+        self.virtual_methods.add((name, descriptor))
+        for class_file in self.classes.values():
+            if class_file.is_reached:
+                for method in class_file.methods:
+                    if method.name == name and method.descriptor == descriptor:
+                        self.reach_method(class_file, method)
+
+    def reach_method_handle(self, class_file, index):
+        kind, ref_index = class_file.pool[index - 1][1]
+        tag = class_file.pool[ref_index - 1][0]
+        if tag == CONST_FIELD:
+            self.reach_field(*class_file.member_ref(ref_index))
+        else:
+            is_virtual = kind in (REF_INVOKE_VIRTUAL, REF_INVOKE_INTERFACE)
+            self.reach_invoke(*class_file.member_ref(ref_index), is_virtual=is_virtual)
+
+    def reach_constant(self, class_file, index):
+        tag, value = class_file.pool[index - 1]
+        if tag == CONST_CLASS:
+            self.reach_class(class_file.class_name(index))
+        elif tag == CONST_FIELD:
+            self.reach_field(*class_file.member_ref(index))
+        elif tag in (CONST_METHOD, CONST_INTERFACE_METHOD):
+            self.reach_invoke(*class_file.member_ref(index), is_virtual=False)
+        elif tag == CONST_METHOD_HANDLE:
+            self.reach_method_handle(class_file, index)
+
+    def reach_invoke_dynamic(self, class_file, index):
+        bootstrap_index, name_and_type_index = class_file.pool[index - 1][1]
+        method_ref, arguments = class_file.bootstrap_methods[bootstrap_index]
+        self.reach_method_handle(class_file, method_ref)
+        for argument in arguments:
+            tag, value = class_file.pool[argument - 1]
+            if tag == CONST_METHOD_HANDLE:
+                self.reach_method_handle(class_file, argument)
+            elif tag == CONST_METHOD_TYPE:
+                # a lambda implements the interface method with this erased descriptor
+                name = class_file.name_and_type(name_and_type_index)[0]
+                self.reach_virtual(name, class_file.utf8(value).decode())
+            elif tag == CONST_CLASS:
+                self.reach_class(class_file.class_name(argument))
+
+    def walk_code(self, class_file, method):
+        for exception_class in self.exception_classes(class_file, method.code):
+            self.reach_class(exception_class)
+        reader = Reader(method.code)
+        reader.read(4)
+        code = reader.read(reader.u4())
+        pc = 0
+        while pc < len(code):
+            opcode = code[pc]
+            if opcode == OP_TABLESWITCH:
+                pos = (pc + 4) & ~3
+                low, high = struct.unpack('>ii', code[pos + 4:pos + 12])
+                pc = pos + 12 + (high - low + 1) * 4
+                continue
+            if opcode == OP_LOOKUPSWITCH:
+                pos = (pc + 4) & ~3
+                count = struct.unpack('>i', code[pos + 4:pos + 8])[0]
+                pc = pos + 8 + count * 8
+                continue
+            if opcode == OP_WIDE:
+                pc += 6 if code[pc + 1] == OP_IINC else 4
+                continue
+            if opcode == OP_LDC:
+                self.reach_constant(class_file, code[pc + 1])
+            elif opcode in (OP_LDC_W, OP_LDC2_W) or opcode in POOL_OPCODES:
+                index = struct.unpack('>H', code[pc + 1:pc + 3])[0]
+                if opcode in VIRTUAL_OPCODES:
+                    self.reach_invoke(*class_file.member_ref(index), is_virtual=True)
+                else:
+                    self.reach_constant(class_file, index)
+            elif opcode == OP_INVOKEDYNAMIC:
+                self.reach_invoke_dynamic(class_file, struct.unpack('>H', code[pc + 1:pc + 3])[0])
+            pc += 1 + OPERAND_SIZES.get(opcode, 0)
+
+    @staticmethod
+    def exception_classes(class_file, body):
+        reader = Reader(body)
+        reader.read(4)
+        reader.read(reader.u4())
+        for _ in range(reader.u2()):
+            catch_type = struct.unpack('>HHHH', reader.read(8))[3]
+            if catch_type:
+                yield class_file.class_name(catch_type)
+
+    def run(self, main_class):
+        main = self.reach_class(main_class)
+        if main is None:
+            raise ValueError('main class %s is not found' % main_class)
+        for method in main.methods:
+            if method.name == 'main' and method.descriptor == '([Ljava/lang/String;)V':
+                self.reach_method(main, method)
+        for name in VM_CLASSES:
+            if name in self.classes:
+                self.reach_class(name)
+        for name, class_file in self.classes.items():
+            if self.is_kept(name) or any(self.is_kept(name, member.name) for member in class_file.methods + class_file.fields):
+                self.reach_class(name)
+        while self.pending:
+            class_file, method = self.pending.pop()
+            if method.code is not None and not (method.access_flags & METHOD_NATIVE):
+                self.walk_code(class_file, method)
+
+
+def collect_class_files(paths):
+    for path in paths:
+        if os.path.isdir(path):
+            for root, _, files in os.walk(path):
+                for name in sorted(files):
+                    if name.endswith('.class'):
+                        yield os.path.join(root, name)
+        else:
+            yield path
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Strip the unreachable classes, methods and fields of an MJVM application.')
+    parser.add_argument('-m', '--main', required=True, help='main class, for example app/Main')
+    parser.add_argument('-o', '--output', required=True, help='directory to write the reduced class files to')
+    parser.add_argument('-k', '--keep', action='append', default=[], help='class, class prefix ending with * or class.member to keep')
+    parser.add_argument('--keep-attributes', action='store_true', help='keep the attributes the VM does not read')
+    parser.add_argument('-v', '--verbose', action='store_true', help='list the referenced classes which are not in the inputs')
+    parser.add_argument('inputs', nargs='+', help='class files or directories containing class files')
+    args = parser.parse_args()
+
+    classes = {}
+    input_size = 0
+    for path in collect_class_files(args.inputs):
+        with open(path, 'rb') as file:
+            data = file.read()
+        class_file = ClassFile(data)
+        if class_file.name in classes:
+            print('warning: duplicate class %s in %s is ignored' % (class_file.name, path), file=sys.stderr)
+            continue
+        classes[class_file.name] = class_file
+        input_size += len(data)
+
+    shrinker = Shrinker(classes, args.keep)
+    shrinker.run(args.main.replace('.', '/'))
+
+    output_size = 0
+    reached = [class_file for class_file in classes.values() if class_file.is_reached]
+    for class_file in reached:
+        path = os.path.join(args.output, class_file.name + '.class')
+        os.makedirs(os.path.dirname(path), exist_ok=True)
+        data = class_file.write(args.keep_attributes)
+        with open(path, 'wb') as file:
+            file.write(data)
+        output_size += len(data)
+
+    def count(members):
+        return sum(1 for member in members if member.is_kept), len(members)
+
+    methods = [count(class_file.methods) for class_file in classes.values()]
+    fields = [count(class_file.fields) for class_file in classes.values()]
+    print('classes: %d of %d' % (len(reached), len(classes)))
+    print('methods: %d of %d' % (sum(kept for kept, _ in methods), sum(total for _, total in methods)))
+    print('fields: %d of %d' % (sum(kept for kept, _ in fields), sum(total for _, total in fields)))
+    print('size: %d of %d bytes written to %s' % (output_size, input_size, args.output))
+    if shrinker.missing:
+        print('warning: %d referenced classes are not in the inputs' % len(shrinker.missing), file=sys.stderr)
+        if args.verbose:
+            for name in sorted(shrinker.missing):
+                print('    ' + name, file=sys.stderr)
+
+
+if __name__ == '__main__':
+    main()